@@ -155,11 +155,13 @@ def run_wasm_reduce_tests():
         print('..', os.path.basename(t))
         # convert to wasm
         support.run_command(shared.WASM_AS + [t, '-o', 'a.wasm', '-all'])
-        support.run_command(shared.WASM_REDUCE + ['a.wasm', '--command=%s b.wasm --fuzz-exec -all ' % shared.WASM_OPT[0], '-t', 'b.wasm', '-w', 'c.wasm', '--timeout=4'])
-        expected = t + '.txt'
-        support.run_command(shared.WASM_DIS + ['c.wasm', '-o', 'a.wat'])
-        with open('a.wat') as seen:
-            shared.fail_if_not_identical_to_file(seen.read(), expected)
+        # running several jobs in parallel must find the same result
+        for jobs in ['1', '3']:
+            support.run_command(shared.WASM_REDUCE + ['a.wasm', '--command=%s b.wasm --fuzz-exec -all ' % shared.WASM_OPT[0], '-t', 'b.wasm', '-w', 'c.wasm', '--timeout=4', '-j', jobs])
+            expected = t + '.txt'
+            support.run_command(shared.WASM_DIS + ['c.wasm', '-o', 'a.wat'])
+            with open('a.wat') as seen:
+                shared.fail_if_not_identical_to_file(seen.read(), expected)
 
     # run on a nontrivial fuzz testcase, for general coverage
     # this is very slow in ThreadSanitizer, so avoid it there
@@ -185,8 +187,8 @@ def run_spec_tests():
         if base == 'names.wast' and shared.skip_if_on_windows('spec: ' + base):
             continue
 
-        def run_spec_test(wast):
-            cmd = shared.WASM_SHELL + [wast]
+        def run_spec_test(wast, extra_args=[]):
+            cmd = shared.WASM_SHELL + [wast] + extra_args
             output = support.run_command(cmd, stderr=subprocess.PIPE)
             # filter out binaryen interpreter logging that the spec suite
             # doesn't expect
@@ -221,12 +223,15 @@ def run_spec_tests():
 
         check_expected(actual, expected)
 
+        # running functions as bytecode must give the same results
+        bytecode_actual = run_spec_test(wast, ['--bytecode'])
+        if bytecode_actual != actual:
+            shared.fail(bytecode_actual, actual)
+
         # skip binary checks for tests that reuse previous modules by name, as that's a wast-only feature
         if 'exports.wast' in base:  # FIXME
             continue
 
-        run_spec_test(wast)
-
         # check binary format. here we can verify execution of the final
         # result, no need for an output verification
         # some wast files cannot be split:
@@ -0,0 +1,1081 @@
+
+    var nan = NaN;
+    var infinity = Infinity;
+  
+    function f32Equal(a, b) {
+       var i = new Int32Array(1);
+       var f = new Float32Array(i.buffer);
+       f[0] = a;
+       var ai = f[0];
+       f[0] = b;
+       var bi = f[0];
+
+       return (isNaN(a) && isNaN(b)) || a == b;
+    }
+
+    function f64Equal(a, b) {
+       var i = new Int32Array(2);
+       var f = new Float64Array(i.buffer);
+       f[0] = a;
+       var ai1 = i[0];
+       var ai2 = i[1];
+       f[0] = b;
+       var bi1 = i[0];
+       var bi2 = i[1];
+
+       return (isNaN(a) && isNaN(b)) || (ai1 == bi1 && ai2 == bi2);
+    }
+
+    function i64Equal(actual_lo, actual_hi, expected_lo, expected_hi) {
+       return (actual_lo | 0) == (expected_lo | 0) && (actual_hi | 0) == (expected_hi | 0);
+    }
+  import { setTempRet0 } from 'env';
+
+function asmFunc0(env) {
+ var Math_imul = Math.imul;
+ var Math_fround = Math.fround;
+ var Math_abs = Math.abs;
+ var Math_clz32 = Math.clz32;
+ var Math_min = Math.min;
+ var Math_max = Math.max;
+ var Math_floor = Math.floor;
+ var Math_ceil = Math.ceil;
+ var Math_trunc = Math.trunc;
+ var Math_sqrt = Math.sqrt;
+ var abort = env.abort;
+ var nan = NaN;
+ var infinity = Infinity;
+ var setTempRet0 = env.setTempRet0;
+ var i64toi32_i32$HIGH_BITS = 0;
+ function dummy() {
+  
+ }
+ 
+ function $1() {
+  
+ }
+ 
+ function $2() {
+  
+ }
+ 
+ function $3() {
+  
+ }
+ 
+ function $4() {
+  
+ }
+ 
+ function $5() {
+  var $0 = 0;
+  block : {
+   $0 = 1;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $6() {
+  var i64toi32_i32$0 = 0, $0 = 0, $0$hi = 0;
+  block : {
+   i64toi32_i32$0 = 0;
+   $0 = 2;
+   $0$hi = i64toi32_i32$0;
+   break block;
+  }
+  i64toi32_i32$0 = $0$hi;
+  i64toi32_i32$HIGH_BITS = i64toi32_i32$0;
+  return $0 | 0;
+ }
+ 
+ function $7() {
+  var $0 = Math_fround(0);
+  block : {
+   $0 = Math_fround(3.0);
+   break block;
+  }
+  return Math_fround($0);
+ }
+ 
+ function $8() {
+  var $0 = 0.0;
+  block : {
+   $0 = 4.0;
+   break block;
+  }
+  return +$0;
+ }
+ 
+ function $9() {
+  
+ }
+ 
+ function $10() {
+  block : {
+   dummy();
+   break block;
+  }
+ }
+ 
+ function $11() {
+  block : {
+   dummy();
+   break block;
+  }
+ }
+ 
+ function $12() {
+  var $0 = 0;
+  block : {
+   dummy();
+   $0 = 2;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $13() {
+  var $0 = 0, $1_1 = 0, $3_1 = 0;
+  block : {
+   loop_in : while (1) {
+    $0 = 3;
+    break block;
+   };
+  }
+  return $0 | 0;
+ }
+ 
+ function $14() {
+  var $0 = 0, $1_1 = 0, $3_1 = 0;
+  block : {
+   loop_in : while (1) {
+    dummy();
+    $0 = 4;
+    break block;
+   };
+  }
+  return $0 | 0;
+ }
+ 
+ function $15() {
+  var $0 = 0;
+  block : {
+   loop_in : while (1) {
+    dummy();
+    $0 = 5;
+    break block;
+   };
+  }
+  return $0 | 0;
+ }
+ 
+ function $16() {
+  var $0 = 0;
+  block : {
+   $0 = 9;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $17() {
+  
+ }
+ 
+ function $18() {
+  var $0 = 0;
+  block : {
+   $0 = 8;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $19() {
+  var $0 = 0;
+  block : {
+   $0 = 9;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $20() {
+  
+ }
+ 
+ function $21() {
+  var $0 = 0;
+  block : {
+   $0 = 10;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $22() {
+  var $0 = 0;
+  block : {
+   $0 = 11;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $23() {
+  var i64toi32_i32$0 = 0, $0 = 0, $0$hi = 0;
+  block : {
+   i64toi32_i32$0 = 0;
+   $0 = 7;
+   $0$hi = i64toi32_i32$0;
+   break block;
+  }
+  i64toi32_i32$0 = $0$hi;
+  i64toi32_i32$HIGH_BITS = i64toi32_i32$0;
+  return $0 | 0;
+ }
+ 
+ function $24() {
+  var $0 = 0, $5_1 = 0;
+  if_ : {
+   $0 = 2;
+   break if_;
+  }
+  return $0 | 0;
+ }
+ 
+ function $25($0, $1_1) {
+  $0 = $0 | 0;
+  $1_1 = $1_1 | 0;
+  var $3_1 = 0, $7_1 = 0;
+  block : {
+   if ($0) {
+    $3_1 = 3;
+    break block;
+   } else {
+    $7_1 = $1_1
+   }
+   $3_1 = $7_1;
+  }
+  return $3_1 | 0;
+ }
+ 
+ function $26($0, $1_1) {
+  $0 = $0 | 0;
+  $1_1 = $1_1 | 0;
+  var $6_1 = 0, $7_1 = 0;
+  block : {
+   if ($0) {
+    $7_1 = $1_1
+   } else {
+    $6_1 = 4;
+    break block;
+   }
+   $6_1 = $7_1;
+  }
+  return $6_1 | 0;
+ }
+ 
+ function $27($0, $1_1) {
+  $0 = $0 | 0;
+  $1_1 = $1_1 | 0;
+  var $2_1 = 0, $3_1 = 0, $4_1 = 0;
+  block : {
+   $2_1 = 5;
+   break block;
+  }
+  return $2_1 | 0;
+ }
+ 
+ function $28($0, $1_1) {
+  $0 = $0 | 0;
+  $1_1 = $1_1 | 0;
+  var $2_1 = 0, $3_1 = 0, $4_1 = 0;
+  block : {
+   $2_1 = $0;
+   $3_1 = 6;
+   break block;
+  }
+  return $3_1 | 0;
+ }
+ 
+ function $29() {
+  var $0 = 0;
+  block : {
+   $0 = 7;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function f($0, $1_1, $2_1) {
+  $0 = $0 | 0;
+  $1_1 = $1_1 | 0;
+  $2_1 = $2_1 | 0;
+  return -1 | 0;
+ }
+ 
+ function $31() {
+  var $0 = 0;
+  block : {
+   $0 = 12;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $32() {
+  var $0 = 0;
+  block : {
+   $0 = 13;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $33() {
+  var $0 = 0;
+  block : {
+   $0 = 14;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $34() {
+  var $0 = 0;
+  block : {
+   $0 = 20;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $35() {
+  var $0 = 0;
+  block : {
+   $0 = 21;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $36() {
+  var $0 = 0;
+  block : {
+   $0 = 22;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $37() {
+  var $0 = 0;
+  block : {
+   $0 = 23;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $38() {
+  var $1_1 = 0;
+  block : {
+   $1_1 = 17;
+   break block;
+  }
+  return $1_1 | 0;
+ }
+ 
+ function $39() {
+  var $1_1 = 0;
+  block : {
+   $1_1 = 1;
+   break block;
+  }
+  return $1_1 | 0;
+ }
+ 
+ function $40() {
+  var $0 = 0;
+  block : {
+   $0 = 1;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $41() {
+  var $0 = Math_fround(0);
+  block : {
+   $0 = Math_fround(1.7000000476837158);
+   break block;
+  }
+  return Math_fround($0);
+ }
+ 
+ function $42() {
+  var i64toi32_i32$0 = 0, $0 = 0, $0$hi = 0;
+  block : {
+   i64toi32_i32$0 = 0;
+   $0 = 30;
+   $0$hi = i64toi32_i32$0;
+   break block;
+  }
+  i64toi32_i32$0 = $0$hi;
+  i64toi32_i32$HIGH_BITS = i64toi32_i32$0;
+  return $0 | 0;
+ }
+ 
+ function $43() {
+  var $0 = 0;
+  block : {
+   $0 = 30;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $44() {
+  var $0 = 0;
+  block : {
+   $0 = 31;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $45() {
+  var $0 = 0;
+  block : {
+   $0 = 32;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $46() {
+  var $0 = 0;
+  block : {
+   $0 = 33;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $47() {
+  var $0 = Math_fround(0);
+  block : {
+   $0 = Math_fround(3.4000000953674316);
+   break block;
+  }
+  return Math_fround($0);
+ }
+ 
+ function $48() {
+  var $0 = 0;
+  block : {
+   $0 = 3;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $49() {
+  var $0 = 0, $0$hi = 0, i64toi32_i32$1 = 0;
+  block : {
+   $0 = 45;
+   $0$hi = 0;
+   break block;
+  }
+  i64toi32_i32$1 = $0$hi;
+  i64toi32_i32$HIGH_BITS = i64toi32_i32$1;
+  return $0 | 0;
+ }
+ 
+ function $50() {
+  var $0 = 0;
+  block : {
+   $0 = 44;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $51() {
+  var $0 = 0;
+  block : {
+   $0 = 43;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $52() {
+  var $0 = 0;
+  block : {
+   $0 = 42;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $53() {
+  var $0 = 0;
+  block : {
+   $0 = 41;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $54() {
+  var $0 = 0;
+  block : {
+   $0 = 40;
+   break block;
+  }
+  return $0 | 0;
+ }
+ 
+ function $55() {
+  var $0 = 0;
+  block : {
+   dummy();
+   $0 = 8;
+   break block;
+  }
+  return 1 + $0 | 0 | 0;
+ }
+ 
+ function $56() {
+  var $0 = 0;
+  block : {
+   block0 : {
+    $0 = 8;
+    break block;
+   }
+  }
+  return 1 + $0 | 0 | 0;
+ }
+ 
+ function $57() {
+  var $0 = 0, $1_1 = 0;
+  block : {
+   $0 = 8;
+   break block;
+  }
+  return 1 + $0 | 0 | 0;
+ }
+ 
+ function $58() {
+  var $0 = 0;
+  block : {
+   $0 = 8;
+   break block;
+  }
+  return 1 + $0 | 0 | 0;
+ }
+ 
+ function $59() {
+  var $0 = 0;
+  block : {
+   $0 = 8;
+   break block;
+  }
+  return 1 + $0 | 0 | 0;
+ }
+ 
+ function $60() {
+  var $0 = 0;
+  block : {
+   $0 = 8;
+   break block;
+  }
+  return 1 + $0 | 0 | 0;
+ }
+ 
+ function legalstub$6() {
+  var i64toi32_i32$0 = 0, i64toi32_i32$4 = 0, i64toi32_i32$1 = 0, i64toi32_i32$3 = 0, $7_1 = 0, $0 = 0, $0$hi = 0, i64toi32_i32$2 = 0;
+  i64toi32_i32$0 = $6() | 0;
+  i64toi32_i32$1 = i64toi32_i32$HIGH_BITS;
+  $0 = i64toi32_i32$0;
+  $0$hi = i64toi32_i32$1;
+  i64toi32_i32$2 = i64toi32_i32$0;
+  i64toi32_i32$0 = 0;
+  i64toi32_i32$3 = 32;
+  i64toi32_i32$4 = i64toi32_i32$3 & 31 | 0;
+  if (32 >>> 0 <= (i64toi32_i32$3 & 63 | 0) >>> 0) {
+   i64toi32_i32$0 = 0;
+   $7_1 = i64toi32_i32$1 >>> i64toi32_i32$4 | 0;
+  } else {
+   i64toi32_i32$0 = i64toi32_i32$1 >>> i64toi32_i32$4 | 0;
+   $7_1 = (((1 << i64toi32_i32$4 | 0) - 1 | 0) & i64toi32_i32$1 | 0) << (32 - i64toi32_i32$4 | 0) | 0 | (i64toi32_i32$2 >>> i64toi32_i32$4 | 0) | 0;
+  }
+  setTempRet0($7_1 | 0);
+  i64toi32_i32$0 = $0$hi;
+  return $0 | 0;
+ }
+ 
+ function legalstub$23() {
+  var i64toi32_i32$0 = 0, i64toi32_i32$4 = 0, i64toi32_i32$1 = 0, i64toi32_i32$3 = 0, $7_1 = 0, $0 = 0, $0$hi = 0, i64toi32_i32$2 = 0;
+  i64toi32_i32$0 = $23() | 0;
+  i64toi32_i32$1 = i64toi32_i32$HIGH_BITS;
+  $0 = i64toi32_i32$0;
+  $0$hi = i64toi32_i32$1;
+  i64toi32_i32$2 = i64toi32_i32$0;
+  i64toi32_i32$0 = 0;
+  i64toi32_i32$3 = 32;
+  i64toi32_i32$4 = i64toi32_i32$3 & 31 | 0;
+  if (32 >>> 0 <= (i64toi32_i32$3 & 63 | 0) >>> 0) {
+   i64toi32_i32$0 = 0;
+   $7_1 = i64toi32_i32$1 >>> i64toi32_i32$4 | 0;
+  } else {
+   i64toi32_i32$0 = i64toi32_i32$1 >>> i64toi32_i32$4 | 0;
+   $7_1 = (((1 << i64toi32_i32$4 | 0) - 1 | 0) & i64toi32_i32$1 | 0) << (32 - i64toi32_i32$4 | 0) | 0 | (i64toi32_i32$2 >>> i64toi32_i32$4 | 0) | 0;
+  }
+  setTempRet0($7_1 | 0);
+  i64toi32_i32$0 = $0$hi;
+  return $0 | 0;
+ }
+ 
+ function legalstub$42() {
+  var i64toi32_i32$0 = 0, i64toi32_i32$4 = 0, i64toi32_i32$1 = 0, i64toi32_i32$3 = 0, $7_1 = 0, $0 = 0, $0$hi = 0, i64toi32_i32$2 = 0;
+  i64toi32_i32$0 = $42() | 0;
+  i64toi32_i32$1 = i64toi32_i32$HIGH_BITS;
+  $0 = i64toi32_i32$0;
+  $0$hi = i64toi32_i32$1;
+  i64toi32_i32$2 = i64toi32_i32$0;
+  i64toi32_i32$0 = 0;
+  i64toi32_i32$3 = 32;
+  i64toi32_i32$4 = i64toi32_i32$3 & 31 | 0;
+  if (32 >>> 0 <= (i64toi32_i32$3 & 63 | 0) >>> 0) {
+   i64toi32_i32$0 = 0;
+   $7_1 = i64toi32_i32$1 >>> i64toi32_i32$4 | 0;
+  } else {
+   i64toi32_i32$0 = i64toi32_i32$1 >>> i64toi32_i32$4 | 0;
+   $7_1 = (((1 << i64toi32_i32$4 | 0) - 1 | 0) & i64toi32_i32$1 | 0) << (32 - i64toi32_i32$4 | 0) | 0 | (i64toi32_i32$2 >>> i64toi32_i32$4 | 0) | 0;
+  }
+  setTempRet0($7_1 | 0);
+  i64toi32_i32$0 = $0$hi;
+  return $0 | 0;
+ }
+ 
+ function legalstub$49() {
+  var i64toi32_i32$0 = 0, i64toi32_i32$4 = 0, i64toi32_i32$1 = 0, i64toi32_i32$3 = 0, $7_1 = 0, $0 = 0, $0$hi = 0, i64toi32_i32$2 = 0;
+  i64toi32_i32$0 = $49() | 0;
+  i64toi32_i32$1 = i64toi32_i32$HIGH_BITS;
+  $0 = i64toi32_i32$0;
+  $0$hi = i64toi32_i32$1;
+  i64toi32_i32$2 = i64toi32_i32$0;
+  i64toi32_i32$0 = 0;
+  i64toi32_i32$3 = 32;
+  i64toi32_i32$4 = i64toi32_i32$3 & 31 | 0;
+  if (32 >>> 0 <= (i64toi32_i32$3 & 63 | 0) >>> 0) {
+   i64toi32_i32$0 = 0;
+   $7_1 = i64toi32_i32$1 >>> i64toi32_i32$4 | 0;
+  } else {
+   i64toi32_i32$0 = i64toi32_i32$1 >>> i64toi32_i32$4 | 0;
+   $7_1 = (((1 << i64toi32_i32$4 | 0) - 1 | 0) & i64toi32_i32$1 | 0) << (32 - i64toi32_i32$4 | 0) | 0 | (i64toi32_i32$2 >>> i64toi32_i32$4 | 0) | 0;
+  }
+  setTempRet0($7_1 | 0);
+  i64toi32_i32$0 = $0$hi;
+  return $0 | 0;
+ }
+ 
+ function __wasm_fetch_high_bits() {
+  return i64toi32_i32$HIGH_BITS | 0;
+ }
+ 
+ return {
+  "type_i32": $1, 
+  "type_i64": $2, 
+  "type_f32": $3, 
+  "type_f64": $4, 
+  "type_i32_value": $5, 
+  "type_i64_value": legalstub$6, 
+  "type_f32_value": $7, 
+  "type_f64_value": $8, 
+  "as_block_first": $9, 
+  "as_block_mid": $10, 
+  "as_block_last": $11, 
+  "as_block_value": $12, 
+  "as_loop_first": $13, 
+  "as_loop_mid": $14, 
+  "as_loop_last": $15, 
+  "as_br_value": $16, 
+  "as_br_if_cond": $17, 
+  "as_br_if_value": $18, 
+  "as_br_if_value_cond": $19, 
+  "as_br_table_index": $20, 
+  "as_br_table_value": $21, 
+  "as_br_table_value_index": $22, 
+  "as_return_value": legalstub$23, 
+  "as_if_cond": $24, 
+  "as_if_then": $25, 
+  "as_if_else": $26, 
+  "as_select_first": $27, 
+  "as_select_second": $28, 
+  "as_select_cond": $29, 
+  "as_call_first": $31, 
+  "as_call_mid": $32, 
+  "as_call_last": $33, 
+  "as_call_indirect_func": $34, 
+  "as_call_indirect_first": $35, 
+  "as_call_indirect_mid": $36, 
+  "as_call_indirect_last": $37, 
+  "as_local_set_value": $38, 
+  "as_local_tee_value": $39, 
+  "as_global_set_value": $40, 
+  "as_load_address": $41, 
+  "as_loadN_address": legalstub$42, 
+  "as_store_address": $43, 
+  "as_store_value": $44, 
+  "as_storeN_address": $45, 
+  "as_storeN_value": $46, 
+  "as_unary_operand": $47, 
+  "as_binary_left": $48, 
+  "as_binary_right": legalstub$49, 
+  "as_test_operand": $50, 
+  "as_compare_left": $51, 
+  "as_compare_right": $52, 
+  "as_convert_operand": $53, 
+  "as_memory_grow_size": $54, 
+  "nested_block_value": $55, 
+  "nested_br_value": $56, 
+  "nested_br_if_value": $57, 
+  "nested_br_if_value_cond": $58, 
+  "nested_br_table_value": $59, 
+  "nested_br_table_value_index": $60, 
+  "__wasm_fetch_high_bits": __wasm_fetch_high_bits
+ };
+}
+
+var retasmFunc0 = asmFunc0(  { abort: function() { throw new Error('abort'); },
+    setTempRet0
+  });
+function check1() {
+ retasmFunc0.type_i32();
+ return 1 | 0;
+}
+
+if (!check1()) throw 'assertion failed: ( assert_return ( invoke type-i32 ) )';
+function check2() {
+ retasmFunc0.type_i64();
+ return 1 | 0;
+}
+
+if (!check2()) throw 'assertion failed: ( assert_return ( invoke type-i64 ) )';
+function check3() {
+ retasmFunc0.type_f32();
+ return 1 | 0;
+}
+
+if (!check3()) throw 'assertion failed: ( assert_return ( invoke type-f32 ) )';
+function check4() {
+ retasmFunc0.type_f64();
+ return 1 | 0;
+}
+
+if (!check4()) throw 'assertion failed: ( assert_return ( invoke type-f64 ) )';
+function check5() {
+ return (retasmFunc0.type_i32_value() | 0 | 0) == (1 | 0) | 0;
+}
+
+if (!check5()) throw 'assertion failed: ( assert_return ( invoke type-i32-value ) ( i32.const 1 ) )';
+function check6() {
+ return i64Equal(retasmFunc0.type_i64_value() | 0 | 0, retasmFunc0.__wasm_fetch_high_bits() | 0 | 0, 2,0) | 0 | 0;
+}
+
+if (!check6()) throw 'assertion failed: ( assert_return ( invoke type-i64-value ) ( i64.const 2 ) )';
+function check7() {
+ return f32Equal(Math.fround(Math.fround(retasmFunc0.type_f32_value())), Math.fround(Math.fround(3.0))) | 0 | 0;
+}
+
+if (!check7()) throw 'assertion failed: ( assert_return ( invoke type-f32-value ) ( f32.const 3 ) )';
+function check8() {
+ return f64Equal(+(+retasmFunc0.type_f64_value()), +(4.0)) | 0 | 0;
+}
+
+if (!check8()) throw 'assertion failed: ( assert_return ( invoke type-f64-value ) ( f64.const 4 ) )';
+function check9() {
+ retasmFunc0.as_block_first();
+ return 1 | 0;
+}
+
+if (!check9()) throw 'assertion failed: ( assert_return ( invoke as-block-first ) )';
+function check10() {
+ retasmFunc0.as_block_mid();
+ return 1 | 0;
+}
+
+if (!check10()) throw 'assertion failed: ( assert_return ( invoke as-block-mid ) )';
+function check11() {
+ retasmFunc0.as_block_last();
+ return 1 | 0;
+}
+
+if (!check11()) throw 'assertion failed: ( assert_return ( invoke as-block-last ) )';
+function check12() {
+ return (retasmFunc0.as_block_value() | 0 | 0) == (2 | 0) | 0;
+}
+
+if (!check12()) throw 'assertion failed: ( assert_return ( invoke as-block-value ) ( i32.const 2 ) )';
+function check13() {
+ return (retasmFunc0.as_loop_first() | 0 | 0) == (3 | 0) | 0;
+}
+
+if (!check13()) throw 'assertion failed: ( assert_return ( invoke as-loop-first ) ( i32.const 3 ) )';
+function check14() {
+ return (retasmFunc0.as_loop_mid() | 0 | 0) == (4 | 0) | 0;
+}
+
+if (!check14()) throw 'assertion failed: ( assert_return ( invoke as-loop-mid ) ( i32.const 4 ) )';
+function check15() {
+ return (retasmFunc0.as_loop_last() | 0 | 0) == (5 | 0) | 0;
+}
+
+if (!check15()) throw 'assertion failed: ( assert_return ( invoke as-loop-last ) ( i32.const 5 ) )';
+function check16() {
+ return (retasmFunc0.as_br_value() | 0 | 0) == (9 | 0) | 0;
+}
+
+if (!check16()) throw 'assertion failed: ( assert_return ( invoke as-br-value ) ( i32.const 9 ) )';
+function check17() {
+ retasmFunc0.as_br_if_cond();
+ return 1 | 0;
+}
+
+if (!check17()) throw 'assertion failed: ( assert_return ( invoke as-br_if-cond ) )';
+function check18() {
+ return (retasmFunc0.as_br_if_value() | 0 | 0) == (8 | 0) | 0;
+}
+
+if (!check18()) throw 'assertion failed: ( assert_return ( invoke as-br_if-value ) ( i32.const 8 ) )';
+function check19() {
+ return (retasmFunc0.as_br_if_value_cond() | 0 | 0) == (9 | 0) | 0;
+}
+
+if (!check19()) throw 'assertion failed: ( assert_return ( invoke as-br_if-value-cond ) ( i32.const 9 ) )';
+function check20() {
+ retasmFunc0.as_br_table_index();
+ return 1 | 0;
+}
+
+if (!check20()) throw 'assertion failed: ( assert_return ( invoke as-br_table-index ) )';
+function check21() {
+ return (retasmFunc0.as_br_table_value() | 0 | 0) == (10 | 0) | 0;
+}
+
+if (!check21()) throw 'assertion failed: ( assert_return ( invoke as-br_table-value ) ( i32.const 10 ) )';
+function check22() {
+ return (retasmFunc0.as_br_table_value_index() | 0 | 0) == (11 | 0) | 0;
+}
+
+if (!check22()) throw 'assertion failed: ( assert_return ( invoke as-br_table-value-index ) ( i32.const 11 ) )';
+function check23() {
+ return i64Equal(retasmFunc0.as_return_value() | 0 | 0, retasmFunc0.__wasm_fetch_high_bits() | 0 | 0, 7,0) | 0 | 0;
+}
+
+if (!check23()) throw 'assertion failed: ( assert_return ( invoke as-return-value ) ( i64.const 7 ) )';
+function check24() {
+ return (retasmFunc0.as_if_cond() | 0 | 0) == (2 | 0) | 0;
+}
+
+if (!check24()) throw 'assertion failed: ( assert_return ( invoke as-if-cond ) ( i32.const 2 ) )';
+function check25() {
+ return (retasmFunc0.as_if_then(1 | 0, 6 | 0) | 0 | 0) == (3 | 0) | 0;
+}
+
+if (!check25()) throw 'assertion failed: ( assert_return ( invoke as-if-then ( i32.const 1 ) ( i32.const 6 ) ) ( i32.const 3 ) )';
+function check26() {
+ return (retasmFunc0.as_if_then(0 | 0, 6 | 0) | 0 | 0) == (6 | 0) | 0;
+}
+
+if (!check26()) throw 'assertion failed: ( assert_return ( invoke as-if-then ( i32.const 0 ) ( i32.const 6 ) ) ( i32.const 6 ) )';
+function check27() {
+ return (retasmFunc0.as_if_else(0 | 0, 6 | 0) | 0 | 0) == (4 | 0) | 0;
+}
+
+if (!check27()) throw 'assertion failed: ( assert_return ( invoke as-if-else ( i32.const 0 ) ( i32.const 6 ) ) ( i32.const 4 ) )';
+function check28() {
+ return (retasmFunc0.as_if_else(1 | 0, 6 | 0) | 0 | 0) == (6 | 0) | 0;
+}
+
+if (!check28()) throw 'assertion failed: ( assert_return ( invoke as-if-else ( i32.const 1 ) ( i32.const 6 ) ) ( i32.const 6 ) )';
+function check29() {
+ return (retasmFunc0.as_select_first(0 | 0, 6 | 0) | 0 | 0) == (5 | 0) | 0;
+}
+
+if (!check29()) throw 'assertion failed: ( assert_return ( invoke as-select-first ( i32.const 0 ) ( i32.const 6 ) ) ( i32.const 5 ) )';
+function check30() {
+ return (retasmFunc0.as_select_first(1 | 0, 6 | 0) | 0 | 0) == (5 | 0) | 0;
+}
+
+if (!check30()) throw 'assertion failed: ( assert_return ( invoke as-select-first ( i32.const 1 ) ( i32.const 6 ) ) ( i32.const 5 ) )';
+function check31() {
+ return (retasmFunc0.as_select_second(0 | 0, 6 | 0) | 0 | 0) == (6 | 0) | 0;
+}
+
+if (!check31()) throw 'assertion failed: ( assert_return ( invoke as-select-second ( i32.const 0 ) ( i32.const 6 ) ) ( i32.const 6 ) )';
+function check32() {
+ return (retasmFunc0.as_select_second(1 | 0, 6 | 0) | 0 | 0) == (6 | 0) | 0;
+}
+
+if (!check32()) throw 'assertion failed: ( assert_return ( invoke as-select-second ( i32.const 1 ) ( i32.const 6 ) ) ( i32.const 6 ) )';
+function check33() {
+ return (retasmFunc0.as_select_cond() | 0 | 0) == (7 | 0) | 0;
+}
+
+if (!check33()) throw 'assertion failed: ( assert_return ( invoke as-select-cond ) ( i32.const 7 ) )';
+function check34() {
+ return (retasmFunc0.as_call_first() | 0 | 0) == (12 | 0) | 0;
+}
+
+if (!check34()) throw 'assertion failed: ( assert_return ( invoke as-call-first ) ( i32.const 12 ) )';
+function check35() {
+ return (retasmFunc0.as_call_mid() | 0 | 0) == (13 | 0) | 0;
+}
+
+if (!check35()) throw 'assertion failed: ( assert_return ( invoke as-call-mid ) ( i32.const 13 ) )';
+function check36() {
+ return (retasmFunc0.as_call_last() | 0 | 0) == (14 | 0) | 0;
+}
+
+if (!check36()) throw 'assertion failed: ( assert_return ( invoke as-call-last ) ( i32.const 14 ) )';
+function check37() {
+ return (retasmFunc0.as_call_indirect_func() | 0 | 0) == (20 | 0) | 0;
+}
+
+if (!check37()) throw 'assertion failed: ( assert_return ( invoke as-call_indirect-func ) ( i32.const 20 ) )';
+function check38() {
+ return (retasmFunc0.as_call_indirect_first() | 0 | 0) == (21 | 0) | 0;
+}
+
+if (!check38()) throw 'assertion failed: ( assert_return ( invoke as-call_indirect-first ) ( i32.const 21 ) )';
+function check39() {
+ return (retasmFunc0.as_call_indirect_mid() | 0 | 0) == (22 | 0) | 0;
+}
+
+if (!check39()) throw 'assertion failed: ( assert_return ( invoke as-call_indirect-mid ) ( i32.const 22 ) )';
+function check40() {
+ return (retasmFunc0.as_call_indirect_last() | 0 | 0) == (23 | 0) | 0;
+}
+
+if (!check40()) throw 'assertion failed: ( assert_return ( invoke as-call_indirect-last ) ( i32.const 23 ) )';
+function check41() {
+ return (retasmFunc0.as_local_set_value() | 0 | 0) == (17 | 0) | 0;
+}
+
+if (!check41()) throw 'assertion failed: ( assert_return ( invoke as-local.set-value ) ( i32.const 17 ) )';
+function check42() {
+ return (retasmFunc0.as_local_tee_value() | 0 | 0) == (1 | 0) | 0;
+}
+
+if (!check42()) throw 'assertion failed: ( assert_return ( invoke as-local.tee-value ) ( i32.const 1 ) )';
+function check43() {
+ return (retasmFunc0.as_global_set_value() | 0 | 0) == (1 | 0) | 0;
+}
+
+if (!check43()) throw 'assertion failed: ( assert_return ( invoke as-global.set-value ) ( i32.const 1 ) )';
+function check44() {
+ return f32Equal(Math.fround(Math.fround(retasmFunc0.as_load_address())), Math.fround(Math.fround(1.7000000476837158))) | 0 | 0;
+}
+
+if (!check44()) throw 'assertion failed: ( assert_return ( invoke as-load-address ) ( f32.const 1.7 ) )';
+function check45() {
+ return i64Equal(retasmFunc0.as_loadN_address() | 0 | 0, retasmFunc0.__wasm_fetch_high_bits() | 0 | 0, 30,0) | 0 | 0;
+}
+
+if (!check45()) throw 'assertion failed: ( assert_return ( invoke as-loadN-address ) ( i64.const 30 ) )';
+function check46() {
+ return (retasmFunc0.as_store_address() | 0 | 0) == (30 | 0) | 0;
+}
+
+if (!check46()) throw 'assertion failed: ( assert_return ( invoke as-store-address ) ( i32.const 30 ) )';
+function check47() {
+ return (retasmFunc0.as_store_value() | 0 | 0) == (31 | 0) | 0;
+}
+
+if (!check47()) throw 'assertion failed: ( assert_return ( invoke as-store-value ) ( i32.const 31 ) )';
+function check48() {
+ return (retasmFunc0.as_storeN_address() | 0 | 0) == (32 | 0) | 0;
+}
+
+if (!check48()) throw 'assertion failed: ( assert_return ( invoke as-storeN-address ) ( i32.const 32 ) )';
+function check49() {
+ return (retasmFunc0.as_storeN_value() | 0 | 0) == (33 | 0) | 0;
+}
+
+if (!check49()) throw 'assertion failed: ( assert_return ( invoke as-storeN-value ) ( i32.const 33 ) )';
+function check50() {
+ return f32Equal(Math.fround(Math.fround(retasmFunc0.as_unary_operand())), Math.fround(Math.fround(3.4000000953674316))) | 0 | 0;
+}
+
+if (!check50()) throw 'assertion failed: ( assert_return ( invoke as-unary-operand ) ( f32.const 3.4 ) )';
+function check51() {
+ return (retasmFunc0.as_binary_left() | 0 | 0) == (3 | 0) | 0;
+}
+
+if (!check51()) throw 'assertion failed: ( assert_return ( invoke as-binary-left ) ( i32.const 3 ) )';
+function check52() {
+ return i64Equal(retasmFunc0.as_binary_right() | 0 | 0, retasmFunc0.__wasm_fetch_high_bits() | 0 | 0, 45,0) | 0 | 0;
+}
+
+if (!check52()) throw 'assertion failed: ( assert_return ( invoke as-binary-right ) ( i64.const 45 ) )';
+function check53() {
+ return (retasmFunc0.as_test_operand() | 0 | 0) == (44 | 0) | 0;
+}
+
+if (!check53()) throw 'assertion failed: ( assert_return ( invoke as-test-operand ) ( i32.const 44 ) )';
+function check54() {
+ return (retasmFunc0.as_compare_left() | 0 | 0) == (43 | 0) | 0;
+}
+
+if (!check54()) throw 'assertion failed: ( assert_return ( invoke as-compare-left ) ( i32.const 43 ) )';
+function check55() {
+ return (retasmFunc0.as_compare_right() | 0 | 0) == (42 | 0) | 0;
+}
+
+if (!check55()) throw 'assertion failed: ( assert_return ( invoke as-compare-right ) ( i32.const 42 ) )';
+function check56() {
+ return (retasmFunc0.as_convert_operand() | 0 | 0) == (41 | 0) | 0;
+}
+
+if (!check56()) throw 'assertion failed: ( assert_return ( invoke as-convert-operand ) ( i32.const 41 ) )';
+function check57() {
+ return (retasmFunc0.as_memory_grow_size() | 0 | 0) == (40 | 0) | 0;
+}
+
+if (!check57()) throw 'assertion failed: ( assert_return ( invoke as-memory.grow-size ) ( i32.const 40 ) )';
+function check58() {
+ return (retasmFunc0.nested_block_value() | 0 | 0) == (9 | 0) | 0;
+}
+
+if (!check58()) throw 'assertion failed: ( assert_return ( invoke nested-block-value ) ( i32.const 9 ) )';
+function check59() {
+ return (retasmFunc0.nested_br_value() | 0 | 0) == (9 | 0) | 0;
+}
+
+if (!check59()) throw 'assertion failed: ( assert_return ( invoke nested-br-value ) ( i32.const 9 ) )';
+function check60() {
+ return (retasmFunc0.nested_br_if_value() | 0 | 0) == (9 | 0) | 0;
+}
+
+if (!check60()) throw 'assertion failed: ( assert_return ( invoke nested-br_if-value ) ( i32.const 9 ) )';
+function check61() {
+ return (retasmFunc0.nested_br_if_value_cond() | 0 | 0) == (9 | 0) | 0;
+}
+
+if (!check61()) throw 'assertion failed: ( assert_return ( invoke nested-br_if-value-cond ) ( i32.const 9 ) )';
+function check62() {
+ return (retasmFunc0.nested_br_table_value() | 0 | 0) == (9 | 0) | 0;
+}
+
+if (!check62()) throw 'assertion failed: ( assert_return ( invoke nested-br_table-value ) ( i32.const 9 ) )';
+function check63() {
+ return (retasmFunc0.nested_br_table_value_index() | 0 | 0) == (9 | 0) | 0;
+}
+
+if (!check63()) throw 'assertion failed: ( assert_return ( invoke nested-br_table-value-index ) ( i32.const 9 ) )';
@@ -0,0 +1,117 @@
+(module
+ (type $i32_=>_none (func (param i32)))
+ (memory $0 1)
+ (export "no_dce.i32.load" (func $0))
+ (export "no_dce.i32.load16_s" (func $1))
+ (export "no_dce.i32.load16_u" (func $2))
+ (export "no_dce.i32.load8_s" (func $3))
+ (export "no_dce.i32.load8_u" (func $4))
+ (export "no_dce.i64.load" (func $5))
+ (export "no_dce.i64.load32_s" (func $6))
+ (export "no_dce.i64.load32_u" (func $7))
+ (export "no_dce.i64.load16_s" (func $8))
+ (export "no_dce.i64.load16_u" (func $9))
+ (export "no_dce.i64.load8_s" (func $10))
+ (export "no_dce.i64.load8_u" (func $11))
+ (export "no_dce.f32.load" (func $12))
+ (export "no_dce.f64.load" (func $13))
+ (func $0 (param $i i32)
+  (drop
+   (i32.load
+    (local.get $i)
+   )
+  )
+ )
+ (func $1 (param $i i32)
+  (drop
+   (i32.load16_s
+    (local.get $i)
+   )
+  )
+ )
+ (func $2 (param $i i32)
+  (drop
+   (i32.load16_u
+    (local.get $i)
+   )
+  )
+ )
+ (func $3 (param $i i32)
+  (drop
+   (i32.load8_s
+    (local.get $i)
+   )
+  )
+ )
+ (func $4 (param $i i32)
+  (drop
+   (i32.load8_u
+    (local.get $i)
+   )
+  )
+ )
+ (func $5 (param $i i32)
+  (drop
+   (i64.load
+    (local.get $i)
+   )
+  )
+ )
+ (func $6 (param $i i32)
+  (drop
+   (i64.load32_s
+    (local.get $i)
+   )
+  )
+ )
+ (func $7 (param $i i32)
+  (drop
+   (i64.load32_u
+    (local.get $i)
+   )
+  )
+ )
+ (func $8 (param $i i32)
+  (drop
+   (i64.load16_s
+    (local.get $i)
+   )
+  )
+ )
+ (func $9 (param $i i32)
+  (drop
+   (i64.load16_u
+    (local.get $i)
+   )
+  )
+ )
+ (func $10 (param $i i32)
+  (drop
+   (i64.load8_s
+    (local.get $i)
+   )
+  )
+ )
+ (func $11 (param $i i32)
+  (drop
+   (i64.load8_u
+    (local.get $i)
+   )
+  )
+ )
+ (func $12 (param $i i32)
+  (drop
+   (f32.load
+    (local.get $i)
+   )
+  )
+ )
+ (func $13 (param $i i32)
+  (drop
+   (f64.load
+    (local.get $i)
+   )
+  )
+ )
+)
+
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+
+# Copyright 2026 WebAssembly Community Group participants
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+'''
+Compares the wall time and peak memory of two builds of wasm-opt, for example
+before and after a change to the IR's layout:
+
+  benchmark_opt.py --old old/bin --new _build/bin -i a.wasm -i b.wasm -- -O3
+
+Each build is run on each input the given number of times, alternating between
+the builds, and the median time and the largest max RSS are reported. The
+options after -- are passed to wasm-opt as they are. Unless they contain -o,
+the output is discarded.
+'''
+
+import argparse
+import os
+import statistics
+import subprocess
+import sys
+import time
+
+
+def run(binary, args):
+    start = time.time()
+    proc = subprocess.Popen([binary] + args, stdout=subprocess.DEVNULL)
+    _, status, usage = os.wait4(proc.pid, 0)
+    elapsed = time.time() - start
+    if status != 0:
+        sys.exit('failed (%d): %s' % (status, ' '.join([binary] + args)))
+    # ru_maxrss is in kilobytes on Linux.
+    return elapsed, usage.ru_maxrss
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--old', required=True,
+                        help='The bin directory of the build to compare to')
+    parser.add_argument('--new', required=True,
+                        help='The bin directory of the build to measure')
+    parser.add_argument('--runs', type=int, default=3,
+                        help='How many times to run each build on each input')
+    parser.add_argument('-i', '--input', dest='inputs', action='append',
+                        required=True,
+                        help='An input file for wasm-opt (may be repeated)')
+    parser.add_argument('flags', nargs='*',
+                        help='Options for wasm-opt')
+    options = parser.parse_args()
+
+    flags = options.flags
+    if '-o' not in flags and not any(f.startswith('--output') for f in flags):
+        flags = flags + ['-o', os.devnull]
+    builds = [('old', options.old), ('new', options.new)]
+
+    print('%-30s %12s %12s %12s %12s' % ('input', 'old time', 'new time',
+                                         'old MB', 'new MB'))
+    for infile in options.inputs:
+        times = {name: [] for name, _ in builds}
+        rss = {name: 0 for name, _ in builds}
+        for _ in range(options.runs):
+            for name, bindir in builds:
+                elapsed, maxrss = run(os.path.join(bindir, 'wasm-opt'),
+                                      [infile] + flags)
+                times[name].append(elapsed)
+                rss[name] = max(rss[name], maxrss)
+        print('%-30s %11.2fs %11.2fs %12d %12d' % (
+            os.path.basename(infile),
+            statistics.median(times['old']), statistics.median(times['new']),
+            rss['old'] // 1024, rss['new'] // 1024))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,269 @@
+#!/usr/bin/env python3
+
+# Copyright 2026 WebAssembly Community Group participants
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+'''
+Compares function orders by how soon the code that a run needs is available to
+an engine that compiles the code section while it streams in:
+
+  benchmark_reorder.py --binaryen-bin _build/bin in.wasm -e main -e run
+
+The module is instrumented with wasm-split --instrument --counters and run in
+node, calling the given exports (or all exports if none are given), which gives
+a profile with both first-call timestamps and counters. The module is then
+written in its original order, with --reorder-functions, and with
+--reorder-functions-profile using the timestamps only and the full profile.
+
+The stand-in engine considers a function ready once all of its body has
+arrived. For each order this prints, in bytes of the code section:
+
+  all called ready   when every function that the run called is ready
+  mean first call    the mean, over the functions in the order the run first
+                     called them, of when that call could happen, that is,
+                     when it and all the functions called before it are ready
+  hot 90% span       the size of the range of the code section that holds the
+                     hottest functions that together have 90% of the calls and
+                     loop iterations
+'''
+
+import argparse
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+
+DRIVER = r'''
+import * as fs from 'fs';
+
+const [wasm, profile, ...names] = process.argv.slice(2);
+const module = new WebAssembly.Module(fs.readFileSync(wasm));
+const imports = {};
+for (const { module: mod, name, kind } of WebAssembly.Module.imports(module)) {
+  if (kind != 'function') {
+    throw new Error(`unsupported import ${mod}.${name} of kind ${kind}`);
+  }
+  imports[mod] = imports[mod] || {};
+  imports[mod][name] = () => 0;
+}
+const instance = new WebAssembly.Instance(module, imports);
+const exports = names.length ? names : Object.keys(instance.exports).filter(
+  name => typeof instance.exports[name] == 'function' &&
+          name != '__write_profile');
+// Exports are called without arguments, so some may throw, which still gives
+// a profile of what ran until then.
+let threw = 0;
+for (const name of exports) {
+  try {
+    instance.exports[name]();
+  } catch (e) {
+    threw++;
+  }
+}
+if (threw) {
+  console.log(`${threw} of ${exports.length} exports threw`);
+}
+const size = instance.exports.__write_profile(1024, 2**32 - 1024);
+fs.writeFileSync(profile, Buffer.from(instance.exports.memory.buffer, 1024, size));
+'''
+
+
+def read_leb(data, pos):
+    result = shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        result |= (byte & 0x7f) << shift
+        shift += 7
+        if not byte & 0x80:
+            return result, pos
+
+
+def read_string(data, pos):
+    size, pos = read_leb(data, pos)
+    return data[pos:pos + size].decode('utf-8'), pos + size
+
+
+def read_layout(filename):
+    '''Returns the names of the defined functions and the (start, end) range of
+    each one's body in the code section.'''
+    with open(filename, 'rb') as f:
+        data = f.read()
+    pos = 8
+    num_imports = 0
+    ranges = []
+    names = {}
+    while pos < len(data):
+        section = data[pos]
+        size, pos = read_leb(data, pos + 1)
+        end = pos + size
+        if section == 2:
+            count, p = read_leb(data, pos)
+            for _ in range(count):
+                _, p = read_string(data, p)
+                _, p = read_string(data, p)
+                kind = data[p]
+                if kind != 0:
+                    sys.exit('only function imports are supported')
+                _, p = read_leb(data, p + 1)
+                num_imports += 1
+        elif section == 10:
+            count, p = read_leb(data, pos)
+            for _ in range(count):
+                body_size, p = read_leb(data, p)
+                ranges.append((p - pos, p - pos + body_size))
+                p += body_size
+        elif section == 0:
+            name, p = read_string(data, pos)
+            while name == 'name' and p < end:
+                subsection = data[p]
+                subsection_size, p = read_leb(data, p + 1)
+                if subsection == 1:
+                    count, q = read_leb(data, p)
+                    for _ in range(count):
+                        index, q = read_leb(data, q)
+                        names[index], q = read_string(data, q)
+                p += subsection_size
+        pos = end
+    return [names[num_imports + i] for i in range(len(ranges))], ranges
+
+
+def read_profile(filename, num_funcs):
+    with open(filename, 'rb') as f:
+        data = f.read()
+    timestamps = struct.unpack_from('<%dI' % num_funcs, data, 8)
+    counters = []
+    pos = 8 + 4 * num_funcs
+    if pos < len(data):
+        magic, count = struct.unpack_from('<II', data, pos)
+        counters = struct.unpack_from('<%dI' % count, data, pos + 8)
+    return data[:8 + 4 * num_funcs], timestamps, counters
+
+
+def count_loops(bindir, infile, workdir):
+    '''Returns the number of loops in each defined function, in order, which is
+    how many counters it has after its call counter.'''
+    wat = os.path.join(workdir, 'input.wat')
+    subprocess.check_call([os.path.join(bindir, 'wasm-opt'), infile, '-all',
+                           '-g', '--print', '-o', os.devnull],
+                          stdout=open(wat, 'w'))
+    loops = []
+    with open(wat) as f:
+        for line in f:
+            stripped = line.lstrip()
+            if line.startswith(' (func ') and '(import ' not in line:
+                loops.append(0)
+            elif stripped.startswith('(loop') and loops:
+                loops[-1] += 1
+    return loops
+
+
+def measure(layout, timestamps, heats):
+    names, ranges = layout
+    ready = {name: end for name, (_, end) in zip(names, ranges)}
+    starts = {name: start for name, (start, _) in zip(names, ranges)}
+    called = sorted((t, name) for name, t in timestamps.items() if t)
+    all_ready = max(ready[name] for _, name in called)
+    total = running = 0
+    for _, name in called:
+        running = max(running, ready[name])
+        total += running
+    mean_first_call = total // len(called)
+    span = None
+    if heats:
+        goal = 0.9 * sum(heats.values())
+        hot = []
+        seen = 0
+        for name in sorted(heats, key=lambda name: -heats[name]):
+            if seen >= goal:
+                break
+            hot.append(name)
+            seen += heats[name]
+        span = max(ready[name] for name in hot) - \
+            min(starts[name] for name in hot)
+    return all_ready, mean_first_call, span
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--binaryen-bin', required=True,
+                        help='The bin directory of the build to use')
+    parser.add_argument('--node', default='node', help='The node to run with')
+    parser.add_argument('-e', '--export', dest='exports', action='append',
+                        default=[], help='An export to call (may be repeated)')
+    parser.add_argument('input', help='The module to measure')
+    options = parser.parse_args()
+
+    bindir = options.binaryen_bin
+    with tempfile.TemporaryDirectory() as workdir:
+        def path(name):
+            return os.path.join(workdir, name)
+
+        # The profile is for the input as it is, so reorder that.
+        subprocess.check_call([os.path.join(bindir, 'wasm-split'),
+                               '--instrument', '--counters', options.input,
+                               '-o', path('instrumented.wasm')])
+        with open(path('driver.mjs'), 'w') as f:
+            f.write(DRIVER)
+        subprocess.check_call([options.node, path('driver.mjs'),
+                               path('instrumented.wasm'),
+                               path('counters.prof')] + options.exports)
+
+        orders = [('original order', []),
+                  ('--reorder-functions', ['--reorder-functions']),
+                  ('profile, timestamps',
+                   ['--reorder-functions-profile=' + path('timestamps.prof')]),
+                  ('profile, counters',
+                   ['--reorder-functions-profile=' + path('counters.prof')])]
+        layouts = []
+        for i, (_, args) in enumerate(orders):
+            out = path('%d.wasm' % i)
+            if i == 2:
+                # The same profile, without the counters.
+                with open(path('timestamps.prof'), 'wb') as f:
+                    f.write(timestamp_profile)
+            subprocess.check_call([os.path.join(bindir, 'wasm-opt'),
+                                   options.input, '-all', '-g', '-o', out] +
+                                  args)
+            layouts.append(read_layout(out))
+            if i == 0:
+                names = layouts[0][0]
+                timestamp_profile, timestamps, counters = \
+                    read_profile(path('counters.prof'), len(names))
+                timestamps = dict(zip(names, timestamps))
+                # The heat of a function is its calls plus the iterations of
+                # its loops.
+                heats = {}
+                loops = count_loops(bindir, options.input, workdir)
+                c = 0
+                for name, num_loops in zip(names, loops):
+                    heats[name] = sum(counters[c:c + 1 + num_loops])
+                    c += 1 + num_loops
+
+        code_size = layouts[0][1][-1][1]
+        print('%d functions, %d called, code section %d bytes' % (
+            len(layouts[0][0]), len([t for t in timestamps.values() if t]),
+            code_size))
+        print('%-24s %18s %18s %18s' % ('', 'all called ready',
+                                        'mean first call', 'hot 90% span'))
+        for (name, _), layout in zip(orders, layouts):
+            print('%-24s %18d %18d %18d' % ((name,) +
+                                          measure(layout, timestamps, heats)))
+
+
+if __name__ == '__main__':
+    main()
@@ -115,11 +115,19 @@ Literal fromBinaryenLiteral(BinaryenLiteral x) {
   WASM_UNREACHABLE("invalid type");
 }
 
-// Mutexes (global for now; in theory if multiple modules
-// are used at once this should be optimized to be per-
-// module, but likely it doesn't matter)
+// Mutexes for modifying a module from multiple threads at once. Each module
+// uses one of them, picked by its address, so that threads working on
+// different modules rarely wait for each other.
 
-static std::mutex BinaryenFunctionMutex;
+static const size_t NumModuleMutexes = 64;
+
+static std::mutex ModuleMutexes[NumModuleMutexes];
+
+static std::mutex& getModuleMutex(BinaryenModuleRef module) {
+  // Skip the low bits, which are the same for all modules due to alignment.
+  return ModuleMutexes[(uintptr_t(module) / alignof(Module)) %
+                       NumModuleMutexes];
+}
 
 // Optimization options
 static PassOptions globalPassOptions =
@@ -3418,7 +3426,7 @@ BinaryenFunctionRef BinaryenAddFunction(BinaryenModuleRef module,
   // Lock. This can be called from multiple threads at once, and is a
   // point where they all access and modify the module.
   {
-    std::lock_guard<std::mutex> lock(BinaryenFunctionMutex);
+    std::lock_guard<std::mutex> lock(getModuleMutex(module));
     ((Module*)module)->addFunction(ret);
   }
 
@@ -3896,13 +3904,18 @@ bool BinaryenModuleValidate(BinaryenModuleRef module) {
   return WasmValidator().validate(*(Module*)module);
 }
 
-void BinaryenModuleOptimize(BinaryenModuleRef module) {
+static void optimizeModule(BinaryenModuleRef module,
+                           const PassOptions& options) {
   PassRunner passRunner((Module*)module);
-  passRunner.options = globalPassOptions;
+  passRunner.options = options;
   passRunner.addDefaultOptimizationPasses();
   passRunner.run();
 }
 
+void BinaryenModuleOptimize(BinaryenModuleRef module) {
+  optimizeModule(module, globalPassOptions);
+}
+
 void BinaryenModuleUpdateMaps(BinaryenModuleRef module) {
   ((Module*)module)->updateMaps();
 }
@@ -3997,17 +4010,165 @@ void BinaryenSetAllowInliningFunctionsWithLoops(bool enabled) {
   globalPassOptions.inlining.allowFunctionsWithLoops = enabled;
 }
 
-void BinaryenModuleRunPasses(BinaryenModuleRef module,
-                             const char** passes,
-                             BinaryenIndex numPasses) {
+static void runPassesOnModule(BinaryenModuleRef module,
+                              const char** passes,
+                              BinaryenIndex numPasses,
+                              const PassOptions& options) {
   PassRunner passRunner((Module*)module);
-  passRunner.options = globalPassOptions;
+  passRunner.options = options;
   for (BinaryenIndex i = 0; i < numPasses; i++) {
     passRunner.add(passes[i]);
   }
   passRunner.run();
 }
 
+void BinaryenModuleRunPasses(BinaryenModuleRef module,
+                             const char** passes,
+                             BinaryenIndex numPasses) {
+  runPassesOnModule(module, passes, numPasses, globalPassOptions);
+}
+
+BinaryenPassOptionsRef BinaryenPassOptionsCreate(void) {
+  return new PassOptions(PassOptions::getWithDefaultOptimizationOptions());
+}
+
+void BinaryenPassOptionsDispose(BinaryenPassOptionsRef options) {
+  delete (PassOptions*)options;
+}
+
+int BinaryenPassOptionsGetOptimizeLevel(BinaryenPassOptionsRef options) {
+  return ((PassOptions*)options)->optimizeLevel;
+}
+
+void BinaryenPassOptionsSetOptimizeLevel(BinaryenPassOptionsRef options,
+                                         int level) {
+  ((PassOptions*)options)->optimizeLevel = level;
+}
+
+int BinaryenPassOptionsGetShrinkLevel(BinaryenPassOptionsRef options) {
+  return ((PassOptions*)options)->shrinkLevel;
+}
+
+void BinaryenPassOptionsSetShrinkLevel(BinaryenPassOptionsRef options,
+                                       int level) {
+  ((PassOptions*)options)->shrinkLevel = level;
+}
+
+bool BinaryenPassOptionsGetDebugInfo(BinaryenPassOptionsRef options) {
+  return ((PassOptions*)options)->debugInfo;
+}
+
+void BinaryenPassOptionsSetDebugInfo(BinaryenPassOptionsRef options, bool on) {
+  ((PassOptions*)options)->debugInfo = on != 0;
+}
+
+bool BinaryenPassOptionsGetLowMemoryUnused(BinaryenPassOptionsRef options) {
+  return ((PassOptions*)options)->lowMemoryUnused;
+}
+
+void BinaryenPassOptionsSetLowMemoryUnused(BinaryenPassOptionsRef options,
+                                           bool on) {
+  ((PassOptions*)options)->lowMemoryUnused = on != 0;
+}
+
+bool BinaryenPassOptionsGetZeroFilledMemory(BinaryenPassOptionsRef options) {
+  return ((PassOptions*)options)->zeroFilledMemory;
+}
+
+void BinaryenPassOptionsSetZeroFilledMemory(BinaryenPassOptionsRef options,
+                                            bool on) {
+  ((PassOptions*)options)->zeroFilledMemory = on != 0;
+}
+
+bool BinaryenPassOptionsGetFastMath(BinaryenPassOptionsRef options) {
+  return ((PassOptions*)options)->fastMath;
+}
+
+void BinaryenPassOptionsSetFastMath(BinaryenPassOptionsRef options,
+                                    bool value) {
+  ((PassOptions*)options)->fastMath = value;
+}
+
+const char* BinaryenPassOptionsGetPassArgument(BinaryenPassOptionsRef options,
+                                               const char* key) {
+  assert(key);
+  const auto& args = ((PassOptions*)options)->arguments;
+  auto it = args.find(key);
+  if (it == args.end()) {
+    return nullptr;
+  }
+  // internalize the string so it remains valid while the module is
+  return Name(it->second).c_str();
+}
+
+void BinaryenPassOptionsSetPassArgument(BinaryenPassOptionsRef options,
+                                        const char* key,
+                                        const char* value) {
+  assert(key);
+  auto& args = ((PassOptions*)options)->arguments;
+  if (value) {
+    args[key] = value;
+  } else {
+    args.erase(key);
+  }
+}
+
+void BinaryenPassOptionsClearPassArguments(BinaryenPassOptionsRef options) {
+  ((PassOptions*)options)->arguments.clear();
+}
+
+BinaryenIndex
+BinaryenPassOptionsGetAlwaysInlineMaxSize(BinaryenPassOptionsRef options) {
+  return ((PassOptions*)options)->inlining.alwaysInlineMaxSize;
+}
+
+void BinaryenPassOptionsSetAlwaysInlineMaxSize(BinaryenPassOptionsRef options,
+                                               BinaryenIndex size) {
+  ((PassOptions*)options)->inlining.alwaysInlineMaxSize = size;
+}
+
+BinaryenIndex
+BinaryenPassOptionsGetFlexibleInlineMaxSize(BinaryenPassOptionsRef options) {
+  return ((PassOptions*)options)->inlining.flexibleInlineMaxSize;
+}
+
+void BinaryenPassOptionsSetFlexibleInlineMaxSize(
+  BinaryenPassOptionsRef options, BinaryenIndex size) {
+  ((PassOptions*)options)->inlining.flexibleInlineMaxSize = size;
+}
+
+BinaryenIndex
+BinaryenPassOptionsGetOneCallerInlineMaxSize(BinaryenPassOptionsRef options) {
+  return ((PassOptions*)options)->inlining.oneCallerInlineMaxSize;
+}
+
+void BinaryenPassOptionsSetOneCallerInlineMaxSize(
+  BinaryenPassOptionsRef options, BinaryenIndex size) {
+  ((PassOptions*)options)->inlining.oneCallerInlineMaxSize = size;
+}
+
+bool BinaryenPassOptionsGetAllowInliningFunctionsWithLoops(
+  BinaryenPassOptionsRef options) {
+  return ((PassOptions*)options)->inlining.allowFunctionsWithLoops;
+}
+
+void BinaryenPassOptionsSetAllowInliningFunctionsWithLoops(
+  BinaryenPassOptionsRef options, bool enabled) {
+  ((PassOptions*)options)->inlining.allowFunctionsWithLoops = enabled;
+}
+
+void BinaryenModuleOptimizeWithOptions(BinaryenModuleRef module,
+                                       BinaryenPassOptionsRef options) {
+  optimizeModule(module, *(PassOptions*)options);
+}
+
+void BinaryenModuleRunPassesWithOptions(BinaryenModuleRef module,
+                                        const char** passes,
+                                        BinaryenIndex numPasses,
+                                        BinaryenPassOptionsRef options) {
+  runPassesOnModule(module, passes, numPasses, *(PassOptions*)options);
+}
+
 void BinaryenModuleAutoDrop(BinaryenModuleRef module) {
   auto* wasm = (Module*)module;
   PassRunner runner(wasm, globalPassOptions);
@@ -4111,12 +4272,10 @@ char* BinaryenModuleAllocateAndWriteText(BinaryenModuleRef module) {
 
 BinaryenModuleRef BinaryenModuleRead(char* input, size_t inputSize) {
   auto* wasm = new Module;
-  std::vector<char> buffer(false);
-  buffer.resize(inputSize);
-  std::copy_n(input, inputSize, buffer.begin());
   try {
     // TODO: allow providing features in the C API
-    WasmBinaryBuilder parser(*wasm, FeatureSet::MVP, buffer);
+    WasmBinaryBuilder parser(
+      *wasm, FeatureSet::MVP, std::string_view(input, inputSize));
     parser.read();
   } catch (ParseException& p) {
     p.dump(std::cerr);
@@ -4194,24 +4353,48 @@ void BinaryenFunctionSetBody(BinaryenFunctionRef func,
   assert(body);
   ((Function*)func)->body = (Expression*)body;
 }
-void BinaryenFunctionOptimize(BinaryenFunctionRef func,
-                              BinaryenModuleRef module) {
+static void optimizeFunction(BinaryenFunctionRef func,
+                             BinaryenModuleRef module,
+                             const PassOptions& options) {
   PassRunner passRunner((Module*)module);
-  passRunner.options = globalPassOptions;
+  passRunner.options = options;
   passRunner.addDefaultFunctionOptimizationPasses();
   passRunner.runOnFunction((Function*)func);
 }
-void BinaryenFunctionRunPasses(BinaryenFunctionRef func,
-                               BinaryenModuleRef module,
-                               const char** passes,
-                               BinaryenIndex numPasses) {
+void BinaryenFunctionOptimize(BinaryenFunctionRef func,
+                              BinaryenModuleRef module) {
+  optimizeFunction(func, module, globalPassOptions);
+}
+void BinaryenFunctionOptimizeWithOptions(BinaryenFunctionRef func,
+                                         BinaryenModuleRef module,
+                                         BinaryenPassOptionsRef options) {
+  optimizeFunction(func, module, *(PassOptions*)options);
+}
+static void runPassesOnFunction(BinaryenFunctionRef func,
+                                BinaryenModuleRef module,
+                                const char** passes,
+                                BinaryenIndex numPasses,
+                                const PassOptions& options) {
   PassRunner passRunner((Module*)module);
-  passRunner.options = globalPassOptions;
+  passRunner.options = options;
   for (BinaryenIndex i = 0; i < numPasses; i++) {
     passRunner.add(passes[i]);
   }
   passRunner.runOnFunction((Function*)func);
 }
+void BinaryenFunctionRunPasses(BinaryenFunctionRef func,
+                               BinaryenModuleRef module,
+                               const char** passes,
+                               BinaryenIndex numPasses) {
+  runPassesOnFunction(func, module, passes, numPasses, globalPassOptions);
+}
+void BinaryenFunctionRunPassesWithOptions(BinaryenFunctionRef func,
+                                          BinaryenModuleRef module,
+                                          const char** passes,
+                                          BinaryenIndex numPasses,
+                                          BinaryenPassOptionsRef options) {
+  runPassesOnFunction(func, module, passes, numPasses, *(PassOptions*)options);
+}
 void BinaryenFunctionSetDebugLocation(BinaryenFunctionRef func,
                                       BinaryenExpressionRef expr,
                                       BinaryenIndex fileIndex,
@@ -2435,6 +2435,90 @@ BINARYEN_API void BinaryenModuleRunPasses(BinaryenModuleRef module,
                                           const char** passes,
                                           BinaryenIndex numPasses);
 
+// Pass options
+//
+// The options above apply to all modules, globally, so they cannot differ
+// between modules that are optimized at the same time on different threads.
+// Instead, each such job can create its own pass options, and use them with the
+// *WithOptions variants of the functions that optimize. Jobs on different
+// threads share the thread pool, whose threads take work from all of them.
+
+BINARYEN_REF(PassOptions);
+
+// Creates pass options with the default values, which are the initial values
+// of the global options.
+BINARYEN_API BinaryenPassOptionsRef BinaryenPassOptionsCreate(void);
+
+// Disposes pass options created by BinaryenPassOptionsCreate.
+BINARYEN_API void BinaryenPassOptionsDispose(BinaryenPassOptionsRef options);
+
+// The same as the global getters and setters above, for the given options.
+
+BINARYEN_API int
+BinaryenPassOptionsGetOptimizeLevel(BinaryenPassOptionsRef options);
+BINARYEN_API void
+BinaryenPassOptionsSetOptimizeLevel(BinaryenPassOptionsRef options, int level);
+BINARYEN_API int
+BinaryenPassOptionsGetShrinkLevel(BinaryenPassOptionsRef options);
+BINARYEN_API void
+BinaryenPassOptionsSetShrinkLevel(BinaryenPassOptionsRef options, int level);
+BINARYEN_API bool
+BinaryenPassOptionsGetDebugInfo(BinaryenPassOptionsRef options);
+BINARYEN_API void
+BinaryenPassOptionsSetDebugInfo(BinaryenPassOptionsRef options, bool on);
+BINARYEN_API bool
+BinaryenPassOptionsGetLowMemoryUnused(BinaryenPassOptionsRef options);
+BINARYEN_API void
+BinaryenPassOptionsSetLowMemoryUnused(BinaryenPassOptionsRef options, bool on);
+BINARYEN_API bool
+BinaryenPassOptionsGetZeroFilledMemory(BinaryenPassOptionsRef options);
+BINARYEN_API void
+BinaryenPassOptionsSetZeroFilledMemory(BinaryenPassOptionsRef options, bool on);
+BINARYEN_API bool
+BinaryenPassOptionsGetFastMath(BinaryenPassOptionsRef options);
+BINARYEN_API void
+BinaryenPassOptionsSetFastMath(BinaryenPassOptionsRef options, bool value);
+BINARYEN_API const char*
+BinaryenPassOptionsGetPassArgument(BinaryenPassOptionsRef options,
+                                   const char* name);
+BINARYEN_API void
+BinaryenPassOptionsSetPassArgument(BinaryenPassOptionsRef options,
+                                   const char* name,
+                                   const char* value);
+BINARYEN_API void
+BinaryenPassOptionsClearPassArguments(BinaryenPassOptionsRef options);
+BINARYEN_API BinaryenIndex
+BinaryenPassOptionsGetAlwaysInlineMaxSize(BinaryenPassOptionsRef options);
+BINARYEN_API void
+BinaryenPassOptionsSetAlwaysInlineMaxSize(BinaryenPassOptionsRef options,
+                                          BinaryenIndex size);
+BINARYEN_API BinaryenIndex
+BinaryenPassOptionsGetFlexibleInlineMaxSize(BinaryenPassOptionsRef options);
+BINARYEN_API void
+BinaryenPassOptionsSetFlexibleInlineMaxSize(BinaryenPassOptionsRef options,
+                                            BinaryenIndex size);
+BINARYEN_API BinaryenIndex
+BinaryenPassOptionsGetOneCallerInlineMaxSize(BinaryenPassOptionsRef options);
+BINARYEN_API void
+BinaryenPassOptionsSetOneCallerInlineMaxSize(BinaryenPassOptionsRef options,
+                                             BinaryenIndex size);
+BINARYEN_API bool BinaryenPassOptionsGetAllowInliningFunctionsWithLoops(
+  BinaryenPassOptionsRef options);
+BINARYEN_API void BinaryenPassOptionsSetAllowInliningFunctionsWithLoops(
+  BinaryenPassOptionsRef options, bool enabled);
+
+// Runs the standard optimization passes on the module, using the given options.
+BINARYEN_API void
+BinaryenModuleOptimizeWithOptions(BinaryenModuleRef module,
+                                  BinaryenPassOptionsRef options);
+
+// Runs the specified passes on the module, using the given options.
+BINARYEN_API void
+BinaryenModuleRunPassesWithOptions(BinaryenModuleRef module,
+                                   const char** passes,
+                                   BinaryenIndex numPasses,
+                                   BinaryenPassOptionsRef options);
+
 // Auto-generate drop() operations where needed. This lets you generate code
 // without worrying about where they are needed. (It is more efficient to do it
 // yourself, but simpler to use autodrop).
@@ -2563,6 +2647,21 @@ BINARYEN_API void BinaryenFunctionRunPasses(BinaryenFunctionRef func,
                                             const char** passes,
                                             BinaryenIndex numPasses);
 
+// Runs the standard optimization passes on the function, using the given
+// options.
+BINARYEN_API void
+BinaryenFunctionOptimizeWithOptions(BinaryenFunctionRef func,
+                                    BinaryenModuleRef module,
+                                    BinaryenPassOptionsRef options);
+
+// Runs the specified passes on the function, using the given options.
+BINARYEN_API void
+BinaryenFunctionRunPassesWithOptions(BinaryenFunctionRef func,
+                                     BinaryenModuleRef module,
+                                     const char** passes,
+                                     BinaryenIndex numPasses,
+                                     BinaryenPassOptionsRef options);
+
 // Sets the debug location of the specified `Expression` within the specified
 // `Function`.
 BINARYEN_API void BinaryenFunctionSetDebugLocation(BinaryenFunctionRef func,
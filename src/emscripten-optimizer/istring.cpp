@@ -0,0 +1,126 @@
+/*
+ * Copyright 2022 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "istring.h"
+
+namespace cashew {
+
+namespace {
+
+// The interned strings are spread over shards by hash, and each shard has its
+// own lock, so that threads interning different strings rarely contend. Lookups
+// of strings that are already interned, which is the common case, only take a
+// shared lock.
+
+struct Key {
+  const char* str;
+  size_t len;
+  size_t hash;
+};
+
+struct KeyHash {
+  size_t operator()(const Key& key) const { return key.hash; }
+};
+
+struct KeyEqual {
+  bool operator()(const Key& a, const Key& b) const {
+    return a.len == b.len && memcmp(a.str, b.str, a.len) == 0;
+  }
+};
+
+struct Shard {
+  std::shared_mutex mutex;
+  std::unordered_set<Key, KeyHash, KeyEqual> strings;
+
+  // Copies of strings are bump-allocated in chunks, which are never freed.
+  // Large strings get allocations of their own.
+  static const size_t ChunkSize = 32768;
+  std::vector<std::unique_ptr<char[]>> chunks;
+  std::vector<std::unique_ptr<char[]>> largeStrings;
+  size_t used = ChunkSize;
+
+  const char* copy(const char* s, size_t len) {
+    auto size = len + 1;
+    char* ret;
+    if (size > ChunkSize / 4) {
+      largeStrings.emplace_back(new char[size]);
+      ret = largeStrings.back().get();
+    } else {
+      if (used + size > ChunkSize) {
+        chunks.emplace_back(new char[ChunkSize]);
+        used = 0;
+      }
+      ret = chunks.back().get() + used;
+      used += size;
+    }
+    memcpy(ret, s, len);
+    ret[len] = 0;
+    return ret;
+  }
+};
+
+static const size_t NumShards = 64;
+
+Shard* getShards() {
+  // Interned strings must remain valid until the very end, including in the
+  // destructors of other static objects, so we never free these.
+  static Shard* shards = new Shard[NumShards];
+  return shards;
+}
+
+} // anonymous namespace
+
+void IString::set(const char* s, size_t len, bool reuse) {
+  Key key{s, len, hash(s, len)};
+  auto& shard = getShards()[(key.hash >> 7) % NumShards];
+  {
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto existing = shard.strings.find(key);
+    if (existing != shard.strings.end()) {
+      str = existing->str;
+      return;
+    }
+  }
+  std::unique_lock<std::shared_mutex> lock(shard.mutex);
+  // Another thread may have added it in the meantime.
+  auto existing = shard.strings.find(key);
+  if (existing != shard.strings.end()) {
+    str = existing->str;
+    return;
+  }
+  if (!reuse) {
+    key.str = shard.copy(s, len);
+  }
+  shard.strings.insert(key);
+  str = key.str;
+}
+
+void IString::reserve(size_t num) {
+  auto* shards = getShards();
+  for (size_t i = 0; i < NumShards; i++) {
+    auto& shard = shards[i];
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.strings.reserve(shard.strings.size() + num / NumShards + 1);
+  }
+}
+
+} // namespace cashew
@@ -21,6 +21,7 @@
 #define wasm_istring_h
 
 #include <set>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -38,14 +39,27 @@ namespace cashew {
 struct IString {
   const char* str = nullptr;
 
-  static size_t
-  hash_c(const char* str) { // see http://www.cse.yorku.ca/~oz/hash.html
-    unsigned int hash = 5381;
-    int c;
-    while ((c = *str++)) {
-      hash = ((hash << 5) + hash) ^ c;
+  static size_t hash_c(const char* str) { return hash(str, strlen(str)); }
+
+  // Hashes a string a word at a time.
+  static size_t hash(const char* str, size_t len) {
+    const uint64_t mul = 0x9e3779b97f4a7c15ULL;
+    uint64_t digest = len * mul;
+    uint64_t word;
+    while (len >= sizeof(word)) {
+      memcpy(&word, str, sizeof(word));
+      digest = (digest ^ word) * mul;
+      digest ^= digest >> 29;
+      str += sizeof(word);
+      len -= sizeof(word);
     }
-    return (size_t)hash;
+    if (len) {
+      word = 0;
+      memcpy(&word, str, len);
+      digest = (digest ^ word) * mul;
+      digest ^= digest >> 29;
+    }
+    return size_t(digest);
   }
 
   class CStringHash {
@@ -65,45 +79,20 @@ struct IString {
     assert(s);
     set(s, reuse);
   }
+  // The contents of the view are copied if they are not interned yet. The view
+  // must not contain a null character.
+  explicit IString(std::string_view s) { set(s.data(), s.size(), false); }
 
-  void set(const char* s, bool reuse = true) {
-    typedef std::unordered_set<const char*, CStringHash, CStringEqual>
-      StringSet;
-    // one global store of strings per thread, we must not access this
-    // in parallel
-    thread_local static StringSet strings;
-
-    auto existing = strings.find(s);
-
-    if (existing == strings.end()) {
-      // if the string isn't already known, we must use a single global
-      // storage location, guarded by a mutex, so each string is allocated
-      // exactly once
-      static std::mutex mutex;
-      std::unique_lock<std::mutex> lock(mutex);
-      // a single global set contains the actual strings, so we allocate each
-      // one exactly once.
-      static StringSet globalStrings;
-      auto globalExisting = globalStrings.find(s);
-      if (globalExisting == globalStrings.end()) {
-        if (!reuse) {
-          static std::vector<std::unique_ptr<std::string>> allocated;
-          allocated.emplace_back(wasm::make_unique<std::string>(s));
-          s = allocated.back()->c_str(); // we'll never modify it, so this is ok
-        }
-        // insert into global set
-        globalStrings.insert(s);
-      } else {
-        s = *globalExisting;
-      }
-      // add the string to our thread-local set
-      strings.insert(s);
-    } else {
-      s = *existing;
-    }
+  void set(const char* s, bool reuse = true) { set(s, strlen(s), reuse); }
 
-    str = s;
-  }
+  // Interns the string of the given length. If reuse is true then s must be
+  // null-terminated and remain alive, and is used as the interned string if it
+  // is new; otherwise the string is copied.
+  void set(const char* s, size_t len, bool reuse);
+
+  // Prepare for about this many more strings to be interned, for example when
+  // we are about to read a names section of a known size.
+  static void reserve(size_t num);
 
   void set(const IString& s) { str = s.str; }
 
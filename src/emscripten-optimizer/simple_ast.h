@@ -557,6 +557,11 @@ struct JSPrinter {
 
   Ref ast;
 
+  // If set, this is called with each function definition before printing it.
+  // If it returns text, that is emitted instead. This lets the caller print
+  // functions elsewhere, for example on other threads.
+  std::function<const std::string*(Ref)> getPrintedDefun;
+
   JSPrinter(bool pretty_, bool finalize_, Ref ast_)
     : pretty(pretty_), finalize(finalize_), ast(ast_) {}
 
@@ -871,6 +876,12 @@ struct JSPrinter {
   }
 
   void printDefun(Ref node) {
+    if (getPrintedDefun) {
+      if (auto* text = getPrintedDefun(node)) {
+        emit(text->c_str());
+        return;
+      }
+    }
     emit("function ");
     emit(node[1]->getCString());
     emit('(');
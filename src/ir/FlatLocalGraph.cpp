@@ -0,0 +1,630 @@
+/*
+ * Copyright 2022 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include <cfg/cfg-traversal.h>
+#include <ir/find_all.h>
+#include <ir/local-graph.h>
+
+namespace wasm {
+
+namespace FlatLocalGraphInternal {
+
+// A value that a local may have: nothing (in unreachable code), the initial
+// value, a set, or a phi of the values at the ends of several blocks.
+struct Value {
+  enum Kind : uint8_t { Undefined, Initial, Set, Phi } kind;
+  LocalSet* set = nullptr;
+  // For a phi, its operands are in phiOperands[start .. end).
+  Index start = 0;
+  Index end = 0;
+};
+
+using ValueId = Index;
+
+static constexpr ValueId UndefinedValue = 0;
+static constexpr ValueId InitialValue = 1;
+
+struct Info {
+  Index index;
+  // The gets and sets in this block, as action numbers.
+  std::vector<Index> actions;
+};
+
+template<typename T> size_t getBytes(const std::vector<T>& v) {
+  return v.capacity() * sizeof(T);
+}
+
+struct Flower : public CFGWalker<Flower, Visitor<Flower>, Info> {
+  using Actions = std::vector<std::pair<Expression*, Expression**>>;
+  Actions& actions;
+
+  Flower(Actions& actions) : actions(actions) {}
+
+  BasicBlock* makeBasicBlock() {
+    auto* block = new BasicBlock();
+    block->contents.index = basicBlocks.size();
+    return block;
+  }
+
+  static void doVisitLocalGet(Flower* self, Expression** currp) {
+    if (self->currBasicBlock) {
+      self->currBasicBlock->contents.actions.push_back(self->actions.size());
+      self->actions.emplace_back(*currp, currp);
+    }
+  }
+
+  static void doVisitLocalSet(Flower* self, Expression** currp) {
+    if (self->currBasicBlock) {
+      self->currBasicBlock->contents.actions.push_back(self->actions.size());
+      self->actions.emplace_back(*currp, currp);
+    }
+  }
+
+  // The CFG, flattened.
+  std::vector<Index> predsStart;
+  std::vector<Index> predsData;
+  // For each block, the value of the last set of each local index that it
+  // sets, sorted by index.
+  std::vector<Index> lastSetsStart;
+  std::vector<std::pair<Index, ValueId>> lastSetsData;
+
+  std::vector<Value> values;
+  std::vector<ValueId> phiOperands;
+  Index numPhis = 0;
+
+  // The value of a local at the start of a block, for the blocks and locals
+  // that we needed, keyed by (block << 32) | local.
+  std::unordered_map<uint64_t, ValueId> startValues;
+  // A marker in startValues for blocks on the path we are currently following.
+  static constexpr ValueId InProgress = ValueId(-1);
+
+  // Phis whose operands we must still compute, and the block and local for
+  // them.
+  std::vector<std::tuple<ValueId, Index, Index>> incompletePhis;
+
+  // For each get action, its value.
+  std::vector<ValueId> getValues;
+
+  void build(Function* func) {
+    doWalkFunction(func);
+
+    auto numBlocks = basicBlocks.size();
+    predsStart.reserve(numBlocks + 1);
+    lastSetsStart.reserve(numBlocks + 1);
+    values.push_back({Value::Undefined});
+    values.push_back({Value::Initial});
+    for (auto& block : basicBlocks) {
+      predsStart.push_back(predsData.size());
+      for (auto* pred : block->in) {
+        predsData.push_back(pred->contents.index);
+      }
+      lastSetsStart.push_back(lastSetsData.size());
+      for (auto action : block->contents.actions) {
+        if (auto* set = actions[action].first->dynCast<LocalSet>()) {
+          lastSetsData.emplace_back(set->index, values.size());
+          values.push_back({Value::Set, set});
+        }
+      }
+      // Keep the last set for each index: sort stably by index, and then keep
+      // the last of each run.
+      auto begin = lastSetsData.begin() + lastSetsStart.back();
+      std::stable_sort(begin,
+                       lastSetsData.end(),
+                       [](const std::pair<Index, ValueId>& a,
+                          const std::pair<Index, ValueId>& b) {
+                         return a.first < b.first;
+                       });
+      auto out = begin;
+      for (auto it = begin; it != lastSetsData.end(); ++it) {
+        if (it + 1 == lastSetsData.end() || (it + 1)->first != it->first) {
+          *out++ = *it;
+        }
+      }
+      lastSetsData.erase(out, lastSetsData.end());
+    }
+    predsStart.push_back(predsData.size());
+    lastSetsStart.push_back(lastSetsData.size());
+
+    // Find the value of each get, going through the blocks in order and noting
+    // the sets in each, so that we know which gets have a set earlier in
+    // their block. The sets' values were numbered in the same order.
+    getValues.resize(actions.size(), UndefinedValue);
+    std::vector<ValueId> currSets(func->getNumLocals(), UndefinedValue);
+    ValueId nextSetValue = InitialValue + 1;
+    for (auto& block : basicBlocks) {
+      auto& blockActions = block->contents.actions;
+      for (auto action : blockActions) {
+        auto* curr = actions[action].first;
+        if (auto* get = curr->dynCast<LocalGet>()) {
+          if (auto set = currSets[get->index]) {
+            getValues[action] = set;
+          } else {
+            getValues[action] =
+              getStartValue(block->contents.index, get->index);
+          }
+        } else {
+          currSets[curr->cast<LocalSet>()->index] = nextSetValue++;
+        }
+      }
+      for (auto action : blockActions) {
+        if (auto* set = actions[action].first->dynCast<LocalSet>()) {
+          currSets[set->index] = UndefinedValue;
+        }
+      }
+    }
+    completePhis();
+  }
+
+  // Returns the value of the last set of a local in a block, if there is one.
+  ValueId getLastSet(Index block, Index local) {
+    auto begin = lastSetsData.begin() + lastSetsStart[block];
+    auto end = lastSetsData.begin() + lastSetsStart[block + 1];
+    auto iter = std::lower_bound(begin,
+                                 end,
+                                 local,
+                                 [](const std::pair<Index, ValueId>& item,
+                                    Index local) {
+                                   return item.first < local;
+                                 });
+    if (iter != end && iter->first == local) {
+      return iter->second;
+    }
+    return UndefinedValue;
+  }
+
+  // Returns the value of a local at the end of a block.
+  ValueId getEndValue(Index block, Index local) {
+    if (auto set = getLastSet(block, local)) {
+      return set;
+    }
+    return getStartValue(block, local);
+  }
+
+  // Returns the value of a local at the start of a block. This follows chains
+  // of blocks with a single predecessor iteratively, and creates phis at
+  // blocks with several, whose operands are computed later.
+  ValueId getStartValue(Index block, Index local) {
+    std::vector<Index>& path = pathBuffer;
+    path.clear();
+    ValueId value;
+    while (1) {
+      auto key = (uint64_t(block) << 32) | local;
+      auto [iter, inserted] = startValues.emplace(key, InProgress);
+      if (!inserted) {
+        value = iter->second;
+        if (value == InProgress) {
+          // We went around a cycle of blocks with one predecessor each, so
+          // this is unreachable code.
+          value = UndefinedValue;
+        }
+        break;
+      }
+      path.push_back(block);
+      auto predsBegin = predsStart[block];
+      auto numPreds = predsStart[block + 1] - predsBegin;
+      if (numPreds == 0) {
+        // Only the entry has the initial value. Other blocks without
+        // predecessors are not reachable.
+        value = block == 0 ? InitialValue : UndefinedValue;
+        break;
+      }
+      if (numPreds > 1) {
+        value = values.size();
+        values.push_back({Value::Phi});
+        numPhis++;
+        incompletePhis.emplace_back(value, block, local);
+        break;
+      }
+      auto pred = predsData[predsBegin];
+      if (auto set = getLastSet(pred, local)) {
+        value = set;
+        break;
+      }
+      block = pred;
+    }
+    for (auto pathBlock : path) {
+      startValues[(uint64_t(pathBlock) << 32) | local] = value;
+    }
+    return value;
+  }
+
+  std::vector<Index> pathBuffer;
+
+  void completePhis() {
+    // Computing operands may add more phis, which we handle in turn. Doing so
+    // does not add operands, so the operands of each phi are contiguous.
+    while (!incompletePhis.empty()) {
+      auto [phi, block, local] = incompletePhis.back();
+      incompletePhis.pop_back();
+      values[phi].start = phiOperands.size();
+      for (auto i = predsStart[block]; i < predsStart[block + 1]; i++) {
+        phiOperands.push_back(getEndValue(predsData[i], local));
+      }
+      values[phi].end = phiOperands.size();
+    }
+  }
+
+  // The values that reach each phi through other phis, sorted. Phis in the
+  // same strongly connected component have the same ones, so we compute them
+  // for each component.
+  std::vector<Index> phiComponent;
+  std::vector<Index> componentStart;
+  std::vector<ValueId> componentData;
+
+  static constexpr Index NoComponent = Index(-1);
+
+  // Computes the components of the phis reachable from |root|, using an
+  // iterative version of Tarjan's algorithm.
+  void computeComponents(ValueId root) {
+    if (phiComponent.empty()) {
+      phiComponent.resize(values.size(), NoComponent);
+      order.resize(values.size(), 0);
+      lowLink.resize(values.size(), 0);
+    }
+    if (phiComponent[root] != NoComponent || order[root]) {
+      return;
+    }
+    struct Frame {
+      ValueId phi;
+      Index next;
+    };
+    std::vector<Frame> frames;
+    auto start = [&](ValueId phi) {
+      order[phi] = lowLink[phi] = ++counter;
+      stack.push_back(phi);
+      frames.push_back({phi, values[phi].start});
+    };
+    start(root);
+    while (!frames.empty()) {
+      auto& frame = frames.back();
+      auto phi = frame.phi;
+      if (frame.next < values[phi].end) {
+        auto operand = phiOperands[frame.next++];
+        if (values[operand].kind != Value::Phi) {
+          continue;
+        }
+        if (!order[operand]) {
+          start(operand);
+        } else if (phiComponent[operand] == NoComponent) {
+          // It is on the stack.
+          lowLink[phi] = std::min(lowLink[phi], order[operand]);
+        }
+        continue;
+      }
+      frames.pop_back();
+      if (!frames.empty()) {
+        auto parent = frames.back().phi;
+        lowLink[parent] = std::min(lowLink[parent], lowLink[phi]);
+      }
+      if (lowLink[phi] != order[phi]) {
+        continue;
+      }
+      // |phi| is the root of a component, made of it and the phis above it on
+      // the stack.
+      Index component = componentStart.size();
+      auto membersBegin =
+        std::find(stack.begin(), stack.end(), phi) - stack.begin();
+      for (auto i = membersBegin; i < Index(stack.size()); i++) {
+        phiComponent[stack[i]] = component;
+      }
+      componentStart.push_back(componentData.size());
+      for (auto i = membersBegin; i < Index(stack.size()); i++) {
+        auto& member = values[stack[i]];
+        for (auto j = member.start; j < member.end; j++) {
+          auto operand = phiOperands[j];
+          auto kind = values[operand].kind;
+          if (kind == Value::Phi) {
+            auto other = phiComponent[operand];
+            if (other != component) {
+              // An earlier component, whose values are known.
+              auto otherStart = componentStart[other];
+              for (Index k = 0; k < componentSize[other]; k++) {
+                componentData.push_back(componentData[otherStart + k]);
+              }
+            }
+          } else if (kind != Value::Undefined) {
+            componentData.push_back(operand);
+          }
+        }
+      }
+      auto begin = componentData.begin() + componentStart.back();
+      std::sort(begin, componentData.end());
+      componentData.erase(std::unique(begin, componentData.end()),
+                          componentData.end());
+      componentSize.push_back(componentData.end() - begin);
+      stack.resize(membersBegin);
+    }
+  }
+
+  std::vector<Index> componentSize;
+  std::vector<Index> order;
+  std::vector<Index> lowLink;
+  std::vector<ValueId> stack;
+  Index counter = 0;
+
+  size_t getTemporaryBytes() {
+    return getBytes(predsStart) + getBytes(predsData) +
+           getBytes(lastSetsStart) + getBytes(lastSetsData) +
+           getBytes(values) + getBytes(phiOperands) +
+           startValues.size() * (sizeof(uint64_t) + sizeof(ValueId)) +
+           getBytes(getValues) + getBytes(phiComponent) +
+           getBytes(componentStart) + getBytes(componentData) +
+           getBytes(componentSize) + getBytes(order) + getBytes(lowLink);
+  }
+};
+
+} // namespace FlatLocalGraphInternal
+
+FlatLocalGraph::FlatLocalGraph(Function* func) : func(func) {
+  using namespace FlatLocalGraphInternal;
+
+  Flower flower(actions);
+  flower.build(func);
+
+  // Number the actions.
+  actionNumbers.reserve(actions.size());
+  for (Index i = 0; i < actions.size(); i++) {
+    actionNumbers.emplace_back(actions[i].first, i);
+  }
+  std::sort(actionNumbers.begin(), actionNumbers.end());
+
+  // Write out the sets for each get.
+  getSetsStart.reserve(actions.size() + 1);
+  for (Index i = 0; i < actions.size(); i++) {
+    getSetsStart.push_back(getSetsData.size());
+    if (!actions[i].first->is<LocalGet>()) {
+      continue;
+    }
+    auto addValue = [&](ValueId value) {
+      auto& info = flower.values[value];
+      if (info.kind == Value::Set) {
+        getSetsData.push_back(info.set);
+      } else {
+        assert(info.kind == Value::Initial);
+        getSetsData.push_back(nullptr);
+      }
+    };
+    auto value = flower.getValues[i];
+    auto kind = flower.values[value].kind;
+    if (kind == Value::Phi) {
+      flower.computeComponents(value);
+      auto component = flower.phiComponent[value];
+      auto start = flower.componentStart[component];
+      for (Index j = 0; j < flower.componentSize[component]; j++) {
+        addValue(flower.componentData[start + j]);
+      }
+    } else if (kind != Value::Undefined) {
+      addValue(value);
+    }
+  }
+  getSetsStart.push_back(getSetsData.size());
+
+  stats.numBlocks = flower.basicBlocks.size();
+  stats.numActions = actions.size();
+  stats.numPhis = flower.numPhis;
+  stats.numGetSets = getSetsData.size();
+  updateBytes();
+  stats.peakBytes = stats.bytes + flower.getTemporaryBytes();
+
+#ifdef LOCAL_GRAPH_DEBUG
+  dumpStats(std::cout);
+#endif
+}
+
+Index FlatLocalGraph::getAction(Expression* curr) const {
+  auto iter = std::lower_bound(actionNumbers.begin(),
+                               actionNumbers.end(),
+                               curr,
+                               [](const std::pair<Expression*, Index>& item,
+                                  Expression* curr) {
+                                 return item.first < curr;
+                               });
+  if (iter != actionNumbers.end() && iter->first == curr) {
+    return iter->second;
+  }
+  return NoAction;
+}
+
+FlatLocalGraph::Sets
+FlatLocalGraph::GetSetses::operator[](LocalGet* get) const {
+  auto action = graph.getAction(get);
+  if (action == NoAction) {
+    return {};
+  }
+  auto* data = graph.getSetsData.data();
+  return {data + graph.getSetsStart[action],
+          data + graph.getSetsStart[action + 1]};
+}
+
+Expression**& FlatLocalGraph::Locations::operator[](Expression* curr) {
+  auto action = graph.getAction(curr);
+  assert(action != NoAction);
+  return graph.actions[action].second;
+}
+
+size_t FlatLocalGraph::Locations::count(Expression* curr) const {
+  return graph.getAction(curr) != NoAction;
+}
+
+FlatLocalGraph::SetInfluences
+FlatLocalGraph::SetInfluencesMap::operator[](LocalSet* set) const {
+  auto action = graph.getAction(set);
+  if (action == NoAction || graph.setInfluencesStart.empty()) {
+    return {};
+  }
+  auto* data = graph.setInfluencesData.data();
+  return {data + graph.setInfluencesStart[action],
+          data + graph.setInfluencesStart[action + 1]};
+}
+
+FlatLocalGraph::GetInfluences
+FlatLocalGraph::GetInfluencesMap::operator[](LocalGet* get) const {
+  auto action = graph.getAction(get);
+  if (action == NoAction || graph.getInfluencesStart.empty()) {
+    return {};
+  }
+  auto* data = graph.getInfluencesData.data();
+  return {data + graph.getInfluencesStart[action],
+          data + graph.getInfluencesStart[action + 1]};
+}
+
+bool FlatLocalGraph::equivalent(LocalGet* a, LocalGet* b) {
+  auto aSets = getSetses[a];
+  auto bSets = getSetses[b];
+  // See LocalGraph::equivalent.
+  if (aSets.size() != 1 || bSets.size() != 1) {
+    return false;
+  }
+  auto* aSet = *aSets.begin();
+  auto* bSet = *bSets.begin();
+  if (aSet != bSet) {
+    return false;
+  }
+  if (!aSet) {
+    if (func->isParam(a->index)) {
+      return a->index == b->index;
+    } else {
+      return func->getLocalType(a->index) == func->getLocalType(b->index);
+    }
+  }
+  return true;
+}
+
+void FlatLocalGraph::computeSetInfluences() {
+  // Count the gets of each set, and then fill them in.
+  std::vector<Index> counts(actions.size() + 1);
+  std::vector<std::pair<Index, LocalGet*>> edges;
+  for (Index i = 0; i < actions.size(); i++) {
+    auto* get = actions[i].first->dynCast<LocalGet>();
+    if (!get) {
+      continue;
+    }
+    for (auto j = getSetsStart[i]; j < getSetsStart[i + 1]; j++) {
+      if (auto* set = getSetsData[j]) {
+        auto setAction = getAction(set);
+        counts[setAction]++;
+        edges.emplace_back(setAction, get);
+      }
+    }
+  }
+  setInfluencesStart.resize(actions.size() + 1);
+  Index total = 0;
+  for (Index i = 0; i < actions.size(); i++) {
+    setInfluencesStart[i] = total;
+    total += counts[i];
+  }
+  setInfluencesStart[actions.size()] = total;
+  setInfluencesData.resize(total);
+  std::fill(counts.begin(), counts.end(), 0);
+  for (auto& [setAction, get] : edges) {
+    setInfluencesData[setInfluencesStart[setAction] + counts[setAction]++] =
+      get;
+  }
+  updateBytes();
+}
+
+void FlatLocalGraph::computeGetInfluences() {
+  std::vector<Index> counts(actions.size() + 1);
+  std::vector<std::pair<Index, LocalSet*>> edges;
+  for (Index i = 0; i < actions.size(); i++) {
+    auto* set = actions[i].first->dynCast<LocalSet>();
+    if (!set) {
+      continue;
+    }
+    FindAll<LocalGet> findAll(set->value);
+    for (auto* get : findAll.list) {
+      auto action = getAction(get);
+      if (action != NoAction) {
+        counts[action]++;
+        edges.emplace_back(action, set);
+      }
+    }
+  }
+  getInfluencesStart.resize(actions.size() + 1);
+  Index total = 0;
+  for (Index i = 0; i < actions.size(); i++) {
+    getInfluencesStart[i] = total;
+    total += counts[i];
+  }
+  getInfluencesStart[actions.size()] = total;
+  getInfluencesData.resize(total);
+  std::fill(counts.begin(), counts.end(), 0);
+  for (auto& [action, set] : edges) {
+    getInfluencesData[getInfluencesStart[action] + counts[action]++] = set;
+  }
+  updateBytes();
+}
+
+void FlatLocalGraph::computeSSAIndexes() {
+  // For each index, the one set that all its gets read, if there is one.
+  enum State : uint8_t { NoSets, OneSet, ManySets };
+  auto numLocals = func->getNumLocals();
+  std::vector<State> states(numLocals, NoSets);
+  std::vector<LocalSet*> sets(numLocals);
+  for (Index i = 0; i < actions.size(); i++) {
+    auto* get = actions[i].first->dynCast<LocalGet>();
+    if (!get) {
+      continue;
+    }
+    auto index = get->index;
+    for (auto j = getSetsStart[i]; j < getSetsStart[i + 1]; j++) {
+      auto* set = getSetsData[j];
+      if (states[index] == NoSets) {
+        states[index] = OneSet;
+        sets[index] = set;
+      } else if (states[index] == OneSet && sets[index] != set) {
+        states[index] = ManySets;
+      }
+    }
+  }
+  // Any other set of the index, even one that no get reads, means it is not
+  // SSA.
+  for (auto& [curr, _] : actions) {
+    if (auto* set = curr->dynCast<LocalSet>()) {
+      if (states[set->index] == OneSet && sets[set->index] != set) {
+        states[set->index] = ManySets;
+      }
+    }
+  }
+  SSAIndexes.resize(numLocals);
+  for (Index i = 0; i < numLocals; i++) {
+    SSAIndexes[i] = states[i] == OneSet;
+  }
+}
+
+bool FlatLocalGraph::isSSA(Index x) {
+  return x < SSAIndexes.size() && SSAIndexes[x];
+}
+
+void FlatLocalGraph::updateBytes() {
+  using FlatLocalGraphInternal::getBytes;
+  stats.bytes = getBytes(actions) + getBytes(actionNumbers) +
+                getBytes(getSetsStart) + getBytes(getSetsData) +
+                getBytes(setInfluencesStart) + getBytes(setInfluencesData) +
+                getBytes(getInfluencesStart) + getBytes(getInfluencesData) +
+                SSAIndexes.capacity() / 8;
+}
+
+void FlatLocalGraph::dumpStats(std::ostream& o) const {
+  o << "local graph of " << func->name << ": " << stats.numBlocks
+    << " blocks, " << stats.numActions << " gets and sets, " << stats.numPhis
+    << " phis, " << stats.numGetSets << " get-set edges, " << stats.bytes
+    << " bytes (peak " << stats.peakBytes << ")\n";
+}
+
+} // namespace wasm
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2026 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ir/arena-utils.h"
+#include "ir/manipulation.h"
+#include "support/threads.h"
+#include "wasm-stack.h"
+#include "wasm-traversal.h"
+
+namespace wasm::ArenaUtils {
+
+size_t getExpressionBytes(Expression* curr) {
+  size_t bytes = 0;
+
+#define DELEGATE_ID curr->_id
+
+#define DELEGATE_START(id)                                                     \
+  auto* cast = curr->cast<id>();                                               \
+  WASM_UNUSED(cast);                                                           \
+  bytes = sizeof(id);
+
+#define DELEGATE_FIELD_CHILD_VECTOR(id, field)                                 \
+  bytes += cast->field.size() * sizeof(Expression*);
+
+#define DELEGATE_FIELD_NAME_VECTOR(id, field)                                  \
+  bytes += cast->field.size() * sizeof(Name);
+
+#define DELEGATE_FIELD_SCOPE_NAME_USE_VECTOR(id, field)                        \
+  bytes += cast->field.size() * sizeof(Name);
+
+#define DELEGATE_FIELD_CHILD(id, field)
+#define DELEGATE_FIELD_INT(id, field)
+#define DELEGATE_FIELD_INT_ARRAY(id, field)
+#define DELEGATE_FIELD_LITERAL(id, field)
+#define DELEGATE_FIELD_NAME(id, field)
+#define DELEGATE_FIELD_SCOPE_NAME_DEF(id, field)
+#define DELEGATE_FIELD_SCOPE_NAME_USE(id, field)
+#define DELEGATE_FIELD_TYPE(id, field)
+#define DELEGATE_FIELD_HEAPTYPE(id, field)
+#define DELEGATE_FIELD_ADDRESS(id, field)
+
+#include "wasm-delegations-fields.def"
+
+  return bytes;
+}
+
+size_t getLiveBytes(Module& wasm) {
+  struct Counter
+    : public PostWalker<Counter, UnifiedExpressionVisitor<Counter>> {
+    size_t bytes = 0;
+    void visitExpression(Expression* curr) {
+      bytes += getExpressionBytes(curr);
+    }
+  };
+
+  Counter counter;
+  counter.walkModule(&wasm);
+  for (auto& func : wasm.functions) {
+    if (func->stackIR) {
+      for (auto* inst : *func->stackIR) {
+        if (inst) {
+          counter.bytes += sizeof(StackInst);
+        }
+      }
+    }
+  }
+  return counter.bytes;
+}
+
+namespace {
+
+// Lists the expressions in a tree in a fixed order, so that the lists for an
+// expression and for a copy of it correspond.
+std::vector<Expression*> listExpressions(Expression* curr) {
+  struct Lister : public PostWalker<Lister, UnifiedExpressionVisitor<Lister>> {
+    std::vector<Expression*> list;
+    void visitExpression(Expression* curr) { list.push_back(curr); }
+  };
+  Lister lister;
+  lister.walk(curr);
+  return std::move(lister.list);
+}
+
+template<typename T>
+void remapKeys(std::unordered_map<Expression*, T>& map,
+               const std::unordered_map<Expression*, Expression*>& copies) {
+  std::unordered_map<Expression*, T> remapped;
+  for (auto& [curr, value] : map) {
+    auto iter = copies.find(curr);
+    if (iter != copies.end()) {
+      remapped[iter->second] = value;
+    }
+  }
+  map = std::move(remapped);
+}
+
+void rehomeFunction(Function* func, Module& wasm) {
+  auto* copy = ExpressionManipulator::copy(func->body, wasm);
+
+  if (!func->debugLocations.empty() || !func->expressionLocations.empty() ||
+      !func->delimiterLocations.empty() || func->stackIR) {
+    // Things refer to expressions in the function, so map them to their
+    // copies.
+    auto originals = listExpressions(func->body);
+    auto copies = listExpressions(copy);
+    assert(originals.size() == copies.size());
+    std::unordered_map<Expression*, Expression*> copyMap;
+    for (Index i = 0; i < originals.size(); i++) {
+      copyMap[originals[i]] = copies[i];
+    }
+    remapKeys(func->debugLocations, copyMap);
+    remapKeys(func->expressionLocations, copyMap);
+    remapKeys(func->delimiterLocations, copyMap);
+    if (func->stackIR) {
+      auto& stackIR = *func->stackIR;
+      for (auto*& inst : stackIR) {
+        if (!inst) {
+          continue;
+        }
+        auto iter = copyMap.find(inst->origin);
+        if (iter == copyMap.end()) {
+          // Stack IR may have instructions of its own that are not in the
+          // Binaryen IR, like the unreachable that is emitted after code that
+          // does not return. Copy them once, so that the instructions that
+          // begin and end a scope keep sharing their origin.
+          iter = copyMap
+                   .emplace(inst->origin,
+                            ExpressionManipulator::copy(inst->origin, wasm))
+                   .first;
+        }
+        auto* newInst = wasm.allocator.alloc<StackInst>();
+        newInst->op = inst->op;
+        newInst->origin = iter->second;
+        newInst->type = inst->type;
+        inst = newInst;
+      }
+    }
+  }
+
+  func->body = copy;
+}
+
+} // anonymous namespace
+
+void rehome(Module& wasm) {
+  // Take the module's memory, so that copies are allocated in a fresh arena,
+  // and free it at the end.
+  MixedArena old;
+  old.swap(wasm.allocator);
+
+  std::vector<Function*> funcs;
+  for (auto& func : wasm.functions) {
+    if (!func->imported()) {
+      funcs.push_back(func.get());
+    }
+  }
+
+  size_t num = 1;
+  if (funcs.size() > 1) {
+    num = ThreadPool::get()->size();
+  }
+  if (num == 1) {
+    for (auto* func : funcs) {
+      rehomeFunction(func, wasm);
+    }
+  } else {
+    // The copies are allocated in parallel, each thread in an arena of its own
+    // that is chained to the module's.
+    std::vector<std::function<ThreadWorkState()>> doWorkers;
+    std::atomic<size_t> nextFunction;
+    nextFunction.store(0);
+    for (size_t i = 0; i < num; i++) {
+      doWorkers.push_back([&]() {
+        auto index = nextFunction.fetch_add(1);
+        if (index >= funcs.size()) {
+          return ThreadWorkState::Finished;
+        }
+        rehomeFunction(funcs[index], wasm);
+        if (index + 1 == funcs.size()) {
+          return ThreadWorkState::Finished;
+        }
+        return ThreadWorkState::More;
+      });
+    }
+    ThreadPool::get()->work(doWorkers);
+  }
+
+  auto rehomeExpression = [&](Expression*& curr) {
+    if (curr) {
+      curr = ExpressionManipulator::copy(curr, wasm);
+    }
+  };
+  for (auto& global : wasm.globals) {
+    rehomeExpression(global->init);
+  }
+  for (auto& segment : wasm.elementSegments) {
+    rehomeExpression(segment->offset);
+    for (auto*& item : segment->data) {
+      rehomeExpression(item);
+    }
+  }
+  for (auto& segment : wasm.memory.segments) {
+    rehomeExpression(segment.offset);
+  }
+}
+
+} // namespace wasm::ArenaUtils
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2026 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Utilities for the memory of a module's arena. The arena only ever grows, so
+// nodes that passes replace or remove stay allocated until the module is
+// destroyed, or until the IR is re-homed into a fresh arena.
+//
+
+#ifndef wasm_ir_arena_utils_h
+#define wasm_ir_arena_utils_h
+
+#include "wasm.h"
+
+namespace wasm::ArenaUtils {
+
+// Returns the number of bytes that an expression and its lists of children
+// and names use in the arena, not counting its children.
+size_t getExpressionBytes(Expression* curr);
+
+// Returns the number of bytes in the arena that the module's code still uses:
+// the expressions in functions, globals and segments, and the Stack IR.
+size_t getLiveBytes(Module& wasm);
+
+// Copies all the module's code into a fresh arena and frees the old one,
+// which reclaims the memory of the nodes that are no longer used. Both arenas
+// exist until the copy is done, so memory use is higher while this runs.
+// Debug locations, binary locations and Stack IR are kept. As every expression
+// moves, nothing may hold pointers to expressions while this runs, other than
+// the module itself.
+void rehome(Module& wasm);
+
+} // namespace wasm::ArenaUtils
+
+#endif // wasm_ir_arena_utils_h
@@ -19,6 +19,8 @@
 
 #include "ir/intrinsics.h"
 #include "pass.h"
+#include "support/small_bitset.h"
+#include "support/small_set.h"
 #include "wasm-traversal.h"
 
 namespace wasm {
@@ -67,10 +69,12 @@ public:
   // of control flow proceeding normally).
   bool branchesOut = false;
   bool calls = false;
-  std::set<Index> localsRead;
-  std::set<Index> localsWritten;
-  std::set<Name> mutableGlobalsRead;
-  std::set<Name> globalsWritten;
+  // The sets of locals and globals are compact, as we compute effects very
+  // often: usually few are accessed, and then these do not allocate.
+  SmallBitSet<2> localsRead;
+  SmallBitSet<2> localsWritten;
+  SmallSet<Name, 4> mutableGlobalsRead;
+  SmallSet<Name, 4> globalsWritten;
   bool readsMemory = false;
   bool writesMemory = false;
   bool readsTable = false;
@@ -123,7 +127,7 @@ public:
   // Helper functions to check for various effect types
 
   bool accessesLocal() const {
-    return localsRead.size() + localsWritten.size() > 0;
+    return !localsRead.empty() || !localsWritten.empty();
   }
   bool accessesMutableGlobal() const {
     return globalsWritten.size() + mutableGlobalsRead.size() > 0;
@@ -157,7 +161,7 @@ public:
   }
 
   bool hasNonTrapSideEffects() const {
-    return localsWritten.size() > 0 || danglingPop || writesGlobalState() ||
+    return !localsWritten.empty() || danglingPop || writesGlobalState() ||
            throws() || transfersControlFlow();
   }
 
@@ -217,15 +221,10 @@ public:
         (other.isAtomic && accessesMemory())) {
       return true;
     }
-    for (auto local : localsWritten) {
-      if (other.localsRead.count(local) || other.localsWritten.count(local)) {
-        return true;
-      }
-    }
-    for (auto local : localsRead) {
-      if (other.localsWritten.count(local)) {
-        return true;
-      }
+    if (localsWritten.intersects(other.localsRead) ||
+        localsWritten.intersects(other.localsWritten) ||
+        localsRead.intersects(other.localsWritten)) {
+      return true;
     }
     if ((other.calls && accessesMutableGlobal()) ||
         (calls && other.accessesMutableGlobal())) {
@@ -279,12 +278,8 @@ public:
     isAtomic = isAtomic || other.isAtomic;
     throws_ = throws_ || other.throws_;
     danglingPop = danglingPop || other.danglingPop;
-    for (auto i : other.localsRead) {
-      localsRead.insert(i);
-    }
-    for (auto i : other.localsWritten) {
-      localsWritten.insert(i);
-    }
+    localsRead |= other.localsRead;
+    localsWritten |= other.localsWritten;
     for (auto i : other.mutableGlobalsRead) {
       mutableGlobalsRead.insert(i);
     }
@@ -318,8 +313,8 @@ public:
     return hasAnything();
   }
 
-  std::set<Name> breakTargets;
-  std::set<Name> delegateTargets;
+  SmallSet<Name, 4> breakTargets;
+  SmallSet<Name, 4> delegateTargets;
 
 private:
   struct InternalAnalyzer
@@ -775,10 +770,10 @@ public:
     if (calls) {
       effects |= SideEffects::Calls;
     }
-    if (localsRead.size() > 0) {
+    if (!localsRead.empty()) {
       effects |= SideEffects::ReadsLocal;
     }
-    if (localsWritten.size() > 0) {
+    if (!localsWritten.empty()) {
       effects |= SideEffects::WritesLocal;
     }
     if (mutableGlobalsRead.size()) {
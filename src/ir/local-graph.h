@@ -102,6 +102,136 @@ private:
   std::set<Index> SSAIndexes;
 };
 
+//
+// The same information as LocalGraph, with the same queries, for very large
+// functions. LocalGraph stores everything in maps keyed by expressions, and
+// finds the sets for the gets by flowing back through the CFG separately for
+// each block and local index that has gets. This instead numbers the gets and
+// sets, and stores the results in flat arrays indexed by those numbers, which
+// take a few allocations in total. It finds the sets using a sparse SSA
+// construction: the value of a local at the start of a block is looked up
+// lazily and memoized, and blocks with several predecessors get a phi whose
+// operands are the values at the ends of those. The sets for a get are then
+// those that reach it through phis, computed once for each strongly
+// connected group of phis.
+//
+// Queries are made as with LocalGraph, for example graph.getSetses[get], but
+// return ranges in the arrays rather than containers. Gets and sets in
+// unreachable code are not numbered, and queries on them return nothing.
+//
+struct FlatLocalGraph {
+  FlatLocalGraph(Function* func);
+
+  FlatLocalGraph(const FlatLocalGraph&) = delete;
+  FlatLocalGraph& operator=(const FlatLocalGraph&) = delete;
+
+  template<typename T> struct Range {
+    const T* first = nullptr;
+    const T* last = nullptr;
+
+    const T* begin() const { return first; }
+    const T* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+  };
+
+  using Sets = Range<LocalSet*>;
+  using SetInfluences = Range<LocalGet*>;
+  using GetInfluences = Range<LocalSet*>;
+
+  // The sets affecting each get. A nullptr set means the initial value (0 for
+  // a var, the received value for a param).
+  struct GetSetses {
+    FlatLocalGraph& graph;
+    Sets operator[](LocalGet* get) const;
+  } getSetses{*this};
+
+  // Where each get and set is (for easy replacing). Iterating gives pairs of
+  // the original expression and its location, in the order of the code.
+  struct Locations {
+    FlatLocalGraph& graph;
+    Expression**& operator[](Expression* curr);
+    size_t count(Expression* curr) const;
+    size_t size() const { return graph.actions.size(); }
+    auto begin() { return graph.actions.begin(); }
+    auto end() { return graph.actions.end(); }
+  } locations{*this};
+
+  // Checks if two gets are equivalent, that is, definitely have the same
+  // value.
+  bool equivalent(LocalGet* a, LocalGet* b);
+
+  // Optional: compute the influence graphs between sets and gets.
+
+  void computeSetInfluences();
+  void computeGetInfluences();
+
+  void computeInfluences() {
+    computeSetInfluences();
+    computeGetInfluences();
+  }
+
+  // For each set, the gets whose values may come from it.
+  struct SetInfluencesMap {
+    FlatLocalGraph& graph;
+    SetInfluences operator[](LocalSet* set) const;
+  } setInfluences{*this};
+
+  // For each get, the sets whose values it is read in.
+  struct GetInfluencesMap {
+    FlatLocalGraph& graph;
+    GetInfluences operator[](LocalGet* get) const;
+  } getInfluences{*this};
+
+  // Optional: compute the local indexes that are SSA, as in LocalGraph.
+  void computeSSAIndexes();
+
+  bool isSSA(Index x);
+
+  struct Stats {
+    size_t numBlocks = 0;
+    size_t numActions = 0;
+    size_t numPhis = 0;
+    // The number of sets over all the gets' sets.
+    size_t numGetSets = 0;
+    // The most memory in use at once while computing the graph, and the
+    // memory the graph uses afterwards, in bytes. These count the arrays, and
+    // not the allocators' overheads.
+    size_t peakBytes = 0;
+    size_t bytes = 0;
+  };
+
+  const Stats& getStats() const { return stats; }
+  void dumpStats(std::ostream& o) const;
+
+private:
+  Function* func;
+
+  static const Index NoAction = Index(-1);
+
+  // The gets and sets, in the order of the code, and where they are.
+  std::vector<std::pair<Expression*, Expression**>> actions;
+  // The gets and sets sorted by address, for looking up their numbers.
+  std::vector<std::pair<Expression*, Index>> actionNumbers;
+
+  Index getAction(Expression* curr) const;
+
+  // The sets for action i are in getSetsData[getSetsStart[i] ..
+  // getSetsStart[i + 1]), and the same for the other maps.
+  std::vector<Index> getSetsStart;
+  std::vector<LocalSet*> getSetsData;
+  std::vector<Index> setInfluencesStart;
+  std::vector<LocalGet*> setInfluencesData;
+  std::vector<Index> getInfluencesStart;
+  std::vector<LocalSet*> getInfluencesData;
+
+  std::vector<bool> SSAIndexes;
+
+  Stats stats;
+
+  void updateBytes();
+};
+
 } // namespace wasm
 
 #endif // wasm_ir_local_graph_h
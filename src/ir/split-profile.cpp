@@ -0,0 +1,81 @@
+/*
+ * Copyright 2022 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ir/split-profile.h"
+#include "ir/find_all.h"
+#include "ir/module-utils.h"
+#include "support/file.h"
+#include "support/hash.h"
+
+namespace wasm::SplitProfile {
+
+ProfileData read(const std::string& file) {
+  auto profileData = read_file<std::vector<char>>(file, Flags::Binary);
+  size_t i = 0;
+  auto readi32 = [&]() {
+    if (i + 4 > profileData.size()) {
+      Fatal() << "Unexpected end of profile data in " << file;
+    }
+    uint32_t i32 = 0;
+    i32 |= uint32_t(uint8_t(profileData[i++]));
+    i32 |= uint32_t(uint8_t(profileData[i++])) << 8;
+    i32 |= uint32_t(uint8_t(profileData[i++])) << 16;
+    i32 |= uint32_t(uint8_t(profileData[i++])) << 24;
+    return i32;
+  };
+
+  uint64_t hash = readi32();
+  hash |= uint64_t(readi32()) << 32;
+
+  std::vector<size_t> timestamps;
+  std::vector<uint32_t> counters;
+  while (i < profileData.size()) {
+    auto timestamp = readi32();
+    if (timestamp == ProfileCountersMagic) {
+      counters.resize(readi32());
+      for (auto& counter : counters) {
+        counter = readi32();
+      }
+      if (i != profileData.size()) {
+        Fatal() << "Unexpected extra profile data in " << file;
+      }
+      break;
+    }
+    timestamps.push_back(timestamp);
+  }
+
+  return {hash, timestamps, counters};
+}
+
+uint64_t hashFile(const std::string& file) {
+  auto contents(read_file<std::vector<char>>(file, Flags::Binary));
+  size_t digest = 0;
+  // Don't use `hash` or `rehash` - they aren't deterministic between executions
+  for (char c : contents) {
+    hash_combine(digest, c);
+  }
+  return uint64_t(digest);
+}
+
+size_t getNumCounters(Module& wasm) {
+  size_t num = 0;
+  ModuleUtils::iterDefinedFunctions(wasm, [&](Function* func) {
+    num += 1 + FindAll<Loop>(func->body).list.size();
+  });
+  return num;
+}
+
+} // namespace wasm::SplitProfile
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2022 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Reading the profiles written by modules that wasm-split instrumented. See
+// "wasm-split profile format" in src/tools/wasm-split/instrumenter.cpp.
+//
+
+#ifndef wasm_ir_split_profile_h
+#define wasm_ir_split_profile_h
+
+#include "wasm.h"
+
+namespace wasm {
+
+// Marks the start of the counters in a profile.
+const uint32_t ProfileCountersMagic = 0x73746e63; // "cnts"
+
+namespace SplitProfile {
+
+struct ProfileData {
+  uint64_t hash;
+  // The timestamp of the first call to each defined function, or 0 if it was
+  // not called.
+  std::vector<size_t> timestamps;
+  // The counters, if the module was instrumented with --counters.
+  std::vector<uint32_t> counters;
+};
+
+ProfileData read(const std::string& file);
+
+// Returns the hash of a module file, which the profiles of the module that
+// wasm-split instrumented from it contain.
+uint64_t hashFile(const std::string& file);
+
+// Returns the number of counters for a module, which is the number of defined
+// functions plus the number of loops in them. The counters for a function are
+// its calls followed by the iterations of each of its loops, in the order of
+// FindAll<Loop>.
+size_t getNumCounters(Module& wasm);
+
+} // namespace SplitProfile
+
+} // namespace wasm
+
+#endif // wasm_ir_split_profile_h
@@ -17,12 +17,16 @@
 #ifndef wasm_mixed_arena_h
 #define wasm_mixed_arena_h
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <support/alloc.h>
@@ -70,6 +74,9 @@ struct MixedArena {
 
   size_t index = 0; // in last chunk
 
+  // The total size of chunks, in this arena only.
+  size_t chunkBytes = 0;
+
   std::thread::id threadId;
 
   // multithreaded allocation - each arena is valid on a specific thread.
@@ -77,6 +84,10 @@ struct MixedArena {
   // list of next, adding an allocator if necessary
   std::atomic<MixedArena*> next;
 
+  // The total size of the chunks allocated by all arenas so far, which lets
+  // tools see how much memory a piece of work allocated in arenas.
+  static inline std::atomic<size_t> totalChunkBytes{0};
+
   MixedArena() {
     threadId = std::this_thread::get_id();
     next.store(nullptr);
@@ -130,6 +141,9 @@ struct MixedArena {
         abort();
       }
       chunks.push_back(allocation);
+      chunkBytes += numChunks * CHUNK_SIZE;
+      totalChunkBytes.fetch_add(numChunks * CHUNK_SIZE,
+                                std::memory_order_relaxed);
       index = 0;
     }
     uint8_t* ret = static_cast<uint8_t*>(chunks.back());
@@ -153,6 +167,30 @@ struct MixedArena {
       wasm::aligned_free(chunk);
     }
     chunks.clear();
+    chunkBytes = 0;
+  }
+
+  // The total size of the chunks of this arena and of the arenas of other
+  // threads that are chained to it. Other threads must not allocate while this
+  // runs.
+  size_t getTotalChunkBytes() const {
+    size_t ret = 0;
+    for (auto* curr = this; curr; curr = curr->next.load()) {
+      ret += curr->chunkBytes;
+    }
+    return ret;
+  }
+
+  // Exchanges the memory of this arena and another, including the arenas of
+  // other threads that are chained to them, so that each frees the other's
+  // memory when it is destroyed. Neither may be allocated from while this runs.
+  void swap(MixedArena& other) {
+    std::swap(chunks, other.chunks);
+    std::swap(index, other.index);
+    std::swap(chunkBytes, other.chunkBytes);
+    auto* otherNext = other.next.load();
+    other.next.store(next.load());
+    next.store(otherNext);
   }
 
   ~MixedArena() {
@@ -171,9 +209,17 @@ struct MixedArena {
 template<typename SubType, typename T> class ArenaVectorBase {
 protected:
   T* data = nullptr;
-  size_t usedElements = 0, allocatedElements = 0;
+  // 32 bits are enough for the sizes of lists in the IR, and keep the nodes
+  // that have lists smaller.
+  uint32_t usedElements = 0, allocatedElements = 0;
+
+  static void checkSize(size_t size) {
+    assert(size <= std::numeric_limits<uint32_t>::max() &&
+           "too many elements in an ArenaVector");
+  }
 
   void reallocate(size_t size) {
+    checkSize(size);
     T* old = data;
     static_cast<SubType*>(this)->allocate(size);
     for (size_t i = 0; i < usedElements; i++) {
@@ -194,6 +240,7 @@ public:
   bool empty() const { return size() == 0; }
 
   void resize(size_t size) {
+    checkSize(size);
     if (size > allocatedElements) {
       reallocate(size);
     }
@@ -217,7 +264,11 @@ public:
 
   void push_back(T item) {
     if (usedElements == allocatedElements) {
-      reallocate((allocatedElements + 1) * 2); // TODO: optimize
+      // Grow in size_t, so that this does not wrap around, and up to the
+      // largest size we can store.
+      checkSize(size_t(usedElements) + 1);
+      reallocate(std::min((size_t(allocatedElements) + 1) * 2,
+                          size_t(std::numeric_limits<uint32_t>::max())));
     }
     data[usedElements] = item;
     usedElements++;
@@ -243,6 +294,7 @@ public:
   void clear() { usedElements = 0; }
 
   void reserve(size_t size) {
+    checkSize(size);
     if (size > allocatedElements) {
       reallocate(size);
     }
@@ -250,6 +302,7 @@ public:
 
   template<typename ListType> void set(const ListType& list) {
     size_t size = list.size();
+    checkSize(size);
     if (allocatedElements < size) {
       static_cast<SubType*>(this)->allocate(size);
     }
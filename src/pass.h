@@ -27,6 +27,8 @@
 namespace wasm {
 
 class Pass;
+class PassCache;
+class PassProfiler;
 
 //
 // Global registry of all passes in /passes/
@@ -165,6 +167,12 @@ struct PassOptions {
   // Arbitrary string arguments from the commandline, which we forward to
   // passes.
   std::map<std::string, std::string> arguments;
+  // If set, the runner records how long passes take and how much memory they
+  // allocate (see passes/pass-profile.h).
+  std::shared_ptr<PassProfiler> profiler;
+  // If set, the results of function-parallel passes are looked up in and added
+  // to this cache (see passes/pass-cache.h).
+  std::shared_ptr<PassCache> cache;
 
   // -Os is our default
   static constexpr const int DEFAULT_OPTIMIZE_LEVEL = 2;
@@ -280,6 +288,10 @@ struct PassRunner {
   // Run the passes on a specific function
   void runOnFunction(Function* func);
 
+  // Run the passes, which must be function-parallel, on some of the functions,
+  // in parallel. Unlike run(), this does not look at the other functions.
+  void runOnFunctions(const std::vector<Function*>& funcs);
+
   // Get the last pass that was already executed of a certain type.
   template<class P> P* getLast();
 
@@ -287,6 +299,7 @@ struct PassRunner {
   // flag should be set. This influences how pass debugging works,
   // and may influence other things in the future too.
   void setIsNested(bool nested) { isNested = nested; }
+  bool getIsNested() const { return isNested; }
 
   // BINARYEN_PASS_DEBUG is a convenient commandline way to log out the toplevel
   //                     passes, their times, and validate between each pass.
@@ -301,6 +314,11 @@ struct PassRunner {
   //  3: like 1, and also dumps out byn-* files for each pass as it is run.
   static int getPassDebug();
 
+  // BINARYEN_PASS_THREAD_STATS logs, for each stack of function-parallel passes
+  //                            that we run, how long each thread was busy and
+  //                            how long it was idle.
+  static bool getPassThreadStats();
+
   // Returns whether a pass by that name will remove debug info.
   static bool passRemovesDebugInfo(const std::string& name);
 
@@ -320,6 +338,13 @@ private:
   void runPass(Pass* pass);
   void runPassOnFunction(Pass* pass, Function* func);
 
+  // Run a stack of function-parallel passes on all the functions, running all
+  // the passes on one function before moving to the next.
+  // When profiling, |passTimes| receives the time spent in each of the passes.
+  void
+  runStackInParallel(const std::vector<Pass*>& stack,
+                     std::vector<std::pair<Name, double>>* passTimes = nullptr);
+
   // After running a pass, handle any changes due to
   // how the pass is defined, such as clearing away any
   // temporary data structures that the pass declares it
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2026 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Reclaims the memory of IR nodes that passes replaced or removed, by copying
+// the module's code into a fresh arena and freeing the old one. Long pipelines
+// leave most of the arena dead, so this lowers the memory that the module uses
+// from then on, e.g. when it is kept around after optimizing, or between
+// rounds of optimization:
+//
+//   wasm-opt -O3 --compact-arena -O3
+//
+// This does not lower peak memory, and can raise it: while the code is
+// copied, the old arena and the new one exist at once, as the functions share
+// the old arena, and none of its chunks can be freed until all of them moved.
+// Later passes may also allocate new chunks where the old arena had room.
+//
+// Every expression moves, so pointers to expressions that are held outside of
+// the module, like references in the C API, are invalid afterwards.
+//
+
+#include "ir/arena-utils.h"
+#include "pass.h"
+#include "wasm.h"
+
+namespace wasm {
+
+struct CompactArena : public Pass {
+  // The IR is copied as it is, and the Stack IR is kept.
+  bool modifiesBinaryenIR() override { return false; }
+
+  void run(PassRunner* runner, Module* module) override {
+    if (runner->getIsNested()) {
+      // The pass that is running us may be holding on to expressions.
+      return;
+    }
+    ArenaUtils::rehome(*module);
+  }
+};
+
+Pass* createCompactArenaPass() { return new CompactArena(); }
+
+} // namespace wasm
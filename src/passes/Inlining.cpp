@@ -134,14 +134,43 @@ static bool canHandleParams(Function* func) {
 
 typedef std::unordered_map<Name, FunctionInfo> NameInfoMap;
 
+// Scans functions to fill in their infos, and to count the references they
+// make to other functions. When only some functions changed, we can scan just
+// those: first we remove the references of their old code, and then we scan
+// the new code.
 struct FunctionInfoScanner
   : public WalkerPass<PostWalker<FunctionInfoScanner>> {
   bool isFunctionParallel() override { return true; }
 
-  FunctionInfoScanner(NameInfoMap* infos) : infos(infos) {}
+  bool modifiesBinaryenIR() override { return false; }
+
+  // If |removing|, we undo the references of the code instead of adding them.
+  FunctionInfoScanner(NameInfoMap* infos, bool removing = false)
+    : infos(infos), removing(removing) {}
 
   FunctionInfoScanner* create() override {
-    return new FunctionInfoScanner(infos);
+    return new FunctionInfoScanner(infos, removing);
+  }
+
+  void doWalkFunction(Function* func) {
+    if (!removing) {
+      // We will find the properties of the current code.
+      auto& info = (*infos)[func->name];
+      info.hasCalls = false;
+      info.hasLoops = false;
+      info.hasTryDelegate = false;
+    }
+    walk(func->body);
+  }
+
+  void noteRef(Name name) {
+    // can't add a new element in parallel
+    assert(infos->count(name) > 0);
+    if (removing) {
+      (*infos)[name].refs--;
+    } else {
+      (*infos)[name].refs++;
+    }
   }
 
   void visitLoop(Loop* curr) {
@@ -150,9 +179,7 @@ struct FunctionInfoScanner
   }
 
   void visitCall(Call* curr) {
-    // can't add a new element in parallel
-    assert(infos->count(curr->target) > 0);
-    (*infos)[curr->target].refs++;
+    noteRef(curr->target);
     // having a call
     (*infos)[getFunction()->name].hasCalls = true;
   }
@@ -171,12 +198,12 @@ struct FunctionInfoScanner
     }
   }
 
-  void visitRefFunc(RefFunc* curr) {
-    assert(infos->count(curr->func) > 0);
-    (*infos)[curr->func].refs++;
-  }
+  void visitRefFunc(RefFunc* curr) { noteRef(curr->func); }
 
   void visitFunction(Function* curr) {
+    if (removing) {
+      return;
+    }
     auto& info = (*infos)[curr->name];
 
     if (!canHandleParams(curr)) {
@@ -188,6 +215,7 @@ struct FunctionInfoScanner
 
 private:
   NameInfoMap* infos;
+  bool removing;
 };
 
 struct InliningAction {
@@ -384,6 +412,36 @@ doInlining(Module* module, Function* into, const InliningAction& action) {
   return block;
 }
 
+// Performs the inlinings chosen for each function, in parallel. Each function
+// is inlined into by a single thread, and the functions whose code we copy are
+// not modified in the same iteration (see Inlining::iteration), so the threads
+// do not interfere with each other.
+struct Applier : public Pass {
+  bool isFunctionParallel() override { return true; }
+
+  using Actions = std::unordered_map<Function*, std::vector<InliningAction>>;
+
+  Applier(Actions* actions) : actions(actions) {}
+
+  Applier* create() override { return new Applier(actions); }
+
+  void
+  runOnFunction(PassRunner* runner, Module* module, Function* func) override {
+    auto iter = actions->find(func);
+    if (iter == actions->end()) {
+      return;
+    }
+    for (auto& action : iter->second) {
+      doInlining(module, func, action);
+    }
+    // Anything we inlined into may now have non-unique label names, fix it up.
+    wasm::UniqueNameMapper::uniquify(func->body);
+  }
+
+private:
+  Actions* actions;
+};
+
 //
 // Function splitting / partial inlining / inlining of conditions.
 //
@@ -827,7 +885,8 @@ struct Inlining : public Pass {
   // whether to optimize where we inline
   bool optimize = false;
 
-  // the information for each function. recomputed in each iteraction
+  // the information for each function. computed at the start, and then
+  // updated for the functions that change in each iteration
   NameInfoMap infos;
 
   std::unique_ptr<FunctionSplitter> functionSplitter;
@@ -870,6 +929,8 @@ struct Inlining : public Pass {
 
     const size_t MaxIterationsForFunc = 5;
 
+    prepare();
+
     while (iterationNumber <= numOriginalFunctions) {
 #ifdef INLINING_DEBUG
       std::cout << "inlining loop iter " << iterationNumber
@@ -879,8 +940,16 @@ struct Inlining : public Pass {
 
       std::unordered_set<Function*> inlinedInto;
 
-      prepare();
-      iteration(inlinedInto);
+      // When optimizing heavily for size, we may potentially split functions
+      // in order to inline parts of them.
+      if (runner->options.optimizeLevel >= 3 && !runner->options.shrinkLevel) {
+        functionSplitter =
+          std::make_unique<FunctionSplitter>(module, runner->options);
+      }
+
+      std::vector<Name> addedFunctions;
+
+      iteration(inlinedInto, addedFunctions);
 
       if (inlinedInto.empty()) {
         return;
@@ -908,6 +977,18 @@ struct Inlining : public Pass {
           }
         }
       }
+
+      // Update the infos of the functions that we inlined into, whose old
+      // references were removed in iteration(), and add the functions that
+      // splitting created. (The split functions that we inlined were removed
+      // by the splitter, and nothing refers to them any more.)
+      for (auto name : addedFunctions) {
+        if (auto* func = module->getFunctionOrNull(name)) {
+          infos[name];
+          inlinedInto.insert(func);
+        }
+      }
+      scanFunctions(inlinedInto, false);
     }
   }
 
@@ -932,16 +1013,23 @@ struct Inlining : public Pass {
     if (module->start.is()) {
       infos[module->start].usedGlobally = true;
     }
+  }
 
-    // When optimizing heavily for size, we may potentially split functions in
-    // order to inline parts of them.
-    if (runner->options.optimizeLevel >= 3 && !runner->options.shrinkLevel) {
-      functionSplitter =
-        std::make_unique<FunctionSplitter>(module, runner->options);
+  // Scans some of the functions, to add their references and properties to
+  // the infos, or to remove their references before they change.
+  void scanFunctions(const std::unordered_set<Function*>& funcs,
+                     bool removing) {
+    if (funcs.empty()) {
+      return;
     }
+    PassRunner runner(module);
+    runner.setIsNested(true);
+    runner.add(std::make_unique<FunctionInfoScanner>(&infos, removing));
+    runner.runOnFunctions(std::vector<Function*>(funcs.begin(), funcs.end()));
   }
 
-  void iteration(std::unordered_set<Function*>& inlinedInto) {
+  void iteration(std::unordered_set<Function*>& inlinedInto,
+                 std::vector<Name>& addedFunctions) {
     // decide which to inline
     InliningState state;
     ModuleUtils::iterDefinedFunctions(*module, [&](Function* func) {
@@ -963,8 +1051,10 @@ struct Inlining : public Pass {
     }
     // find and plan inlinings
     Planner(&state).run(runner, module);
-    // perform inlinings TODO: parallelize
+    // Choose the inlinings to perform. This is done serially, as it is cheap
+    // and must be deterministic, and then we perform them in parallel.
     std::unordered_map<Name, Index> inlinedUses; // how many uses we inlined
+    Applier::Actions chosenActions;
     // which functions were inlined into
     for (auto name : funcNames) {
       auto* func = module->getFunction(name);
@@ -1002,28 +1092,51 @@ struct Inlining : public Pass {
         // note that we got rid of one use of the original function).
         action.contents = getActuallyInlinedFunction(action.contents);
 
-        // Perform the inlining and update counts.
-        doInlining(module, func, action);
+        // Plan the inlining and update counts.
+        chosenActions[func].push_back(action);
         inlinedUses[inlinedName]++;
         inlinedInto.insert(func);
         assert(inlinedUses[inlinedName] <= infos[inlinedName].refs);
       }
     }
-    for (auto func : inlinedInto) {
-      // Anything we inlined into may now have non-unique label names, fix it
-      // up.
-      wasm::UniqueNameMapper::uniquify(func->body);
+    for (auto i = funcNames.size(); i < module->functions.size(); i++) {
+      addedFunctions.push_back(module->functions[i]->name);
+    }
+    // Find the functions that we no longer need after inlining. We will also
+    // remove the references from them, and from the functions we inline into,
+    // as their code is about to change.
+    std::unordered_set<Function*> unneeded;
+    for (auto& [name, uses] : inlinedUses) {
+      auto& info = infos[name];
+      if (uses == info.refs && !info.usedGlobally) {
+        unneeded.insert(module->getFunction(name));
+      }
+    }
+    scanFunctions(inlinedInto, true);
+    scanFunctions(unneeded, true);
+    // Perform the inlinings, visiting only the functions we inline into.
+    {
+      std::vector<Function*> applyTo;
+      for (auto name : funcNames) {
+        auto* func = module->getFunction(name);
+        if (chosenActions.count(func)) {
+          applyTo.push_back(func);
+        }
+      }
+      PassRunner runner(module);
+      runner.setIsNested(true);
+      runner.add(std::make_unique<Applier>(&chosenActions));
+      runner.runOnFunctions(applyTo);
     }
     if (optimize && inlinedInto.size() > 0) {
       OptUtils::optimizeAfterInlining(inlinedInto, module, runner);
     }
     // remove functions that we no longer need after inlining
-    module->removeFunctions([&](Function* func) {
-      auto name = func->name;
-      auto& info = infos[name];
-      return inlinedUses.count(name) && inlinedUses[name] == info.refs &&
-             !info.usedGlobally;
-    });
+    for (auto* func : unneeded) {
+      infos.erase(func->name);
+    }
+    module->removeFunctions(
+      [&](Function* func) { return unneeded.count(func) > 0; });
   }
 
   bool worthInlining(Name name) {
@@ -105,7 +105,7 @@ struct MergeLocals
     }
     // compute all dependencies
     auto* func = getFunction();
-    LocalGraph preGraph(func);
+    FlatLocalGraph preGraph(func);
     preGraph.computeInfluences();
     // optimize each copy
     std::unordered_map<LocalSet*, LocalSet*> optimizedToCopy,
@@ -113,7 +113,7 @@ struct MergeLocals
     for (auto* copy : copies) {
       auto* trivial = copy->value->cast<LocalSet>();
       bool canOptimizeToCopy = false;
-      auto& trivialInfluences = preGraph.setInfluences[trivial];
+      auto trivialInfluences = preGraph.setInfluences[trivial];
       if (!trivialInfluences.empty()) {
         canOptimizeToCopy = true;
         for (auto* influencedGet : trivialInfluences) {
@@ -153,7 +153,7 @@ struct MergeLocals
 
         // if the trivial set we added has influences, it means $y lives on
         if (!trivialInfluences.empty()) {
-          auto& copyInfluences = preGraph.setInfluences[copy];
+          auto copyInfluences = preGraph.setInfluences[copy];
           if (!copyInfluences.empty()) {
             bool canOptimizeToTrivial = true;
             for (auto* influencedGet : copyInfluences) {
@@ -191,13 +191,13 @@ struct MergeLocals
       // if one does not work, we need to undo all its siblings (don't extend
       // the live range unless we are definitely removing a conflict, same
       // logic as before).
-      LocalGraph postGraph(func);
+      FlatLocalGraph postGraph(func);
       postGraph.computeSetInfluences();
       for (auto& [copy, trivial] : optimizedToCopy) {
-        auto& trivialInfluences = preGraph.setInfluences[trivial];
+        auto trivialInfluences = preGraph.setInfluences[trivial];
         for (auto* influencedGet : trivialInfluences) {
           // verify the set
-          auto& sets = postGraph.getSetses[influencedGet];
+          auto sets = postGraph.getSetses[influencedGet];
           if (sets.size() != 1 || *sets.begin() != copy) {
             // not good, undo all the changes for this copy
             for (auto* undo : trivialInfluences) {
@@ -208,10 +208,10 @@ struct MergeLocals
         }
       }
       for (auto& [copy, trivial] : optimizedToTrivial) {
-        auto& copyInfluences = preGraph.setInfluences[copy];
+        auto copyInfluences = preGraph.setInfluences[copy];
         for (auto* influencedGet : copyInfluences) {
           // verify the set
-          auto& sets = postGraph.getSetses[influencedGet];
+          auto sets = postGraph.getSetses[influencedGet];
           if (sets.size() != 1 || *sets.begin() != trivial) {
             // not good, undo all the changes for this copy
             for (auto* undo : copyInfluences) {
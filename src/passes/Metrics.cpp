@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <iomanip>
+#include <ir/arena-utils.h>
 #include <ir/module-utils.h>
 #include <pass.h>
 #include <support/colors.h>
@@ -152,6 +153,15 @@ struct Metrics
         vars += func->getNumVars();
       });
       counts["[vars]"] = vars;
+      if (getPassOptions().arguments.count("metrics-arena")) {
+        // How much of the arena the module's code uses, and how much is taken
+        // by nodes that are no longer used or not yet allocated, in KB. The
+        // sizes depend on the platform, so they are only shown when asked for.
+        auto total = module->allocator.getTotalChunkBytes();
+        auto live = ArenaUtils::getLiveBytes(*module);
+        counts["[arena-live-kb]"] = live / 1024;
+        counts["[arena-dead-kb]"] = (total - std::min(total, live)) / 1024;
+      }
       // print
       printCounts("total");
       // compare to next time
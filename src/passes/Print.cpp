@@ -23,6 +23,7 @@
 #include <ir/table-utils.h>
 #include <pass.h>
 #include <pretty_printing.h>
+#include <support/threads.h>
 #include <wasm-stack.h>
 #include <wasm.h>
 
@@ -3078,6 +3079,83 @@ struct PrintSExpression : public UnifiedExpressionVisitor<PrintSExpression> {
                           << dylinkSection->tail.size() << "\n";
     }
   }
+  // Prints the defined functions. The text of a function does not depend on the
+  // others, so when there are threads we print the functions into buffers in
+  // parallel and then write the buffers in order. That is done in batches, so
+  // that we do not hold all the text in memory at once.
+  void printDefinedFunctions(Module* curr) {
+    std::vector<Function*> funcs;
+    ModuleUtils::iterDefinedFunctions(
+      *curr, [&](Function* func) { funcs.push_back(func); });
+
+    // Use the thread pool if there is work for more than one thread.
+    size_t num = 1;
+    if (funcs.size() > 1) {
+      num = ThreadPool::get()->size();
+    }
+#ifdef _WIN32
+    // Colors are set on the console as we write, so they must be written in
+    // order.
+    if (Colors::isEnabledIn(o)) {
+      num = 1;
+    }
+#endif
+    if (num == 1) {
+      for (auto* func : funcs) {
+        visitFunction(func);
+      }
+      return;
+    }
+
+    // Each thread prints using a printer of its own, as printers keep state
+    // about the current function.
+    std::vector<std::stringstream> streams(num);
+    std::vector<std::unique_ptr<PrintSExpression>> printers;
+    for (size_t i = 0; i < num; i++) {
+      if (!Colors::isEnabledIn(o)) {
+        Colors::disableIn(streams[i]);
+      }
+      auto* print = new PrintSExpression(streams[i]);
+      print->setMinify(minify);
+      print->setFull(full);
+      print->setStackIR(stackIR);
+      print->setDebugInfo(debugInfo);
+      print->currModule = currModule;
+      print->indent = indent;
+      printers.emplace_back(print);
+    }
+
+    static const size_t FunctionsPerThreadInBatch = 64;
+    size_t batchSize = num * FunctionsPerThreadInBatch;
+    std::vector<std::string> texts(batchSize);
+    for (size_t start = 0; start < funcs.size(); start += batchSize) {
+      size_t end = std::min(start + batchSize, funcs.size());
+      std::vector<std::function<ThreadWorkState()>> doWorkers;
+      std::atomic<size_t> nextFunction;
+      nextFunction.store(start);
+      for (size_t i = 0; i < num; i++) {
+        doWorkers.push_back([&, i]() {
+          auto index = nextFunction.fetch_add(1);
+          if (index >= end) {
+            return ThreadWorkState::Finished;
+          }
+          printers[i]->visitFunction(funcs[index]);
+          texts[index - start] = streams[i].str();
+          streams[i].str("");
+          if (index + 1 == end) {
+            return ThreadWorkState::Finished;
+          }
+          return ThreadWorkState::More;
+        });
+      }
+      ThreadPool::get()->work(doWorkers);
+      for (size_t index = start; index < end; index++) {
+        o << texts[index - start];
+        texts[index - start].clear();
+      }
+    }
+  }
+
   void visitModule(Module* curr) {
     currModule = curr;
     o << '(';
@@ -3164,8 +3242,7 @@ struct PrintSExpression : public UnifiedExpressionVisitor<PrintSExpression> {
       printName(curr->start, o) << ')';
       o << maybeNewLine;
     }
-    ModuleUtils::iterDefinedFunctions(
-      *curr, [&](Function* func) { visitFunction(func); });
+    printDefinedFunctions(curr);
     if (curr->dylinkSection) {
       printDylinkSection(curr->dylinkSection);
     }
@@ -3432,7 +3509,7 @@ printStackIR(StackIR* ir, std::ostream& o, Function* func) {
       default:
         WASM_UNREACHABLE("unexpeted op");
     }
-    std::cout << '\n';
+    o << '\n';
   }
   assert(controlFlowDepth == 0);
   return o;
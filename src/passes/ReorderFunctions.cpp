@@ -26,10 +26,38 @@
 // order, the has some natural tendency one way or the other). TODO: investigate
 // similarity ordering here (see #4322)
 //
+// ReorderFunctionsByProfile instead sorts functions using a profile from
+// wasm-split --instrument, so that the code that runs first or most is at the
+// start of the code section. That lets engines that compile while streaming
+// have it ready sooner, and keeps the hot code together. It needs the profile
+// of the module it runs on, before other passes change its functions:
+//
+//   wasm-split --instrument --counters in.wasm -o instrumented.wasm
+//   (run instrumented.wasm and call __write_profile to get in.prof)
+//   wasm-opt in.wasm --reorder-functions-profile=in.prof -o out.wasm
+//
+// The profile has a hash of the module file that was instrumented. If the
+// reorder-functions-profile-module pass argument names a file, which wasm-opt
+// sets to its input file, the hash must match that of the file. Otherwise, as
+// in other tools and the C API, we can only check that the numbers of
+// functions and counters match the module.
+//
+// Functions that were not called go last, in their original order. With
+// counters, the others are clustered along the calls between them, as in
+// Pettis and Hansen's "Profile guided code positioning": going from the
+// hottest function down, each function's cluster is appended to that of the
+// caller it is most likely called from, up to a maximum size, and then the
+// clusters are sorted by how hot they are for their size. Without counters,
+// the functions go in the order they were first called in.
+//
 
 #include <memory>
 
 #include <ir/element-utils.h>
+#include <ir/find_all.h>
+#include <ir/module-utils.h>
+#include <ir/split-profile.h>
+#include <ir/utils.h>
 #include <pass.h>
 #include <wasm.h>
 
@@ -86,6 +114,225 @@ struct ReorderFunctions : public Pass {
   }
 };
 
+struct ReorderFunctionsByProfile : public Pass {
+  // The maximum size of a cluster, in expressions, after which we do not add
+  // callees to it. This is in the order of the size of a page of code.
+  static const Index MaxClusterSize = 4096;
+
+  struct Info {
+    // The timestamp of the first call, or 0 if the function was not called.
+    size_t timestamp = 0;
+    // The calls to the function, if we have counters.
+    uint64_t calls = 0;
+    // The calls to the function plus the iterations of its loops, if we have
+    // counters.
+    uint64_t heat = 0;
+    Index size = 0;
+  };
+
+  void run(PassRunner* runner, Module* module) override {
+    auto file = runner->options.getArgument(
+      "reorder-functions-profile",
+      "ReorderFunctionsByProfile usage: wasm-opt "
+      "--reorder-functions-profile=FILE");
+    auto profile = SplitProfile::read(file);
+    auto moduleFile = runner->options.getArgumentOrDefault(
+      "reorder-functions-profile-module", "");
+    if (!moduleFile.empty() &&
+        profile.hash != SplitProfile::hashFile(moduleFile)) {
+      Fatal() << "Profile " << file << " is not for module " << moduleFile
+              << ", as their hashes do not match";
+    }
+
+    std::vector<Function*> defined;
+    ModuleUtils::iterDefinedFunctions(
+      *module, [&](Function* func) { defined.push_back(func); });
+    if (profile.timestamps.size() != defined.size()) {
+      Fatal() << "Profile " << file << " has " << profile.timestamps.size()
+              << " functions, but the module has " << defined.size();
+    }
+    bool hasCounters = !profile.counters.empty();
+    if (hasCounters &&
+        profile.counters.size() != SplitProfile::getNumCounters(*module)) {
+      Fatal() << "Profile counters in " << file << " do not match the module";
+    }
+
+    std::unordered_map<Function*, Info> infos;
+    size_t c = 0;
+    for (Index i = 0; i < defined.size(); i++) {
+      auto* func = defined[i];
+      auto& info = infos[func];
+      info.timestamp = profile.timestamps[i];
+      info.size = Measurer::measure(func->body);
+      if (hasCounters) {
+        // The first counter of a function is its calls, and the others are the
+        // iterations of its loops.
+        info.calls = profile.counters[c];
+        auto numLoops = FindAll<Loop>(func->body).list.size();
+        for (size_t l = 0; l < 1 + numLoops; l++) {
+          info.heat += profile.counters[c++];
+        }
+      }
+    }
+
+    std::vector<Function*> called, uncalled;
+    for (auto* func : defined) {
+      (infos[func].timestamp ? called : uncalled).push_back(func);
+    }
+    std::stable_sort(
+      called.begin(), called.end(), [&](Function* a, Function* b) {
+        return infos[a].timestamp < infos[b].timestamp;
+      });
+    if (hasCounters) {
+      called = clusterByCalls(module, defined, called, infos);
+    }
+
+    // Imports do not have code, so they stay as they are, and go first.
+    std::vector<std::unique_ptr<Function>> sorted;
+    sorted.reserve(module->functions.size());
+    for (auto& func : module->functions) {
+      if (func->imported()) {
+        sorted.push_back(std::move(func));
+      }
+    }
+    std::unordered_map<Function*, std::unique_ptr<Function>*> owners;
+    for (auto& func : module->functions) {
+      if (func) {
+        owners[func.get()] = &func;
+      }
+    }
+    for (auto* list : {&called, &uncalled}) {
+      for (auto* func : *list) {
+        sorted.push_back(std::move(*owners[func]));
+      }
+    }
+    module->functions = std::move(sorted);
+  }
+
+  // Returns the called functions, which are in the order they were first
+  // called in, grouped into clusters along the calls between them.
+  std::vector<Function*>
+  clusterByCalls(Module* module,
+                 const std::vector<Function*>& defined,
+                 const std::vector<Function*>& called,
+                 std::unordered_map<Function*, Info>& infos) {
+    std::unordered_map<Function*, Index> indexes;
+    for (Index i = 0; i < defined.size(); i++) {
+      indexes[defined[i]] = i;
+    }
+
+    // Find the calls in each function.
+    ModuleUtils::ParallelFunctionAnalysis<std::vector<Name>> analysis(
+      *module, [&](Function* func, std::vector<Name>& targets) {
+        if (func->imported()) {
+          return;
+        }
+        for (auto* call : FindAll<Call>(func->body).list) {
+          targets.push_back(call->target);
+        }
+      });
+
+    // We only have the number of calls to each function, and not how many of
+    // them come from each caller, so estimate that by dividing the calls
+    // evenly among the call sites.
+    std::unordered_map<Function*, std::unordered_map<Function*, Index>> sites;
+    std::unordered_map<Function*, Index> numSites;
+    for (auto* caller : called) {
+      for (auto target : analysis.map[caller]) {
+        auto* callee = module->getFunction(target);
+        if (callee != caller && infos.count(callee) &&
+            infos[callee].timestamp) {
+          sites[callee][caller]++;
+          numSites[callee]++;
+        }
+      }
+    }
+
+    // Each function starts in a cluster of its own.
+    std::vector<std::vector<Function*>> clusters;
+    std::unordered_map<Function*, Index> clusterIndexes;
+    std::vector<uint64_t> clusterHeats;
+    std::vector<Index> clusterSizes;
+    for (auto* func : called) {
+      clusterIndexes[func] = clusters.size();
+      clusters.push_back({func});
+      clusterHeats.push_back(infos[func].heat);
+      clusterSizes.push_back(infos[func].size);
+    }
+
+    // Going from the hottest function down, append its cluster to the cluster
+    // of the caller that calls it the most.
+    auto byHeat = called;
+    std::stable_sort(
+      byHeat.begin(), byHeat.end(), [&](Function* a, Function* b) {
+        return infos[a].heat > infos[b].heat;
+      });
+    for (auto* func : byHeat) {
+      // Break ties between callers by the order they were first called in, and
+      // then by their order in the module, so that the result does not depend
+      // on the order of the map.
+      Function* best = nullptr;
+      Index bestSites = 0;
+      for (auto& [caller, callerSites] : sites[func]) {
+        if (!best || callerSites > bestSites ||
+            (callerSites == bestSites &&
+             std::make_pair(infos[caller].timestamp, indexes[caller]) <
+               std::make_pair(infos[best].timestamp, indexes[best]))) {
+          best = caller;
+          bestSites = callerSites;
+        }
+      }
+      if (!best) {
+        continue;
+      }
+      auto from = clusterIndexes[func];
+      auto to = clusterIndexes[best];
+      // The calls from the best caller are the calls to the function, divided
+      // evenly among its call sites. Do not cluster a function with a caller
+      // that we estimate did not call it at all.
+      auto calls = infos[func].calls * bestSites / numSites[func];
+      if (from == to || calls == 0 ||
+          clusterSizes[from] + clusterSizes[to] > MaxClusterSize) {
+        continue;
+      }
+      for (auto* moved : clusters[from]) {
+        clusterIndexes[moved] = to;
+        clusters[to].push_back(moved);
+      }
+      clusters[from].clear();
+      clusterHeats[to] += clusterHeats[from];
+      clusterSizes[to] += clusterSizes[from];
+    }
+
+    // Sort the clusters by their heat for their size, that is, how much they
+    // run for the code they need. Break ties by the order they were first
+    // called in.
+    std::vector<Index> order;
+    for (Index i = 0; i < clusters.size(); i++) {
+      if (!clusters[i].empty()) {
+        order.push_back(i);
+      }
+    }
+    auto getDensity = [&](Index i) {
+      return double(clusterHeats[i]) / std::max(clusterSizes[i], Index(1));
+    };
+    std::stable_sort(order.begin(), order.end(), [&](Index a, Index b) {
+      return getDensity(a) > getDensity(b);
+    });
+    std::vector<Function*> ret;
+    for (auto i : order) {
+      for (auto* func : clusters[i]) {
+        ret.push_back(func);
+      }
+    }
+    return ret;
+  }
+};
+
 Pass* createReorderFunctionsPass() { return new ReorderFunctions(); }
 
+Pass* createReorderFunctionsByProfilePass() {
+  return new ReorderFunctionsByProfile();
+}
+
 } // namespace wasm
@@ -37,8 +37,11 @@ struct RoundTrip : public Pass {
     // Write, clear, and read the module
     WasmBinaryWriter(module, buffer).write();
     ModuleUtils::clearModule(*module);
-    auto input = buffer.getAsChars();
-    WasmBinaryBuilder parser(*module, features, input);
+    WasmBinaryBuilder parser(
+      *module,
+      features,
+      std::string_view(reinterpret_cast<const char*>(buffer.data()),
+                       buffer.size()));
     parser.setDWARF(runner->options.debugInfo);
     try {
       parser.read();
@@ -89,7 +89,7 @@ struct SSAify : public Pass {
   runOnFunction(PassRunner* runner, Module* module_, Function* func_) override {
     module = module_;
     func = func_;
-    LocalGraph graph(func);
+    FlatLocalGraph graph(func);
     graph.computeSetInfluences();
     graph.computeSSAIndexes();
     // create new local indexes, one for each set
@@ -103,7 +103,7 @@ struct SSAify : public Pass {
     TypeUpdating::handleNonDefaultableLocals(func, *module);
   }
 
-  void createNewIndexes(LocalGraph& graph) {
+  void createNewIndexes(FlatLocalGraph& graph) {
     FindAll<LocalSet> sets(func->body);
     for (auto* set : sets.list) {
       // Indexes already in SSA form do not need to be modified - there is
@@ -115,7 +115,7 @@ struct SSAify : public Pass {
     }
   }
 
-  bool hasMerges(LocalSet* set, LocalGraph& graph) {
+  bool hasMerges(LocalSet* set, FlatLocalGraph& graph) {
     for (auto* get : graph.setInfluences[set]) {
       if (graph.getSetses[get].size() > 1) {
         return true;
@@ -124,10 +124,10 @@ struct SSAify : public Pass {
     return false;
   }
 
-  void computeGetsAndPhis(LocalGraph& graph) {
+  void computeGetsAndPhis(FlatLocalGraph& graph) {
     FindAll<LocalGet> gets(func->body);
     for (auto* get : gets.list) {
-      auto& sets = graph.getSetses[get];
+      auto sets = graph.getSetses[get];
       if (sets.size() == 0) {
         continue; // unreachable, ignore
       }
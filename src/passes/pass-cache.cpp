@@ -0,0 +1,453 @@
+/*
+ * Copyright 2022 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include "config.h"
+#include "ir/module-utils.h"
+#include "ir/names.h"
+#include "passes/pass-cache.h"
+#include "support/colors.h"
+#include "wasm-builder.h"
+#include "wasm-debug.h"
+#include "wasm-s-parser.h"
+
+namespace wasm {
+
+namespace {
+
+// A hash that is the same in every run, unlike the ones of Names and types,
+// which depend on where things are in memory.
+uint64_t hashString(std::string_view str,
+                    uint64_t digest = 14695981039346656037ULL) {
+  for (unsigned char c : str) {
+    digest ^= c;
+    digest *= 1099511628211ULL;
+  }
+  return digest;
+}
+
+std::string toHex(uint64_t value) {
+  std::stringstream ss;
+  ss << std::hex;
+  ss.width(16);
+  ss.fill('0');
+  ss << value;
+  return ss.str();
+}
+
+// Adds declarations of the module elements a function refers to, so that the
+// function can be printed and parsed on its own.
+struct ReferenceDeclarer : public PostWalker<ReferenceDeclarer> {
+  Module& wasm;
+  Module& stub;
+
+  ReferenceDeclarer(Module& wasm, Module& stub) : wasm(wasm), stub(stub) {}
+
+  void declareFunction(Name name) {
+    if (stub.getFunctionOrNull(name)) {
+      return;
+    }
+    auto import =
+      Builder::makeFunction(name, wasm.getFunction(name)->type, {});
+    import->module = "env";
+    import->base = name;
+    stub.addFunction(std::move(import));
+  }
+
+  void declareGlobal(Name name) {
+    if (stub.getGlobalOrNull(name)) {
+      return;
+    }
+    auto* global = wasm.getGlobal(name);
+    auto import = Builder::makeGlobal(
+      name,
+      global->type,
+      nullptr,
+      global->mutable_ ? Builder::Mutable : Builder::Immutable);
+    import->module = "env";
+    import->base = name;
+    stub.addGlobal(std::move(import));
+  }
+
+  void declareTable(Name name) {
+    if (stub.getTableOrNull(name)) {
+      return;
+    }
+    auto* table = ModuleUtils::copyTable(wasm.getTable(name), stub);
+    table->module = "env";
+    table->base = name;
+  }
+
+  void declareTag(Name name) {
+    if (stub.getTagOrNull(name)) {
+      return;
+    }
+    auto* tag = ModuleUtils::copyTag(wasm.getTag(name), stub);
+    tag->module = "env";
+    tag->base = name;
+  }
+
+  void visitCall(Call* curr) { declareFunction(curr->target); }
+  void visitRefFunc(RefFunc* curr) { declareFunction(curr->func); }
+  void visitGlobalGet(GlobalGet* curr) { declareGlobal(curr->name); }
+  void visitGlobalSet(GlobalSet* curr) { declareGlobal(curr->name); }
+  void visitCallIndirect(CallIndirect* curr) { declareTable(curr->table); }
+  void visitTableGet(TableGet* curr) { declareTable(curr->table); }
+  void visitTableSet(TableSet* curr) { declareTable(curr->table); }
+  void visitTableSize(TableSize* curr) { declareTable(curr->table); }
+  void visitTableGrow(TableGrow* curr) { declareTable(curr->table); }
+  void visitThrow(Throw* curr) { declareTag(curr->tag); }
+  void visitTry(Try* curr) {
+    for (auto tag : curr->catchTags) {
+      declareTag(tag);
+    }
+  }
+};
+
+// The text format gives a name to every block, loop and try, so before printing
+// we name the unnamed ones in a way we recognize, and remove those names again
+// after parsing.
+struct UnnamedLabels : public PostWalker<UnnamedLabels> {
+  static constexpr const char* prefix = "binaryen-cache-unnamed-";
+
+  bool add;
+  Index counter = 0;
+
+  UnnamedLabels(bool add) : add(add) {}
+
+  void handle(Name& name) {
+    if (add && !name.is()) {
+      name = prefix + std::to_string(counter++);
+    } else if (!add && name.is() && name.startsWith(prefix)) {
+      name = Name();
+    }
+  }
+
+  void visitBlock(Block* curr) { handle(curr->name); }
+  void visitLoop(Loop* curr) { handle(curr->name); }
+  void visitTry(Try* curr) { handle(curr->name); }
+};
+
+// A function in the form we keep in the cache: the text of a module that has
+// the function and declarations of what it refers to. All locals are named in
+// the text, so we also note which of them had names to begin with.
+struct SerializedFunction {
+  std::string text;
+  std::vector<Index> namedLocals;
+
+  std::string toString() const {
+    std::stringstream ss;
+    ss << text << ";; named locals:";
+    for (auto index : namedLocals) {
+      ss << ' ' << index;
+    }
+    ss << '\n';
+    return ss.str();
+  }
+
+  static std::optional<SerializedFunction> fromString(const std::string& str) {
+    const std::string marker = ";; named locals:";
+    auto pos = str.rfind(marker);
+    if (pos == std::string::npos) {
+      return {};
+    }
+    SerializedFunction ret;
+    ret.text = str.substr(0, pos);
+    std::stringstream ss(str.substr(pos + marker.size()));
+    Index index;
+    while (ss >> index) {
+      ret.namedLocals.push_back(index);
+    }
+    return ret;
+  }
+};
+
+std::optional<SerializedFunction> serialize(Module& wasm, Function* func) {
+  // Debug info is not represented in the text, and Stack IR is not copied.
+  if (!func->debugLocations.empty() || !func->prologLocation.empty() ||
+      !func->epilogLocation.empty() || func->stackIR) {
+    return {};
+  }
+  Module stub;
+  stub.features = wasm.features;
+  auto* copy = ModuleUtils::copyFunction(func, stub);
+  SerializedFunction ret;
+  for (Index i = 0; i < func->getNumLocals(); i++) {
+    if (func->hasLocalName(i)) {
+      ret.namedLocals.push_back(i);
+    }
+  }
+  Names::ensureNames(copy);
+  UnnamedLabels(true).walk(copy->body);
+  ReferenceDeclarer(wasm, stub).walk(copy->body);
+  if (wasm.memory.exists) {
+    stub.memory.exists = true;
+    stub.memory.name = wasm.memory.name;
+    stub.memory.initial = wasm.memory.initial;
+    stub.memory.max = wasm.memory.max;
+    stub.memory.shared = wasm.memory.shared;
+    stub.memory.indexType = wasm.memory.indexType;
+    stub.memory.module = "env";
+    stub.memory.base = "memory";
+  }
+  std::stringstream ss;
+  Colors::disableIn(ss);
+  ss << stub;
+  ret.text = ss.str();
+  return ret;
+}
+
+// Parses a serialized function into a module of its own. Returns nothing if it
+// does not parse, which can happen if it refers to things we do not declare.
+std::unique_ptr<Module> parse(Module& wasm, const std::string& text) {
+  auto stub = std::make_unique<Module>();
+  stub->features = wasm.features;
+  std::string input = text;
+  try {
+    SExpressionParser parser(input.data());
+    Element& root = *parser.root;
+    if (root.size() != 1) {
+      return nullptr;
+    }
+    SExpressionWasmBuilder builder(*stub, *root[0], IRProfile::Normal);
+  } catch (ParseException&) {
+    return nullptr;
+  }
+  for (auto& func : stub->functions) {
+    if (!func->imported()) {
+      UnnamedLabels(false).walk(func->body);
+    }
+  }
+  return stub;
+}
+
+} // anonymous namespace
+
+PassCache::PassCache(std::string directory) : directory(directory) {}
+
+std::optional<PassCache::Stack>
+PassCache::getStack(const std::vector<Pass*>& stack,
+                    const PassOptions& options,
+                    Module& wasm) {
+  // Passes that do not modify Binaryen IR may have other outputs, like printing
+  // or Stack IR, that we cannot replay.
+  for (auto* pass : stack) {
+    if (!pass->modifiesBinaryenIR()) {
+      return {};
+    }
+  }
+  // Nominal types are not equal to the same types parsed again, and we do not
+  // keep DWARF locations.
+  if (getTypeSystem() == TypeSystem::Nominal || Debug::hasDWARFSections(wasm)) {
+    return {};
+  }
+  std::stringstream ss;
+  ss << "passes:";
+  for (auto* pass : stack) {
+    ss << ' ' << pass->name;
+  }
+  auto& inlining = options.inlining;
+  ss << " | O" << options.optimizeLevel << " s" << options.shrinkLevel
+     << " inline " << inlining.alwaysInlineMaxSize << ' '
+     << inlining.oneCallerInlineMaxSize << ' '
+     << inlining.flexibleInlineMaxSize << ' '
+     << inlining.allowFunctionsWithLoops << ' '
+     << inlining.partialInliningIfs << " flags "
+     << options.ignoreImplicitTraps << options.trapsNeverHappen
+     << options.lowMemoryUnused << options.fastMath
+     << options.zeroFilledMemory << options.debugInfo << " type-system "
+     << int(getTypeSystem());
+  for (auto& [key, value] : options.arguments) {
+    ss << " arg " << key << '=' << value;
+  }
+  // Keep the description on one line, as it is a line in the cache entries.
+  auto description = ss.str();
+  std::replace(description.begin(), description.end(), '\n', ' ');
+  return Stack{description, hashContext(wasm)};
+}
+
+uint64_t PassCache::hashContext(Module& wasm) {
+  // Print a copy of the module in which all functions are imports.
+  Module context;
+  std::string functionKinds;
+  for (auto& func : wasm.functions) {
+    auto import = Builder::makeFunction(func->name, func->type, {});
+    if (func->imported()) {
+      import->module = func->module;
+      import->base = func->base;
+      functionKinds += 'i';
+    } else {
+      import->module = "env";
+      import->base = func->name;
+      functionKinds += 'd';
+    }
+    context.addFunction(std::move(import));
+  }
+  for (auto& curr : wasm.exports) {
+    context.addExport(new Export(*curr));
+  }
+  for (auto& curr : wasm.globals) {
+    ModuleUtils::copyGlobal(curr.get(), context);
+  }
+  for (auto& curr : wasm.tags) {
+    auto* tag = ModuleUtils::copyTag(curr.get(), context);
+    tag->module = curr->module;
+    tag->base = curr->base;
+  }
+  for (auto& curr : wasm.elementSegments) {
+    ModuleUtils::copyElementSegment(curr.get(), context);
+  }
+  for (auto& curr : wasm.tables) {
+    ModuleUtils::copyTable(curr.get(), context);
+  }
+  context.memory = wasm.memory;
+  for (auto& segment : context.memory.segments) {
+    segment.offset = ExpressionManipulator::copy(segment.offset, context);
+  }
+  context.start = wasm.start;
+  context.features = wasm.features;
+
+  std::stringstream ss;
+  Colors::disableIn(ss);
+  ss << context << functionKinds << '\n' << wasm.features.toString() << '\n';
+  return hashString(ss.str());
+}
+
+bool PassCache::load(Module& wasm,
+                     Function* func,
+                     const Stack& stack,
+                     Entry& entry) {
+  auto input = serialize(wasm, func);
+  if (!input) {
+    uncacheable++;
+    return false;
+  }
+  entry.input = input->toString();
+  entry.key = hashString(entry.input,
+                         hashString(stack.description, stack.context));
+
+  auto header = std::string("binaryen-pass-cache ") + PROJECT_VERSION + '\n' +
+                stack.description + '\n' + toHex(stack.context) + '\n' +
+                std::to_string(entry.input.size()) + '\n' + entry.input;
+  std::ifstream file(getPath(entry.key), std::ios::binary);
+  if (file) {
+    std::stringstream contents;
+    contents << file.rdbuf();
+    auto str = contents.str();
+    // The entry must be for exactly the same input, and not just one with the
+    // same hash.
+    if (str.compare(0, header.size(), header) == 0) {
+      auto output = SerializedFunction::fromString(str.substr(header.size()));
+      std::unique_ptr<Module> parsed;
+      if (output) {
+        parsed = parse(wasm, output->text);
+      }
+      Function* cached = nullptr;
+      if (parsed) {
+        cached = parsed->getFunctionOrNull(func->name);
+      }
+      if (cached && cached->type == func->type && !cached->imported()) {
+        func->body = ExpressionManipulator::copy(cached->body, wasm);
+        func->vars = cached->vars;
+        func->localNames.clear();
+        func->localIndices.clear();
+        for (auto index : output->namedLocals) {
+          auto name = cached->getLocalName(index);
+          func->localNames[index] = name;
+          func->localIndices[name] = index;
+        }
+        func->stackIR.reset();
+        hits++;
+        return true;
+      }
+    }
+  }
+  entry.missed = true;
+  misses++;
+  return false;
+}
+
+void PassCache::store(Module& wasm,
+                      Function* func,
+                      const Stack& stack,
+                      Entry& entry) {
+  auto output = serialize(wasm, func);
+  if (!output) {
+    return;
+  }
+  // Only store results that read back as the same IR, by checking that they
+  // print the same after parsing them.
+  auto parsed = parse(wasm, output->text);
+  if (!parsed) {
+    return;
+  }
+  auto* reparsed = parsed->getFunctionOrNull(func->name);
+  if (!reparsed) {
+    return;
+  }
+  auto printed = serialize(*parsed, reparsed);
+  if (!printed || printed->text != output->text) {
+    return;
+  }
+
+  // Write to a temporary file and rename it into place, so that processes that
+  // share the cache never see a partial entry.
+  auto path = getPath(entry.key);
+  std::random_device random;
+  auto temp = path + ".tmp" + toHex((uint64_t(random()) << 32) | random());
+  {
+    std::ofstream file(temp, std::ios::binary);
+    file << "binaryen-pass-cache " << PROJECT_VERSION << '\n'
+         << stack.description << '\n'
+         << toHex(stack.context) << '\n'
+         << entry.input.size() << '\n'
+         << entry.input << output->toString();
+    if (!file) {
+      if (!warnedAboutWriting.exchange(true)) {
+        std::cerr << "warning: could not write to the pass cache in "
+                  << directory << '\n';
+      }
+      std::remove(temp.c_str());
+      return;
+    }
+  }
+  if (std::rename(temp.c_str(), path.c_str()) != 0) {
+    std::remove(temp.c_str());
+    return;
+  }
+  stores++;
+}
+
+void PassCache::discard(size_t numFunctions) { discarded += numFunctions; }
+
+void PassCache::printStats(std::ostream& o) {
+  o << "[PassCache] " << hits << " hits, " << misses << " misses, " << stores
+    << " stored, " << discarded
+    << " not stored as the passes changed the module, " << uncacheable
+    << " not cacheable\n";
+}
+
+std::string PassCache::getPath(uint64_t key) {
+  return directory + "/" + toHex(key) + ".wat";
+}
+
+} // namespace wasm
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2022 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef wasm_passes_pass_cache_h
+#define wasm_passes_pass_cache_h
+
+#include <atomic>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "pass.h"
+#include "wasm.h"
+
+//
+// An on-disk cache of the results of running stacks of function-parallel
+// passes. When the same function is optimized again by the same passes, with
+// the same options, in a module whose other contents the passes may look at
+// are the same, the result is read from the cache instead of running the
+// passes.
+//
+// The key of an entry is made of:
+//
+//  * The function, including its name and local names.
+//  * The passes in the stack, and the pass options.
+//  * A hash of everything in the module except for the bodies of functions,
+//    which is what function-parallel passes may look at besides the function
+//    they run on. Any change there, including one made by an earlier module
+//    pass, invalidates all the entries for the module.
+//
+// Functions are stored in the text format, together with declarations of the
+// things they refer to, as that represents Binaryen IR exactly. An entry is
+// only stored if it reads back into the same IR, and only if running the stack
+// did not change the rest of the module, as the cache could not replay that.
+// Reading an entry compares the whole function and pass list, so a collision
+// of the hashes can only cause a miss.
+//
+
+namespace wasm {
+
+class PassCache {
+public:
+  // Entries are stored as files in |directory|, which must exist.
+  PassCache(std::string directory);
+
+  // Everything about a stack of passes that the results depend on, other than
+  // the function itself.
+  struct Stack {
+    std::string description;
+    uint64_t context;
+  };
+
+  // Returns the key for running a stack of passes on functions in a module, or
+  // nothing if the results of that cannot be cached.
+  static std::optional<Stack> getStack(const std::vector<Pass*>& stack,
+                                       const PassOptions& options,
+                                       Module& wasm);
+
+  // Returns a hash of the contents of the module other than the bodies of
+  // functions.
+  static uint64_t hashContext(Module& wasm);
+
+  // A function we looked up in the cache.
+  struct Entry {
+    // Whether the function can be cached but was not found, so that we should
+    // store it after running the passes.
+    bool missed = false;
+    uint64_t key = 0;
+    std::string input;
+  };
+
+  // Looks up the result of running a stack of passes on a function. If it is
+  // in the cache, replaces the function's contents with it and returns true.
+  // Otherwise fills in |entry| with what store() needs to add the result later.
+  bool load(Module& wasm, Function* func, const Stack& stack, Entry& entry);
+
+  // Stores the result of running a stack of passes on a function that load()
+  // did not find.
+  void store(Module& wasm, Function* func, const Stack& stack, Entry& entry);
+
+  // Notes that we ran passes on functions without storing the results, as the
+  // passes modified the module in ways we cannot replay.
+  void discard(size_t numFunctions);
+
+  void printStats(std::ostream& o);
+
+private:
+  std::string directory;
+
+  std::atomic<size_t> hits{0};
+  std::atomic<size_t> misses{0};
+  std::atomic<size_t> uncacheable{0};
+  std::atomic<size_t> stores{0};
+  std::atomic<size_t> discarded{0};
+  std::atomic<bool> warnedAboutWriting{false};
+
+  std::string getPath(uint64_t key);
+};
+
+} // namespace wasm
+
+#endif // wasm_passes_pass_cache_h
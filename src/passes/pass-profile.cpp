@@ -0,0 +1,194 @@
+/*
+ * Copyright 2022 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iomanip>
+#include <sstream>
+
+#include "passes/pass-profile.h"
+#include "support/file.h"
+#include "wasm-binary.h"
+
+namespace wasm {
+
+namespace {
+
+void writeJSONString(std::ostream& o, std::string_view str) {
+  o << '"';
+  for (unsigned char c : str) {
+    switch (c) {
+      case '"':
+        o << "\\\"";
+        break;
+      case '\\':
+        o << "\\\\";
+        break;
+      case '\n':
+        o << "\\n";
+        break;
+      case '\t':
+        o << "\\t";
+        break;
+      default:
+        if (c < 0x20) {
+          const char* hex = "0123456789abcdef";
+          o << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+        } else {
+          o << c;
+        }
+    }
+  }
+  o << '"';
+}
+
+double toMilliseconds(std::clock_t cpu) {
+  return 1000.0 * double(cpu) / CLOCKS_PER_SEC;
+}
+
+} // anonymous namespace
+
+PassProfiler::PassProfiler() : origin(Clock::now()) {
+  // The thread that creates the profiler, which is normally the main thread,
+  // appears first.
+  getThreadIndex(std::this_thread::get_id());
+}
+
+PassProfiler::Sample PassProfiler::sample() {
+  Sample ret;
+  ret.arenaBytes = MixedArena::totalChunkBytes.load();
+  ret.cpu = std::clock();
+  ret.time = Clock::now();
+  return ret;
+}
+
+size_t PassProfiler::getSize(Module& wasm) {
+  BufferWithRandomAccess buffer;
+  WasmBinaryWriter writer(&wasm, buffer);
+  // Updating the DWARF sections would change the module, and then the real
+  // write of it at the end would update them a second time.
+  writer.setUpdateDWARF(false);
+  writer.write();
+  return buffer.size();
+}
+
+void PassProfiler::addPass(
+  const std::string& name,
+  bool nested,
+  const Sample& before,
+  const Sample& after,
+  const std::vector<std::pair<Name, double>>& passTimes) {
+  Event event;
+  event.name = name;
+  if (!passTimes.empty()) {
+    event.category = "function-parallel";
+  } else {
+    event.category = nested ? "nested-pass" : "pass";
+  }
+  event.start = before.time;
+  event.end = after.time;
+  event.args.emplace_back("cpu_ms",
+                          std::to_string(toMilliseconds(after.cpu) -
+                                         toMilliseconds(before.cpu)));
+  event.args.emplace_back("arena_bytes",
+                          std::to_string(after.arenaBytes - before.arenaBytes));
+  if (before.size) {
+    event.args.emplace_back("size_before", std::to_string(*before.size));
+  }
+  if (after.size) {
+    event.args.emplace_back("size_after", std::to_string(*after.size));
+  }
+  if (!passTimes.empty()) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3) << '{';
+    bool first = true;
+    for (auto& [pass, seconds] : passTimes) {
+      if (!first) {
+        ss << ',';
+      }
+      first = false;
+      writeJSONString(ss, pass.str);
+      ss << ':' << 1000.0 * seconds;
+    }
+    ss << '}';
+    event.args.emplace_back("pass_ms", ss.str());
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  event.thread = getThreadIndex(std::this_thread::get_id());
+  events.push_back(std::move(event));
+}
+
+void PassProfiler::addFunction(Name func,
+                               std::thread::id thread,
+                               Clock::time_point start,
+                               Clock::time_point end) {
+  std::lock_guard<std::mutex> lock(mutex);
+  events.push_back(
+    Event{func.str, "function", getThreadIndex(thread), start, end, {}});
+}
+
+size_t PassProfiler::getThreadIndex(std::thread::id thread) {
+  return threadIndexes.emplace(thread, threadIndexes.size()).first->second;
+}
+
+void PassProfiler::write(std::ostream& o) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto toMicroseconds = [&](Clock::time_point time) {
+    return std::chrono::duration<double, std::micro>(time - origin).count();
+  };
+  o << std::fixed << std::setprecision(3);
+  o << "{\"traceEvents\":[\n";
+  for (size_t i = 0; i < threadIndexes.size(); i++) {
+    if (i > 0) {
+      o << ",\n";
+    }
+    o << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i
+      << ",\"args\":{\"name\":\"";
+    if (i == 0) {
+      o << "main";
+    } else {
+      o << "worker " << i;
+    }
+    o << "\"}}";
+  }
+  for (auto& event : events) {
+    o << ",\n{\"name\":";
+    writeJSONString(o, event.name);
+    o << ",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"ts\":"
+      << toMicroseconds(event.start) << ",\"dur\":"
+      << toMicroseconds(event.end) - toMicroseconds(event.start)
+      << ",\"pid\":0,\"tid\":" << event.thread;
+    if (!event.args.empty()) {
+      o << ",\"args\":{";
+      for (size_t i = 0; i < event.args.size(); i++) {
+        if (i > 0) {
+          o << ',';
+        }
+        writeJSONString(o, event.args[i].first);
+        o << ':' << event.args[i].second;
+      }
+      o << '}';
+    }
+    o << '}';
+  }
+  o << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void PassProfiler::write(const std::string& filename) {
+  Output output(filename, Flags::Text);
+  write(output.getStream());
+}
+
+} // namespace wasm
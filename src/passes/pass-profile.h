@@ -0,0 +1,114 @@
+/*
+ * Copyright 2022 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef wasm_passes_pass_profile_h
+#define wasm_passes_pass_profile_h
+
+#include <chrono>
+#include <ctime>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "wasm.h"
+
+//
+// Records how long passes take and how much memory they allocate while the
+// PassRunner runs them in its normal (parallel) mode. The results are written
+// in the Chrome trace event format, which chrome://tracing and Perfetto can
+// display.
+//
+// Each pass that runs on the whole module becomes an event with its wall time,
+// the CPU time of the process, the bytes allocated in arenas and, for passes
+// that are not nested, the binary size of the module before and after. A stack
+// of function-parallel passes becomes a single event, as the passes in it are
+// interleaved, with the time spent in each of its passes summed over all the
+// threads, plus an event for each function it ran on, on the thread that ran
+// it.
+//
+
+namespace wasm {
+
+class PassProfiler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // The state of the things we measure at some point in time.
+  struct Sample {
+    Clock::time_point time;
+    std::clock_t cpu;
+    size_t arenaBytes;
+    // The binary size of the module, if we measured it.
+    std::optional<size_t> size;
+  };
+
+  PassProfiler();
+
+  // Returns the current state, without the module size, which is slow to
+  // measure. Callers that want the size measure it separately, outside of the
+  // time between their samples.
+  Sample sample();
+
+  // Returns the size of the module in the binary format. This writes out the
+  // whole module, without changing it, so the size of DWARF sections is that
+  // of their current contents.
+  static size_t getSize(Module& wasm);
+
+  // Records that a pass, or a stack of function-parallel passes, ran between
+  // two samples. For a stack, |passTimes| has the time spent in each pass of
+  // it, summed over all the functions.
+  void addPass(const std::string& name,
+               bool nested,
+               const Sample& before,
+               const Sample& after,
+               const std::vector<std::pair<Name, double>>& passTimes = {});
+
+  // Records that a stack of function-parallel passes ran on a function.
+  void addFunction(Name func,
+                   std::thread::id thread,
+                   Clock::time_point start,
+                   Clock::time_point end);
+
+  void write(std::ostream& o);
+  void write(const std::string& filename);
+
+private:
+  struct Event {
+    std::string name;
+    const char* category;
+    size_t thread;
+    Clock::time_point start;
+    Clock::time_point end;
+    // Pairs of names and JSON values.
+    std::vector<std::pair<std::string, std::string>> args;
+  };
+
+  std::mutex mutex;
+  Clock::time_point origin;
+  std::unordered_map<std::thread::id, size_t> threadIndexes;
+  std::vector<Event> events;
+
+  // Returns a small number for a thread. Must be called with the mutex held.
+  size_t getThreadIndex(std::thread::id thread);
+};
+
+} // namespace wasm
+
+#endif // wasm_passes_pass_profile_h
@@ -15,6 +15,7 @@
  */
 
 #include <chrono>
+#include <numeric>
 #include <sstream>
 
 #ifdef __linux__
@@ -23,7 +24,10 @@
 
 #include "ir/hashed.h"
 #include "ir/module-utils.h"
+#include "ir/utils.h"
 #include "pass.h"
+#include "passes/pass-cache.h"
+#include "passes/pass-profile.h"
 #include "passes/passes.h"
 #include "support/colors.h"
 #include "wasm-debug.h"
@@ -111,6 +115,9 @@ void PassRegistry::registerPasses() {
                createCodePushingPass);
   registerPass(
     "code-folding", "fold code, merging duplicates", createCodeFoldingPass);
+  registerPass("compact-arena",
+               "free the memory of IR nodes that are no longer used",
+               createCompactArenaPass);
   registerPass("const-hoisting",
                "hoist repeated constants to a local",
                createConstHoistingPass);
@@ -336,6 +343,12 @@ void PassRegistry::registerPasses() {
   registerPass("reorder-functions",
                "sorts functions by access frequency",
                createReorderFunctionsPass);
+  registerPass("reorder-functions-profile",
+               "sorts functions by a wasm-split profile, putting the code "
+               "that runs first or most at the start (checks the profile "
+               "is of the file in the reorder-functions-profile-module pass "
+               "arg, if set, as wasm-opt does)",
+               createReorderFunctionsByProfilePass);
   registerPass("reorder-locals",
                "sorts locals by access frequency",
                createReorderLocalsPass);
@@ -702,36 +715,46 @@ void PassRunner::run() {
     // non-debug normal mode, run them in an optimal manner - for locality it is
     // better to run as many passes as possible on a single function before
     // moving to the next
+    auto* profiler = options.profiler.get();
+    // When profiling the main passes we measure the size of the module after
+    // each pass, which is also its size before the next one.
+    std::optional<size_t> lastSize;
+    // Measuring the size is slow, so it must happen outside of the time
+    // between the samples before and after a pass: first measure the size,
+    // then sample, run the pass, sample, and only then measure the size again.
+    auto sample = [&](bool before) {
+      if (isNested) {
+        return profiler->sample();
+      }
+      if (before) {
+        if (!lastSize) {
+          lastSize = PassProfiler::getSize(*wasm);
+        }
+        auto ret = profiler->sample();
+        ret.size = lastSize;
+        return ret;
+      }
+      auto ret = profiler->sample();
+      ret.size = lastSize = PassProfiler::getSize(*wasm);
+      return ret;
+    };
     std::vector<Pass*> stack;
     auto flush = [&]() {
       if (stack.size() > 0) {
         // run the stack of passes on all the functions, in parallel
-        size_t num = ThreadPool::get()->size();
-        std::vector<std::function<ThreadWorkState()>> doWorkers;
-        std::atomic<size_t> nextFunction;
-        nextFunction.store(0);
-        size_t numFunctions = wasm->functions.size();
-        for (size_t i = 0; i < num; i++) {
-          doWorkers.push_back([&]() {
-            auto index = nextFunction.fetch_add(1);
-            // get the next task, if there is one
-            if (index >= numFunctions) {
-              return ThreadWorkState::Finished; // nothing left
-            }
-            Function* func = this->wasm->functions[index].get();
-            if (!func->imported()) {
-              // do the current task: run all passes on this function
-              for (auto* pass : stack) {
-                runPassOnFunction(pass, func);
-              }
-            }
-            if (index + 1 == numFunctions) {
-              return ThreadWorkState::Finished; // we did the last one
-            }
-            return ThreadWorkState::More;
-          });
+        if (profiler) {
+          auto before = sample(true);
+          std::vector<std::pair<Name, double>> passTimes;
+          runStackInParallel(stack, &passTimes);
+          auto after = sample(false);
+          std::string name;
+          for (auto* pass : stack) {
+            name += (name.empty() ? "" : ", ") + pass->name;
+          }
+          profiler->addPass(name, isNested, before, after, passTimes);
+        } else {
+          runStackInParallel(stack);
         }
-        ThreadPool::get()->work(doWorkers);
       }
       stack.clear();
     };
@@ -740,13 +763,208 @@ void PassRunner::run() {
         stack.push_back(pass.get());
       } else {
         flush();
-        runPass(pass.get());
+        if (profiler) {
+          auto before = sample(true);
+          runPass(pass.get());
+          auto after = sample(false);
+          profiler->addPass(pass->name, isNested, before, after);
+        } else {
+          runPass(pass.get());
+        }
       }
     }
     flush();
   }
 }
 
+// Runs work on items [0, numItems) using the thread pool, handing out the items
+// in order. The work receives the item and the index of the thread running it.
+static void doInParallel(size_t numItems,
+                         std::function<void(size_t, size_t)> work) {
+  if (numItems == 0) {
+    return;
+  }
+  size_t num = ThreadPool::get()->size();
+  std::vector<std::function<ThreadWorkState()>> doWorkers;
+  std::atomic<size_t> nextItem;
+  nextItem.store(0);
+  for (size_t i = 0; i < num; i++) {
+    doWorkers.push_back([&, i]() {
+      auto index = nextItem.fetch_add(1);
+      // get the next task, if there is one
+      if (index >= numItems) {
+        return ThreadWorkState::Finished; // nothing left
+      }
+      work(index, i);
+      if (index + 1 == numItems) {
+        return ThreadWorkState::Finished; // we did the last one
+      }
+      return ThreadWorkState::More;
+    });
+  }
+  ThreadPool::get()->work(doWorkers);
+}
+
+void PassRunner::runStackInParallel(
+  const std::vector<Pass*>& stack,
+  std::vector<std::pair<Name, double>>* passTimes) {
+  std::vector<Function*> funcs;
+  for (auto& func : wasm->functions) {
+    if (!func->imported()) {
+      funcs.push_back(func.get());
+    }
+  }
+
+  size_t num = ThreadPool::get()->size();
+  if (num > 1) {
+    // Start with the most expensive functions. Otherwise a single huge function
+    // that appears late in the module can keep one thread busy long after all
+    // the others ran out of work. We estimate the cost using the size of the
+    // body, which we measure in parallel as well.
+    std::vector<Index> sizes(funcs.size());
+    doInParallel(funcs.size(), [&](size_t index, size_t) {
+      sizes[index] = Measurer::measure(funcs[index]->body);
+    });
+    std::vector<Index> order(funcs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](Index a, Index b) {
+      return sizes[a] > sizes[b];
+    });
+    std::vector<Function*> sorted;
+    sorted.reserve(funcs.size());
+    for (auto index : order) {
+      sorted.push_back(funcs[index]);
+    }
+    funcs.swap(sorted);
+  }
+
+  bool threadStats = getPassThreadStats();
+  using Clock = std::chrono::steady_clock;
+  std::vector<std::chrono::duration<double>> busy(num);
+  // When profiling, each worker notes the time it spent in each pass and on
+  // each function, which we gather at the end.
+  struct FunctionTime {
+    Function* func;
+    std::thread::id thread;
+    Clock::time_point start;
+    Clock::time_point end;
+  };
+  std::vector<std::vector<std::chrono::duration<double>>> workerPassTimes;
+  std::vector<std::vector<FunctionTime>> workerFunctionTimes;
+  if (passTimes) {
+    workerPassTimes.resize(
+      num, std::vector<std::chrono::duration<double>>(stack.size()));
+    workerFunctionTimes.resize(num);
+  }
+  // The cache is only used for the main passes, as nested runners work on parts
+  // of the module or on modules in intermediate states.
+  auto* cache = isNested ? nullptr : options.cache.get();
+  std::optional<PassCache::Stack> cacheStack;
+  std::vector<PassCache::Entry> cacheEntries;
+  if (cache) {
+    cacheStack = PassCache::getStack(stack, options, *wasm);
+    cacheEntries.resize(funcs.size());
+  }
+
+  auto start = Clock::now();
+  doInParallel(funcs.size(), [&](size_t index, size_t thread) {
+    Clock::time_point before;
+    if (threadStats || passTimes) {
+      before = Clock::now();
+    }
+    if (cacheStack &&
+        cache->load(*wasm, funcs[index], *cacheStack, cacheEntries[index])) {
+      if (threadStats) {
+        busy[thread] += Clock::now() - before;
+      }
+      return;
+    }
+    // do the current task: run all passes on this function
+    if (passTimes) {
+      auto passStart = before;
+      for (size_t i = 0; i < stack.size(); i++) {
+        runPassOnFunction(stack[i], funcs[index]);
+        auto passEnd = Clock::now();
+        workerPassTimes[thread][i] += passEnd - passStart;
+        passStart = passEnd;
+      }
+      workerFunctionTimes[thread].push_back(
+        {funcs[index], std::this_thread::get_id(), before, passStart});
+    } else {
+      for (auto* pass : stack) {
+        runPassOnFunction(pass, funcs[index]);
+      }
+    }
+    if (threadStats) {
+      busy[thread] += Clock::now() - before;
+    }
+  });
+
+  if (cacheStack) {
+    // If the passes changed more than the functions they ran on, the results
+    // depend on that, and we cannot store them.
+    if (PassCache::hashContext(*wasm) != cacheStack->context) {
+      size_t numMisses = 0;
+      for (auto& entry : cacheEntries) {
+        numMisses += entry.missed;
+      }
+      cache->discard(numMisses);
+    } else {
+      doInParallel(funcs.size(), [&](size_t index, size_t) {
+        if (cacheEntries[index].missed) {
+          cache->store(*wasm, funcs[index], *cacheStack, cacheEntries[index]);
+        }
+      });
+    }
+  }
+
+  if (passTimes) {
+    for (size_t i = 0; i < stack.size(); i++) {
+      std::chrono::duration<double> total(0);
+      for (auto& times : workerPassTimes) {
+        total += times[i];
+      }
+      passTimes->emplace_back(stack[i]->name, total.count());
+    }
+    auto* profiler = options.profiler.get();
+    for (auto& times : workerFunctionTimes) {
+      for (auto& time : times) {
+        profiler->addFunction(
+          time.func->name, time.thread, time.start, time.end);
+      }
+    }
+  }
+
+  if (threadStats) {
+    std::chrono::duration<double> total = Clock::now() - start;
+    // Passes that are created internally, like those of nested runners, may
+    // have no name, so we list only the named ones.
+    std::string names;
+    for (auto* pass : stack) {
+      if (!pass->name.empty()) {
+        names += (names.empty() ? "" : ", ") + pass->name;
+      }
+    }
+    std::cerr << "[PassRunner] ran " << stack.size() << " passes";
+    if (!names.empty()) {
+      std::cerr << " (" << names << ")";
+    }
+    std::cerr << " on " << funcs.size() << " functions in " << total.count()
+              << " seconds." << std::endl;
+    for (size_t i = 0; i < num; i++) {
+      std::cerr << "[PassRunner]   thread " << i << ": busy "
+                << busy[i].count() << " seconds, idle "
+                << (total - busy[i]).count() << " seconds." << std::endl;
+    }
+    auto typeStats = getTypeStoreStats();
+    std::cerr << "[PassRunner]   waits on type stores so far: types "
+              << typeStats.typeContention << ", heap types "
+              << typeStats.heapTypeContention << ", rec groups "
+              << typeStats.recGroupContention << ", signatures "
+              << typeStats.signatureContention << std::endl;
+  }
+}
+
 void PassRunner::runOnFunction(Function* func) {
   if (options.debug) {
     std::cerr << "[PassRunner] running passes on function " << func->name
@@ -757,6 +975,18 @@ void PassRunner::runOnFunction(Function* func) {
   }
 }
 
+void PassRunner::runOnFunctions(const std::vector<Function*>& funcs) {
+  if (options.debug) {
+    std::cerr << "[PassRunner] running passes on " << funcs.size()
+              << " functions" << std::endl;
+  }
+  doInParallel(funcs.size(), [&](size_t index, size_t) {
+    for (auto& pass : passes) {
+      runPassOnFunction(pass.get(), funcs[index]);
+    }
+  });
+}
+
 void PassRunner::doAdd(std::unique_ptr<Pass> pass) {
   if (pass->invalidatesDWARF() && shouldPreserveDWARF()) {
     std::cerr << "warning: running pass '" << pass->name
@@ -911,6 +1141,12 @@ int PassRunner::getPassDebug() {
   return passDebug;
 }
 
+bool PassRunner::getPassThreadStats() {
+  static const bool passThreadStats =
+    getenv("BINARYEN_PASS_THREAD_STATS") != nullptr;
+  return passThreadStats;
+}
+
 bool PassRunner::passRemovesDebugInfo(const std::string& name) {
   return name == "strip" || name == "strip-debug" || name == "strip-dwarf";
 }
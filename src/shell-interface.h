@@ -29,6 +29,16 @@
 #include "wasm-interpreter.h"
 #include "wasm.h"
 
+#include <cstdint>
+
+// Reserving the address space of a 32-bit memory only makes sense when it is a
+// small part of that of the host.
+#if !defined(WIN32) && !defined(_WIN32) && UINTPTR_MAX > 0xffffffffu
+#define RESERVE_SHELL_MEMORY 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 namespace wasm {
 
 // An exception emitted when exit() is called.
@@ -50,9 +60,27 @@ struct ShellExternalInterface : ModuleRunner::ExternalInterface {
   //
   // The allocated memory tries to have the same alignment as the memory being
   // simulated.
+  //
+  // On 64-bit hosts, we reserve address space for the largest 32-bit memory up
+  // front, and make pages accessible as the memory grows, so that growing
+  // never copies the contents. The pages past the end stay inaccessible, so an
+  // access that escapes the interpreter's bounds checks faults rather than
+  // corrupting other data. Otherwise, or if reserving fails, the contents are
+  // in a vector.
   class Memory {
     // Use char because it doesn't run afoul of aliasing rules.
-    std::vector<char> memory;
+    char* data = nullptr;
+    // The number of bytes that can be accessed.
+    size_t size = 0;
+    // The number of bytes of address space reserved at |data|, or 0 if we use
+    // |fallback|.
+    size_t reserved = 0;
+    // The number of bytes at |data| in pages that we made accessible, which is
+    // |size| rounded up to a whole page.
+    size_t committed = 0;
+    size_t pageSize = 0;
+    std::vector<char> fallback;
+
     template<typename T> static bool aligned(const char* address) {
       static_assert(!(sizeof(T) & (sizeof(T) - 1)), "must be a power of 2");
       return 0 == (reinterpret_cast<uintptr_t>(address) & (sizeof(T) - 1));
@@ -60,8 +88,77 @@ struct ShellExternalInterface : ModuleRunner::ExternalInterface {
     Memory(Memory&) = delete;
     Memory& operator=(const Memory&) = delete;
 
+#ifdef RESERVE_SHELL_MEMORY
+    static const size_t reservationSize = size_t(1) << 32;
+
+    void reserve() {
+      long page = sysconf(_SC_PAGESIZE);
+      if (page <= 0 || reservationSize % page != 0) {
+        return;
+      }
+      void* ptr = mmap(nullptr,
+                       reservationSize,
+                       PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                       -1,
+                       0);
+      if (ptr == MAP_FAILED) {
+        return;
+      }
+      data = static_cast<char*>(ptr);
+      reserved = reservationSize;
+      pageSize = page;
+    }
+
+    // Makes the pages that hold the first |newSize| bytes of the reservation
+    // accessible, and the rest inaccessible. Returns false if that fails.
+    bool commit(size_t newSize) {
+      if (newSize > reserved) {
+        return false;
+      }
+      size_t newCommitted = (newSize + pageSize - 1) / pageSize * pageSize;
+      if (newCommitted > committed) {
+        if (mprotect(data + committed,
+                     newCommitted - committed,
+                     PROT_READ | PROT_WRITE) != 0) {
+          return false;
+        }
+      } else if (newCommitted < committed) {
+        // Clear what we drop, as it must read as zeros if we grow again.
+        // Freeing the pages of a private anonymous mapping does that.
+        if (madvise(data + newCommitted,
+                    committed - newCommitted,
+                    MADV_DONTNEED) != 0 ||
+            mprotect(data + newCommitted,
+                     committed - newCommitted,
+                     PROT_NONE) != 0) {
+          return false;
+        }
+      }
+      committed = newCommitted;
+      // The part of the last page that we drop stays accessible, so clear it
+      // ourselves.
+      if (newSize < size) {
+        std::memset(data + newSize, 0, std::min(size, committed) - newSize);
+      }
+      return true;
+    }
+
+    void release() {
+      if (reserved) {
+        munmap(data, reserved);
+      }
+    }
+#else
+    void reserve() {}
+    bool commit(size_t newSize) { return false; }
+    void release() {}
+#endif
+
   public:
     Memory() = default;
+    ~Memory() { release(); }
+
     void resize(size_t newSize) {
       // Ensure the smallest allocation is large enough that most allocators
       // will provide page-aligned storage. This hopefully allows the
@@ -70,25 +167,46 @@ struct ShellExternalInterface : ModuleRunner::ExternalInterface {
       //
       // The code is optimistic this will work until WG21's p0035r0 happens.
       const size_t minSize = 1 << 12;
-      size_t oldSize = memory.size();
-      memory.resize(std::max(minSize, newSize));
+      size_t oldSize = size;
+      size_t allocatedSize = std::max(minSize, newSize);
+      if (!data) {
+        reserve();
+      }
+      if (reserved) {
+        if (allocatedSize == size || commit(allocatedSize)) {
+          size = allocatedSize;
+          if (newSize < oldSize && newSize < minSize) {
+            std::memset(&data[newSize], 0, minSize - newSize);
+          }
+          return;
+        }
+        // The reservation is too small, or we could not change which of its
+        // pages are accessible, so move to a vector.
+        fallback.assign(data, data + size);
+        release();
+        reserved = 0;
+        committed = 0;
+      }
+      fallback.resize(allocatedSize);
       if (newSize < oldSize && newSize < minSize) {
-        std::memset(&memory[newSize], 0, minSize - newSize);
+        std::memset(&fallback[newSize], 0, minSize - newSize);
       }
+      data = fallback.data();
+      size = allocatedSize;
     }
     template<typename T> void set(size_t address, T value) {
-      if (aligned<T>(&memory[address])) {
-        *reinterpret_cast<T*>(&memory[address]) = value;
+      if (aligned<T>(&data[address])) {
+        *reinterpret_cast<T*>(&data[address]) = value;
       } else {
-        std::memcpy(&memory[address], &value, sizeof(T));
+        std::memcpy(&data[address], &value, sizeof(T));
       }
     }
     template<typename T> T get(size_t address) {
-      if (aligned<T>(&memory[address])) {
-        return *reinterpret_cast<T*>(&memory[address]);
+      if (aligned<T>(&data[address])) {
+        return *reinterpret_cast<T*>(&data[address]);
       } else {
         T loaded;
-        std::memcpy(&loaded, &memory[address], sizeof(T));
+        std::memcpy(&loaded, &data[address], sizeof(T));
         return loaded;
       }
     }
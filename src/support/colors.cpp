@@ -21,11 +21,24 @@
 
 namespace {
 bool colors_enabled = true;
+
+// The index of the word in which a stream notes that colors are disabled in it.
+int disabledIndex() {
+  static const int index = std::ios_base::xalloc();
+  return index;
+}
 } // anonymous namespace
 
 void Colors::setEnabled(bool enabled) { colors_enabled = enabled; }
 bool Colors::isEnabled() { return colors_enabled; }
 
+void Colors::disableIn(std::ostream& stream) {
+  stream.iword(disabledIndex()) = 1;
+}
+bool Colors::isEnabledIn(std::ostream& stream) {
+  return colors_enabled && !stream.iword(disabledIndex());
+}
+
 #if defined(__linux__) || defined(__APPLE__)
 #include <unistd.h>
 
@@ -35,7 +48,7 @@ void Colors::outputColorCode(std::ostream& stream, const char* colorCode) {
            (isatty(STDOUT_FILENO) &&
             (!getenv("COLORS") || getenv("COLORS")[0] != '0')); // implicit
   }();
-  if (has_color && colors_enabled) {
+  if (has_color && isEnabledIn(stream)) {
     stream << colorCode;
   }
 }
@@ -51,7 +64,7 @@ void Colors::outputColorCode(std::ostream& stream, const WORD& colorCode) {
   }();
   static HANDLE hStdout = GetStdHandle(STD_OUTPUT_HANDLE);
   static HANDLE hStderr = GetStdHandle(STD_ERROR_HANDLE);
-  if (has_color && colors_enabled)
+  if (has_color && isEnabledIn(stream))
     SetConsoleTextAttribute(&stream == &std::cout ? hStdout : hStderr,
                             colorCode);
 }
@@ -24,6 +24,12 @@ namespace Colors {
 void setEnabled(bool enabled);
 bool isEnabled();
 
+// Disables colors in one stream, for text that is not shown as it is, like the
+// keys of a cache. Unlike setEnabled(), this does not affect what other threads
+// print.
+void disableIn(std::ostream& stream);
+bool isEnabledIn(std::ostream& stream);
+
 #if defined(__linux__) || defined(__APPLE__)
 void outputColorCode(std::ostream& stream, const char* colorCode);
 inline void normal(std::ostream& stream) { outputColorCode(stream, "\033[0m"); }
@@ -22,6 +22,13 @@
 #include <iostream>
 #include <limits>
 
+#if !defined(WIN32) && !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #define DEBUG_TYPE "file"
 
 std::vector<char> wasm::read_stdin() {
@@ -88,6 +95,43 @@ T wasm::read_file(const std::string& filename, Flags::BinaryOption binary) {
   return input;
 }
 
+wasm::MappedFile::MappedFile(const std::string& filename) {
+#if !defined(WIN32) && !defined(_WIN32)
+  if (filename != "-") {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      struct stat info;
+      // Only map regular files, whose size we know up front. Anything else,
+      // and any error, is left for the fallback below, which also reports
+      // errors.
+      if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0 &&
+          uint64_t(info.st_size) < std::numeric_limits<size_t>::max()) {
+        BYN_TRACE("Mapping '" << filename << "'...\n");
+        void* addr =
+          mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+          mapping = static_cast<const char*>(addr);
+          mappedSize = size_t(info.st_size);
+        }
+      }
+      close(fd);
+      if (mapping) {
+        return;
+      }
+    }
+  }
+#endif
+  buffer = read_file<std::vector<char>>(filename, Flags::Binary);
+}
+
+wasm::MappedFile::~MappedFile() {
+#if !defined(WIN32) && !defined(_WIN32)
+  if (mapping) {
+    munmap(const_cast<char*>(mapping), mappedSize);
+  }
+#endif
+}
+
 std::string wasm::read_possible_response_file(const std::string& input) {
   if (input.size() == 0 || input[0] != '@') {
     return input;
@@ -23,6 +23,7 @@
 
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -43,6 +44,31 @@ extern template std::string read_file<>(const std::string&,
 extern template std::vector<char> read_file<>(const std::string&,
                                               Flags::BinaryOption);
 
+// The contents of a binary file, mapped into memory read-only when the
+// platform supports it, so that they are not copied and pages that are not
+// used are never read. Falls back to reading the file into a buffer (e.g. for
+// stdin, pipes, empty files, or on Windows).
+class MappedFile {
+public:
+  MappedFile(const std::string& filename);
+  ~MappedFile();
+
+  const char* data() const { return mapping ? mapping : buffer.data(); }
+  size_t size() const { return mapping ? mappedSize : buffer.size(); }
+  std::string_view view() const { return {data(), size()}; }
+
+  // Whether the contents are mapped, as opposed to having been read.
+  bool isMapped() const { return mapping; }
+
+private:
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* mapping = nullptr;
+  size_t mappedSize = 0;
+  std::vector<char> buffer;
+};
+
 // Given a string which may be a response file (i.e., a filename starting
 // with "@"), if it is a response file read it and return that, or if it
 // is not a response file, return it as is.
@@ -0,0 +1,277 @@
+/*
+ * Copyright 2022 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// A set of small integers, like the indexes of locals, stored as bits. The
+// bits for the first N * 64 integers are stored inline, so that sets of them
+// do not allocate. Larger integers are kept in a sorted vector of the words
+// that have bits set, so that a few large integers, like the index of a local
+// in a function with many locals, take little memory. Unlike a std::set,
+// checking whether two sets intersect and merging sets take time proportional
+// to the number of words in use rather than elements.
+//
+
+#ifndef wasm_support_small_bitset_h
+#define wasm_support_small_bitset_h
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <vector>
+
+#include "bits.h"
+#include "index.h"
+
+namespace wasm {
+
+template<size_t N> class SmallBitSet {
+  static const size_t BitsPerWord = 64;
+
+  // The words for the first N * 64 integers.
+  std::array<uint64_t, N> fixed = {};
+
+  // A word after those, which has at least one bit set.
+  struct Word {
+    // The index of the word among all the words, counting the fixed ones.
+    size_t index;
+    uint64_t bits;
+
+    bool operator==(const Word& other) const {
+      return index == other.index && bits == other.bits;
+    }
+    bool operator<(size_t other) const { return index < other; }
+  };
+
+  // The words after the fixed ones that have bits set, sorted by index.
+  std::vector<Word> flexible;
+
+  // The number of words we iterate on: the fixed ones and then the flexible
+  // ones, with positions rather than indexes.
+  size_t numWords() const { return N + flexible.size(); }
+  uint64_t getWordAt(size_t pos) const {
+    return pos < N ? fixed[pos] : flexible[pos - N].bits;
+  }
+  size_t getIndexAt(size_t pos) const {
+    return pos < N ? pos : flexible[pos - N].index;
+  }
+
+  typename std::vector<Word>::iterator findWord(size_t index) {
+    return std::lower_bound(flexible.begin(), flexible.end(), index);
+  }
+
+  uint64_t getWord(size_t index) const {
+    if (index < N) {
+      return fixed[index];
+    }
+    auto iter = std::lower_bound(flexible.begin(), flexible.end(), index);
+    return iter != flexible.end() && iter->index == index ? iter->bits : 0;
+  }
+
+public:
+  using value_type = Index;
+  using key_type = Index;
+
+  SmallBitSet() {}
+  SmallBitSet(std::initializer_list<Index> init) {
+    for (auto x : init) {
+      insert(x);
+    }
+  }
+
+  void insert(Index x) {
+    size_t index = x / BitsPerWord;
+    uint64_t bit = uint64_t(1) << (x % BitsPerWord);
+    if (index < N) {
+      fixed[index] |= bit;
+      return;
+    }
+    auto iter = findWord(index);
+    if (iter != flexible.end() && iter->index == index) {
+      iter->bits |= bit;
+    } else {
+      flexible.insert(iter, Word{index, bit});
+    }
+  }
+
+  void erase(Index x) {
+    size_t index = x / BitsPerWord;
+    uint64_t bit = uint64_t(1) << (x % BitsPerWord);
+    if (index < N) {
+      fixed[index] &= ~bit;
+      return;
+    }
+    auto iter = findWord(index);
+    if (iter != flexible.end() && iter->index == index) {
+      iter->bits &= ~bit;
+      if (!iter->bits) {
+        flexible.erase(iter);
+      }
+    }
+  }
+
+  size_t count(Index x) const {
+    return (getWord(x / BitsPerWord) >> (x % BitsPerWord)) & 1;
+  }
+
+  size_t size() const {
+    size_t ret = 0;
+    for (auto word : fixed) {
+      ret += Bits::popCount(word);
+    }
+    for (auto& word : flexible) {
+      ret += Bits::popCount(word.bits);
+    }
+    return ret;
+  }
+
+  bool empty() const {
+    for (auto word : fixed) {
+      if (word) {
+        return false;
+      }
+    }
+    return flexible.empty();
+  }
+
+  void clear() {
+    fixed.fill(0);
+    flexible.clear();
+  }
+
+  // Returns whether some integer is in both sets.
+  bool intersects(const SmallBitSet<N>& other) const {
+    for (size_t i = 0; i < N; i++) {
+      if (fixed[i] & other.fixed[i]) {
+        return true;
+      }
+    }
+    auto a = flexible.begin();
+    auto b = other.flexible.begin();
+    while (a != flexible.end() && b != other.flexible.end()) {
+      if (a->index < b->index) {
+        a++;
+      } else if (b->index < a->index) {
+        b++;
+      } else if (a->bits & b->bits) {
+        return true;
+      } else {
+        a++;
+        b++;
+      }
+    }
+    return false;
+  }
+
+  // Adds all the integers in another set.
+  SmallBitSet<N>& operator|=(const SmallBitSet<N>& other) {
+    for (size_t i = 0; i < N; i++) {
+      fixed[i] |= other.fixed[i];
+    }
+    if (other.flexible.empty()) {
+      return *this;
+    }
+    std::vector<Word> merged;
+    merged.reserve(flexible.size() + other.flexible.size());
+    auto a = flexible.begin();
+    auto b = other.flexible.begin();
+    while (a != flexible.end() || b != other.flexible.end()) {
+      if (b == other.flexible.end() ||
+          (a != flexible.end() && a->index < b->index)) {
+        merged.push_back(*a++);
+      } else if (a == flexible.end() || b->index < a->index) {
+        merged.push_back(*b++);
+      } else {
+        merged.push_back(Word{a->index, a->bits | b->bits});
+        a++;
+        b++;
+      }
+    }
+    flexible.swap(merged);
+    return *this;
+  }
+
+  bool operator==(const SmallBitSet<N>& other) const {
+    return fixed == other.fixed && flexible == other.flexible;
+  }
+
+  bool operator!=(const SmallBitSet<N>& other) const {
+    return !(*this == other);
+  }
+
+  // Iteration, over the integers in increasing order.
+
+  struct Iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = long;
+    using value_type = Index;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    const SmallBitSet<N>* parent;
+    // The position of the current word, or the number of words at the end.
+    size_t pos;
+    // The bits of the current word that we have not reached yet.
+    uint64_t bits = 0;
+    // The current integer.
+    Index index = 0;
+
+    Iterator(const SmallBitSet<N>* parent, size_t pos)
+      : parent(parent), pos(pos) {
+      if (pos < parent->numWords()) {
+        bits = parent->getWordAt(pos);
+        skipToSetBit();
+      }
+    }
+
+    // Moves forward from the current bits to the first integer in the set.
+    void skipToSetBit() {
+      while (!bits) {
+        if (++pos == parent->numWords()) {
+          index = 0;
+          return;
+        }
+        bits = parent->getWordAt(pos);
+      }
+      index = parent->getIndexAt(pos) * BitsPerWord +
+              Bits::countTrailingZeroes(bits);
+    }
+
+    bool operator==(const Iterator& other) const {
+      return parent == other.parent && pos == other.pos && bits == other.bits;
+    }
+
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    Iterator& operator++() {
+      // Clear the lowest set bit, which is the current integer.
+      bits &= bits - 1;
+      skipToSetBit();
+      return *this;
+    }
+
+    const value_type& operator*() const { return index; }
+  };
+
+  Iterator begin() const { return Iterator(this, 0); }
+  Iterator end() const { return Iterator(this, numWords()); }
+
+  using iterator = Iterator;
+  using const_iterator = Iterator;
+};
+
+} // namespace wasm
+
+#endif // wasm_support_small_bitset_h
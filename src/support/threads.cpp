@@ -45,83 +45,78 @@ static std::mutex debug;
 
 namespace wasm {
 
+// The tasks of one call to work().
+struct ThreadBatch {
+  // The number of tasks that have not finished yet.
+  std::atomic<size_t> remaining;
+  // The number of tasks that no thread has taken yet.
+  std::atomic<size_t> queued;
+};
+
+struct ThreadTask {
+  std::function<ThreadWorkState()> doWork;
+  ThreadBatch* batch;
+};
+
+// The helper thread we are running on, if any.
+static thread_local Thread* currentThread = nullptr;
+
 // Thread
 
 Thread::Thread(ThreadPool* parent) : parent(parent) {
-  assert(!parent->isRunning());
   thread = make_unique<std::thread>(mainLoop, this);
 }
 
-Thread::~Thread() {
-  {
-    std::lock_guard<std::mutex> lock(mutex);
-    // notify the thread that it can exit
-    done = true;
-    condition.notify_one();
-  }
-  thread->join();
-}
-
-void Thread::work(std::function<ThreadWorkState()> doWork_) {
-  // TODO: fancy work stealing
-  DEBUG_THREAD("send work to thread\n");
-  {
-    std::lock_guard<std::mutex> lock(mutex);
-    // notify the thread that it can do some work
-    doWork = doWork_;
-    condition.notify_one();
-    DEBUG_THREAD("work sent\n");
-  }
-}
+Thread::~Thread() { thread->join(); }
 
 void Thread::mainLoop(void* self_) {
   auto* self = static_cast<Thread*>(self_);
+  auto* parent = self->parent;
+  currentThread = self;
   while (1) {
     DEBUG_THREAD("checking for work\n");
-    {
-      std::unique_lock<std::mutex> lock(self->mutex);
-      if (self->doWork) {
-        DEBUG_THREAD("doing work\n");
-        // run tasks until they are all done
-        while (self->doWork() == ThreadWorkState::More) {
-        }
-        self->doWork = nullptr;
-      } else if (self->done) {
-        DEBUG_THREAD("done\n");
-        return;
-      }
+    if (auto* task = parent->takeTask(self)) {
+      DEBUG_THREAD("doing work\n");
+      parent->runTask(task);
+      continue;
     }
-    self->parent->notifyThreadIsReady();
-    {
-      std::unique_lock<std::mutex> lock(self->mutex);
-      if (!self->done && !self->doWork) {
-        DEBUG_THREAD("thread waiting\n");
-        self->condition.wait(lock);
-      }
+    std::unique_lock<std::mutex> lock(parent->threadMutex);
+    if (parent->done && parent->queued.load() == 0) {
+      DEBUG_THREAD("done\n");
+      return;
     }
+    DEBUG_THREAD("thread waiting\n");
+    parent->condition.wait(lock, [&]() {
+      return parent->done || parent->queued.load() > 0;
+    });
   }
 }
 
 // ThreadPool
 
-// Global threadPool state. We have a singleton pool, which can only be
-// used from one place at a time.
+// Global threadPool state. We have a singleton pool.
 
 static std::unique_ptr<ThreadPool> pool;
 
 std::mutex ThreadPool::creationMutex;
-std::mutex ThreadPool::workMutex;
-std::mutex ThreadPool::threadMutex;
+
+ThreadPool::ThreadPool() { queued.store(0); }
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(threadMutex);
+    // notify the threads that they can exit
+    done = true;
+  }
+  condition.notify_all();
+  threads.clear();
+}
 
 void ThreadPool::initialize(size_t num) {
   if (num == 1) {
     return; // no multiple cores, don't create threads
   }
   DEBUG_POOL("initialize()\n");
-  std::unique_lock<std::mutex> lock(threadMutex);
-  // initial state before first resetThreadsAreReady()
-  ready.store(threads.size());
-  resetThreadsAreReady();
   for (size_t i = 0; i < num; i++) {
     try {
       threads.emplace_back(make_unique<Thread>(this));
@@ -129,12 +124,16 @@ void ThreadPool::initialize(size_t num) {
       // failed to create a thread - don't use multithreading, as if num cores
       // == 1
       DEBUG_POOL("could not create thread\n");
+      {
+        std::lock_guard<std::mutex> lock(threadMutex);
+        done = true;
+      }
+      condition.notify_all();
       threads.clear();
+      done = false;
       return;
     }
   }
-  DEBUG_POOL("initialize() waiting\n");
-  condition.wait(lock, [this]() { return areThreadsReady(); });
   DEBUG_POOL("initialize() is done\n");
 }
 
@@ -168,7 +167,7 @@ ThreadPool* ThreadPool::get() {
 void ThreadPool::work(
   std::vector<std::function<ThreadWorkState()>>& doWorkers) {
   size_t num = threads.size();
-  // If no multiple cores, or on a side thread, do not use worker threads
+  // If no multiple cores, do not use worker threads
   if (num == 0) {
     // just run sequentially
     DEBUG_POOL("work() sequentially\n");
@@ -178,52 +177,130 @@ void ThreadPool::work(
     return;
   }
   // run in parallel on threads
-  // TODO: fancy work stealing
   DEBUG_POOL("work() on threads\n");
-  // lock globally on doing work in the pool - the threadPool can only be used
-  // from one thread at a time, all others must wait patiently
-  std::lock_guard<std::mutex> poolLock(workMutex);
   assert(doWorkers.size() == num);
-  assert(!running);
-  DEBUG_POOL("running = true\n");
-  running = true;
-  std::unique_lock<std::mutex> lock(threadMutex);
-  resetThreadsAreReady();
+  ThreadBatch batch;
+  batch.remaining.store(num);
+  batch.queued.store(num);
+  std::vector<ThreadTask> tasks(num);
   for (size_t i = 0; i < num; i++) {
-    threads[i]->work(doWorkers[i]);
+    tasks[i].doWork = doWorkers[i];
+    tasks[i].batch = &batch;
+  }
+  // Work queued from a helper thread goes on that thread's own deque, where
+  // the thread will find it first, and other threads can steal it.
+  auto* self = currentThread;
+  if (self && self->parent != this) {
+    self = nullptr;
+  }
+  if (self) {
+    std::lock_guard<std::mutex> lock(self->mutex);
+    for (auto& task : tasks) {
+      self->tasks.push_back(&task);
+    }
+  } else {
+    std::lock_guard<std::mutex> lock(threadMutex);
+    for (auto& task : tasks) {
+      injected.push_back(&task);
+    }
+  }
+  queued.fetch_add(num);
+  notifyAll();
+  // Help out until our tasks are done. We only run our own tasks: others may
+  // come from unrelated work, which should not run on our stack, where the
+  // caller may hold locks. Our tasks can always make progress, as each of them
+  // is either queued, so we can run it, or running on another thread.
+  DEBUG_POOL("main thread helping\n");
+  while (batch.remaining.load() > 0) {
+    if (auto* task = takeTask(self, &batch)) {
+      runTask(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(threadMutex);
+    condition.wait(lock, [&]() {
+      return batch.remaining.load() == 0 || batch.queued.load() > 0;
+    });
   }
-  DEBUG_POOL("main thread waiting\n");
-  condition.wait(lock, [this]() { return areThreadsReady(); });
-  DEBUG_POOL("main thread done waiting\n");
-  DEBUG_POOL("running = false\n");
-  running = false;
   DEBUG_POOL("work() is done\n");
 }
 
 size_t ThreadPool::size() { return std::max(size_t(1), threads.size()); }
 
-bool ThreadPool::isRunning() {
-  DEBUG_POOL("check if running\n");
-  return running;
+// Remove and return the newest or the oldest task in a deque that is in the
+// given batch, or in any batch if it is null.
+static ThreadTask* takeNewest(std::deque<ThreadTask*>& tasks,
+                              ThreadBatch* batch) {
+  for (auto iter = tasks.rbegin(); iter != tasks.rend(); ++iter) {
+    auto* task = *iter;
+    if (!batch || task->batch == batch) {
+      tasks.erase(std::next(iter).base());
+      return task;
+    }
+  }
+  return nullptr;
 }
 
-void ThreadPool::notifyThreadIsReady() {
-  DEBUG_POOL("notify thread is ready\n";)
-  std::lock_guard<std::mutex> lock(threadMutex);
-  ready.fetch_add(1);
-  condition.notify_one();
+static ThreadTask* takeOldest(std::deque<ThreadTask*>& tasks,
+                              ThreadBatch* batch) {
+  for (auto iter = tasks.begin(); iter != tasks.end(); ++iter) {
+    auto* task = *iter;
+    if (!batch || task->batch == batch) {
+      tasks.erase(iter);
+      return task;
+    }
+  }
+  return nullptr;
 }
 
-void ThreadPool::resetThreadsAreReady() {
-  DEBUG_POOL("reset threads are ready\n";)
-  auto old = ready.exchange(0);
-  WASM_UNUSED(old);
-  assert(old == threads.size());
+ThreadTask* ThreadPool::takeTask(Thread* self, ThreadBatch* batch) {
+  if (queued.load() == 0 || (batch && batch->queued.load() == 0)) {
+    return nullptr;
+  }
+  ThreadTask* task = nullptr;
+  // First, look at our own most recent work.
+  if (self) {
+    std::lock_guard<std::mutex> lock(self->mutex);
+    task = takeNewest(self->tasks, batch);
+  }
+  // Then at work from outside the pool.
+  if (!task) {
+    std::lock_guard<std::mutex> lock(threadMutex);
+    task = takeOldest(injected, batch);
+  }
+  // Finally, steal the oldest work of another thread.
+  for (size_t i = 0; !task && i < threads.size(); i++) {
+    auto* other = threads[i].get();
+    if (other == self) {
+      continue;
+    }
+    std::lock_guard<std::mutex> lock(other->mutex);
+    task = takeOldest(other->tasks, batch);
+    if (task) {
+      DEBUG_THREAD("stealing\n");
+    }
+  }
+  if (task) {
+    queued.fetch_sub(1);
+    task->batch->queued.fetch_sub(1);
+  }
+  return task;
+}
+
+void ThreadPool::runTask(ThreadTask* task) {
+  // run the task until it is done
+  while (task->doWork() == ThreadWorkState::More) {
+  }
+  // Note that the task may be freed as soon as we decrement the counter.
+  if (task->batch->remaining.fetch_sub(1) == 1) {
+    notifyAll();
+  }
 }
 
-bool ThreadPool::areThreadsReady() {
-  DEBUG_POOL("are threads ready?\n";)
-  return ready.load() == threads.size();
+void ThreadPool::notifyAll() {
+  // Take the lock so that a thread cannot miss the notification between
+  // checking its condition and waiting.
+  { std::lock_guard<std::mutex> lock(threadMutex); }
+  condition.notify_all();
 }
 
 } // namespace wasm
@@ -23,6 +23,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -39,9 +40,18 @@ enum class ThreadWorkState { More, Finished };
 
 class ThreadPool;
 
+// A task that a thread runs, and the tasks of one call to ThreadPool::work.
+struct ThreadTask;
+struct ThreadBatch;
+
 //
 // A helper thread.
 //
+// Each helper thread has a deque of tasks. Tasks that work on this thread
+// queues (that is, nested parallel work) are added to the back, and the thread
+// runs tasks from the back of its own deque first. When that is empty, it
+// steals from the front of the deques of other threads.
+//
 // You can only create and destroy these on the main thread.
 //
 
@@ -49,69 +59,75 @@ class Thread {
   ThreadPool* parent;
   std::unique_ptr<std::thread> thread;
   std::mutex mutex;
-  std::condition_variable condition;
-  bool done = false;
-  std::function<ThreadWorkState()> doWork = nullptr;
+  std::deque<ThreadTask*> tasks;
 
 public:
   Thread(ThreadPool* parent);
   ~Thread();
 
-  // Start to do work, calling doWork() until
-  // it returns false.
-  void work(std::function<ThreadWorkState()> doWork);
-
 private:
   static void mainLoop(void* self);
+
+  friend class ThreadPool;
 };
 
 //
 // A pool of helper threads.
 //
-// There is only one, to avoid recursive pools using too many cores.
+// There is only one, to avoid recursive pools using too many cores. Work can be
+// sent to the pool from any thread, including from inside work that the pool
+// is running: a thread that waits for its work to finish runs its own queued
+// tasks in the meantime, so nested parallelism does not deadlock, and idle
+// threads help with both the outer and the inner work.
 //
 
 class ThreadPool {
   std::vector<std::unique_ptr<Thread>> threads;
-  bool running = false;
-  std::condition_variable condition;
-  std::atomic<size_t> ready;
+  // Tasks sent to the pool from threads that are not in the pool.
+  std::deque<ThreadTask*> injected;
+  // The number of tasks in all the deques.
+  std::atomic<size_t> queued;
+  bool done = false;
 
   // A mutex for creating the pool safely
   static std::mutex creationMutex;
-  // A mutex for work() so that the pool can only work on one
-  // thing at a time
-  static std::mutex workMutex;
-  // A mutex for communication with the worker threads
-  static std::mutex threadMutex;
+
+  // A mutex for communication with the worker threads, which guards the
+  // injected tasks and the condition below.
+  std::mutex threadMutex;
+  // Notified when tasks are queued, when work is complete, and on shutdown.
+  std::condition_variable condition;
 
 private:
   void initialize(size_t num);
 
 public:
+  ThreadPool();
+  ~ThreadPool();
+
   // Get the number of cores we can use.
   static size_t getNumCores();
 
   // Get the singleton threadpool.
   static ThreadPool* get();
 
-  // Execute a bunch of tasks by the pool. This calls
-  // getTask() (in a thread-safe manner) to get tasks, and
-  // sends them to workers to be executed. This method
-  // blocks until all tasks are complete.
+  // Execute a bunch of tasks by the pool. Each of doWorkers is called
+  // repeatedly until it returns Finished, and only on one thread at a time.
+  // This method blocks until all tasks are complete, and while it waits, the
+  // calling thread runs those of its tasks that no other thread has started.
   void work(std::vector<std::function<ThreadWorkState()>>& doWorkers);
 
   size_t size();
 
-  bool isRunning();
-
-  // Called by helper threads when they are free and ready.
-  void notifyThreadIsReady();
-
 private:
-  void resetThreadsAreReady();
-
-  bool areThreadsReady();
+  // Take a queued task, if there is one. |self| is the helper thread we are on,
+  // or null if we are not on one. If |batch| is given, only its tasks are
+  // taken.
+  ThreadTask* takeTask(Thread* self, ThreadBatch* batch = nullptr);
+  void runTask(ThreadTask* task);
+  void notifyAll();
+
+  friend class Thread;
 };
 
 // Verify a code segment is only entered once. Usage:
@@ -17,6 +17,8 @@
 #ifndef wasm_tools_optimization_options_h
 #define wasm_tools_optimization_options_h
 
+#include "passes/pass-cache.h"
+#include "passes/pass-profile.h"
 #include "tool-options.h"
 
 //
@@ -32,6 +34,9 @@ struct OptimizationOptions : public ToolOptions {
 
   std::vector<std::string> passes;
 
+  // Where to write the pass profile, if we are profiling.
+  std::string passProfileFile;
+
   constexpr static const char* OptimizationOptionsCategory =
     "Optimization options";
 
@@ -248,6 +253,26 @@ struct OptimizationOptions : public ToolOptions {
            Options::Arguments::Zero,
            [this](Options*, const std::string&) {
              passOptions.zeroFilledMemory = true;
+           })
+      .add("--pass-profile",
+           "",
+           "Write the time and memory used by each pass, in the Chrome trace "
+           "event format, to the given file",
+           OptimizationOptionsCategory,
+           Options::Arguments::One,
+           [this](Options*, const std::string& argument) {
+             passProfileFile = argument;
+             passOptions.profiler = std::make_shared<PassProfiler>();
+           })
+      .add("--pass-cache",
+           "",
+           "Keep the results of function-parallel passes in the given "
+           "directory, and reuse them when the same functions are optimized "
+           "again in the same context",
+           OptimizationOptionsCategory,
+           Options::Arguments::One,
+           [this](Options*, const std::string& argument) {
+             passOptions.cache = std::make_shared<PassCache>(argument);
            });
 
     // add passes in registry
@@ -303,6 +328,12 @@ struct OptimizationOptions : public ToolOptions {
       }
     }
     passRunner.run();
+    if (passOptions.profiler) {
+      passOptions.profiler->write(passProfileFile);
+    }
+    if (passOptions.cache && !quiet) {
+      passOptions.cache->printStats(std::cerr);
+    }
   }
 };
 
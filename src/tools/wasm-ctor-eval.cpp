@@ -25,6 +25,8 @@
 #include <memory>
 
 #include "asmjs/shared-constants.h"
+#include "ir/effects.h"
+#include "ir/find_all.h"
 #include "ir/global-utils.h"
 #include "ir/import-utils.h"
 #include "ir/literal-utils.h"
@@ -35,6 +37,7 @@
 #include "support/file.h"
 #include "support/small_set.h"
 #include "support/string.h"
+#include "support/timing.h"
 #include "tool-options.h"
 #include "wasm-builder.h"
 #include "wasm-interpreter.h"
@@ -72,6 +75,87 @@ public:
 
     return ModuleRunnerBase<EvallingModuleRunner>::visitGlobalGet(curr);
   }
+
+  using ModuleRunnerBase<EvallingModuleRunner>::callFunctionInternal;
+
+  Literals callFunctionInternal(Name name, const Literals& arguments) {
+    return callFunctionInternal(wasm.getFunction(name), arguments);
+  }
+
+  // Calls a function, reusing the results of an earlier call if the function
+  // is pure and was called with the same arguments. Static constructors often
+  // call the same helpers with the same arguments many times.
+  Literals callFunctionInternal(Function* func, const Literals& arguments) {
+    if (!isPure(func)) {
+      return ModuleRunnerBase<EvallingModuleRunner>::callFunctionInternal(
+        func, arguments);
+    }
+    auto& results = pureResults[func];
+    auto iter = results.find(arguments);
+    if (iter != results.end()) {
+      return iter->second;
+    }
+    auto ret =
+      ModuleRunnerBase<EvallingModuleRunner>::callFunctionInternal(func,
+                                                                   arguments);
+    results.emplace(arguments, ret);
+    return ret;
+  }
+
+private:
+  // Whether each function we called is pure, and the results of the calls to
+  // the pure ones, by their arguments.
+  std::unordered_map<Function*, bool> pureFunctions;
+  std::unordered_map<Function*, std::unordered_map<Literals, Literals>>
+    pureResults;
+
+  // A function is pure if its results depend only on its arguments, and
+  // calling it has no effect other than perhaps trapping (which we do not
+  // cache, as it stops evalling). We only consider functions that receive
+  // and return numbers, as references have an identity, and functions that
+  // access no global state and only call other pure functions.
+  bool isPure(Function* func) {
+    auto iter = pureFunctions.find(func);
+    if (iter != pureFunctions.end()) {
+      return iter->second;
+    }
+    // Assume recursive calls are not pure, as we are still working that out.
+    pureFunctions[func] = false;
+    auto pure = [&]() {
+      if (func->imported()) {
+        return false;
+      }
+      for (auto type : {func->getParams(), func->getResults()}) {
+        for (auto t : type) {
+          if (!t.isNumber()) {
+            return false;
+          }
+        }
+      }
+      EffectAnalyzer effects(PassOptions(), wasm, func->body);
+      if (!effects.globalsWritten.empty() ||
+          !effects.mutableGlobalsRead.empty() || effects.readsMemory ||
+          effects.writesMemory || effects.readsTable || effects.writesTable ||
+          effects.readsMutableStruct || effects.writesStruct ||
+          effects.readsArray || effects.writesArray || effects.isAtomic ||
+          effects.throws() || effects.danglingPop) {
+        return false;
+      }
+      if (effects.calls) {
+        if (!FindAll<CallIndirect>(func->body).list.empty() ||
+            !FindAll<CallRef>(func->body).list.empty()) {
+          return false;
+        }
+        for (auto* call : FindAll<Call>(func->body).list) {
+          if (!isPure(wasm.getFunction(call->target))) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }();
+    return pureFunctions[func] = pure;
+  }
 };
 
 // Build an artificial `env` module based on a module's imports, so that the
@@ -168,6 +252,53 @@ struct CtorEvalExternalInterface : EvallingModuleRunner::ExternalInterface {
     applyGlobalsToModule();
   }
 
+  // Snapshots of the state of execution, so that we can return to the state
+  // after the last part we managed to eval if a later part fails. Copying all
+  // of memory after each part would be slow, so instead we save the contents of
+  // each page of memory before it is first written after the snapshot.
+  //
+  // Without GC we use a snapshot to apply the state to the module only once
+  // per ctor. GC data has an identity and can be modified in place, which a
+  // snapshot of the globals does not undo, so with GC we apply the state after
+  // each part, as the module then has the state of the last success anyhow.
+
+  // Notes that we succeeded to eval everything so far, so that if we fail to
+  // eval something after this, we can return to the state now.
+  void noteSuccess() {
+    if (wasm->features.hasGC()) {
+      applyToModule();
+    } else {
+      takeSnapshot();
+    }
+  }
+
+  // Applies the state of the last success to the module.
+  void applyLastSuccess() {
+    if (!wasm->features.hasGC()) {
+      restoreSnapshot();
+      applyToModule();
+    }
+  }
+
+  void takeSnapshot() {
+    hasSnapshot = true;
+    snapshotMemorySize = memory.size();
+    snapshotPages.clear();
+    snapshotGlobals = instance->globals;
+  }
+
+  void restoreSnapshot() {
+    assert(hasSnapshot);
+    // Bytes after the old size were either added or at least resized into
+    // existence since then, so all we need to restore is the pages before it.
+    memory.resize(snapshotMemorySize);
+    for (auto& [page, contents] : snapshotPages) {
+      std::copy(contents.begin(), contents.end(), &memory[page * PageSize]);
+    }
+    snapshotPages.clear();
+    instance->globals = snapshotGlobals;
+  }
+
   void init(Module& wasm_, EvallingModuleRunner& instance_) override {
     wasm = &wasm_;
     instance = &instance_;
@@ -396,6 +527,9 @@ private:
   }
 
   template<typename T> void doStore(Address address, T value) {
+    if (hasSnapshot) {
+      saveSnapshotPages(address, sizeof(T));
+    }
     // do a memcpy to avoid undefined behavior if unaligned
     memcpy(getMemory<T>(address), &value, sizeof(T));
   }
@@ -407,6 +541,33 @@ private:
     return ret;
   }
 
+  bool hasSnapshot = false;
+  size_t snapshotMemorySize;
+  GlobalValueSet snapshotGlobals;
+
+  static const size_t PageSize = 4096;
+
+  // The contents of pages of memory at the time of the snapshot, for the pages
+  // written to since. We only save the part before snapshotMemorySize.
+  std::unordered_map<size_t, std::vector<char>> snapshotPages;
+
+  void saveSnapshotPages(Address address, size_t size) {
+    auto first = size_t(address) / PageSize;
+    auto last = (size_t(address) + size - 1) / PageSize;
+    for (auto page = first; page <= last; page++) {
+      if (page * PageSize >= snapshotMemorySize) {
+        break;
+      }
+      auto& contents = snapshotPages[page];
+      if (contents.empty()) {
+        auto start = memory.begin() + page * PageSize;
+        auto end = memory.begin() +
+                   std::min((page + 1) * PageSize, snapshotMemorySize);
+        contents.assign(start, end);
+      }
+    }
+  }
+
   // Clear the state of the operation of applying the interpreter's runtime
   // information into the module.
   //
@@ -672,6 +833,7 @@ EvalCtorOutcome evalCtor(EvallingModuleRunner& instance,
 
     Literals results;
     Index successes = 0;
+    interface.takeSnapshot();
     for (auto* curr : block->list) {
       Flow flow;
       try {
@@ -688,8 +850,8 @@ EvalCtorOutcome evalCtor(EvallingModuleRunner& instance,
         break;
       }
 
-      // So far so good! Apply the results.
-      interface.applyToModule();
+      // So far so good! Note the results, which we will apply to the module.
+      interface.noteSuccess();
       appliedLocals = scope.locals;
       successes++;
 
@@ -712,6 +874,10 @@ EvalCtorOutcome evalCtor(EvallingModuleRunner& instance,
       }
     }
 
+    if (successes > 0) {
+      interface.applyLastSuccess();
+    }
+
     if (successes > 0 && successes < block->list.size()) {
       // We managed to eval some but not all. That means we can't just remove
       // the entire function, but need to keep parts of it - the parts we have
@@ -809,7 +975,11 @@ void evalCtors(Module& wasm,
         Fatal() << "export not found: " << ctor;
       }
       auto funcName = ex->value;
+      Timer timer;
+      timer.start();
       auto outcome = evalCtor(instance, interface, funcName, ctor);
+      timer.stop();
+      std::cout << "  ...evalled for " << timer.getTotal() << " seconds\n";
       if (!outcome) {
         std::cout << "  ...stopping\n";
         return;
@@ -919,6 +1089,15 @@ int main(int argc, const char* argv[]) {
          [&](Options* o, const std::string& argument) {
            ignoreExternalInput = true;
          })
+    .add("--bytecode",
+         "",
+         "Run functions by lowering them to a linear bytecode, instead of "
+         "walking their expressions",
+         WasmCtorEvalOption,
+         Options::Arguments::Zero,
+         [&](Options* o, const std::string& argument) {
+           setUseBytecode(true);
+         })
     .add_positional("INFILE",
                     Options::Arguments::One,
                     [](Options* o, const std::string& argument) {
@@ -284,6 +284,18 @@ int main(int argc, const char* argv[]) {
         exitOnInvalidWasm("error validating input");
       }
     }
+
+    // ReorderFunctionsByProfile checks that its profile is for the module file
+    // that it runs on, if it is told which file that is. Only set that when
+    // the pass runs, as pass arguments are part of the keys of the pass cache.
+    if (std::find(options.passes.begin(),
+                  options.passes.end(),
+                  "reorder-functions-profile") != options.passes.end() &&
+        !options.passOptions.arguments.count(
+          "reorder-functions-profile-module")) {
+      options.passOptions.arguments["reorder-functions-profile-module"] =
+        inputFile;
+    }
   }
   if (translateToFuzz) {
     TranslateToFuzzReader reader(wasm, options.extra["infile"]);
@@ -26,10 +26,12 @@
 #include <cstdio>
 #include <cstdlib>
 #include <memory>
+#include <thread>
 
 #include "ir/branch-utils.h"
 #include "ir/iteration.h"
 #include "ir/literal-utils.h"
+#include "ir/module-utils.h"
 #include "ir/properties.h"
 #include "pass.h"
 #include "support/colors.h"
@@ -80,6 +82,58 @@ static size_t timeout = 2;
 // default of enabling all features should work in most cases.
 static std::string extraFlags = "-all";
 
+// How many commands to run in parallel. Each job runs the command on a test
+// file of its own, see getJobTest(). Only the reductions of passes and of
+// functions run jobs in parallel; the others each depend on the one before.
+static size_t jobs = 1;
+
+// Returns the test file for a job, which is the test file with the job's
+// number added before the suffix, e.g. test.job1.wasm for test.wasm.
+static std::string getJobTest(const std::string& test, size_t job) {
+  auto suffix = test.rfind('.');
+  auto separator = test.find_last_of("/\\");
+  if (suffix == std::string::npos ||
+      (separator != std::string::npos && suffix < separator)) {
+    suffix = test.size();
+  }
+  return test.substr(0, suffix) + ".job" + std::to_string(job) +
+         test.substr(suffix);
+}
+
+// Returns the command for a job, which is the command with the test file
+// replaced with the job's.
+static std::string getJobCommand(const std::string& command,
+                                 const std::string& test,
+                                 size_t job) {
+  auto jobTest = getJobTest(test, job);
+  std::string ret;
+  size_t start = 0;
+  while (1) {
+    auto found = command.find(test, start);
+    if (found == std::string::npos) {
+      break;
+    }
+    ret += command.substr(start, found - start) + jobTest;
+    start = found + test.size();
+  }
+  return ret + command.substr(start);
+}
+
+// Runs func(job) for each job in [0, num), each on a thread of its own.
+template<typename T> static void runJobs(size_t num, T func) {
+  if (num == 1) {
+    func(0);
+    return;
+  }
+  std::vector<std::thread> threads;
+  for (size_t job = 0; job < num; job++) {
+    threads.emplace_back(func, job);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 struct ProgramResult {
   int code;
   std::string output;
@@ -243,7 +297,21 @@ struct Reducer
           bool verbose,
           bool debugInfo)
     : command(command), test(test), working(working), binary(binary),
-      deNan(deNan), verbose(verbose), debugInfo(debugInfo) {}
+      deNan(deNan), verbose(verbose), debugInfo(debugInfo) {
+    if (jobs == 1) {
+      jobTests.push_back(test);
+      jobCommands.push_back(command);
+      return;
+    }
+    for (size_t job = 0; job < jobs; job++) {
+      jobTests.push_back(getJobTest(test, job));
+      jobCommands.push_back(getJobCommand(command, test, job));
+    }
+  }
+
+  // The test file and command of each job. With a single job these are just
+  // test and command.
+  std::vector<std::string> jobTests, jobCommands;
 
   // runs passes in order to reduce, until we can't reduce any more
   // the criterion here is wasm binary size
@@ -292,29 +360,56 @@ struct Reducer
       more = false;
       // try both combining with a generic shrink (so minor pass overhead is
       // compensated for), and without
-      for (auto pass : passes) {
-        std::string currCommand = Path::getBinaryenBinaryTool("wasm-opt") + " ";
-        currCommand += working + " -o " + test + " " + pass + " " + extraFlags;
-        if (!binary) {
-          currCommand += " -S ";
-        }
-        if (verbose) {
-          std::cerr << "|    trying pass command: " << currCommand << "\n";
+      size_t i = 0;
+      while (i < passes.size()) {
+        // With several jobs, try the next passes in parallel and keep the
+        // first that succeeds. That is the one we would have found by trying
+        // them in order, so the result does not depend on the number of jobs.
+        auto num = std::min(jobs, passes.size() - i);
+        std::vector<std::string> currCommands;
+        for (size_t job = 0; job < num; job++) {
+          std::string currCommand =
+            Path::getBinaryenBinaryTool("wasm-opt") + " ";
+          currCommand += working + " -o " + jobTests[job] + " " +
+                         passes[i + job] + " " + extraFlags;
+          if (!binary) {
+            currCommand += " -S ";
+          }
+          if (verbose) {
+            std::cerr << "|    trying pass command: " << currCommand << "\n";
+          }
+          currCommands.push_back(currCommand);
         }
-        if (!ProgramResult(currCommand).failed()) {
-          auto newSize = file_size(test);
-          if (newSize < oldSize) {
-            // the pass didn't fail, and the size looks smaller, so promising
-            // see if it is still has the property we are preserving
-            if (ProgramResult(command) == expected) {
-              std::cerr << "|    command \"" << currCommand
-                        << "\" succeeded, reduced size to " << newSize << '\n';
-              copy_file(test, working);
-              more = true;
-              oldSize = newSize;
+        std::vector<size_t> newSizes(num, 0);
+        runJobs(num, [&](size_t job) {
+          if (!ProgramResult(currCommands[job]).failed()) {
+            auto newSize = file_size(jobTests[job]);
+            if (newSize < oldSize) {
+              // the pass didn't fail, and the size looks smaller, so
+              // promising see if it is still has the property we are
+              // preserving
+              if (ProgramResult(jobCommands[job]) == expected) {
+                newSizes[job] = newSize;
+              }
             }
           }
+        });
+        auto job = std::find_if(newSizes.begin(),
+                                newSizes.end(),
+                                [](size_t newSize) { return newSize > 0; }) -
+                   newSizes.begin();
+        if (size_t(job) == num) {
+          i += num;
+          continue;
         }
+        std::cerr << "|    command \"" << currCommands[job]
+                  << "\" succeeded, reduced size to " << newSizes[job] << '\n';
+        copy_file(jobTests[job], working);
+        more = true;
+        oldSize = newSizes[job];
+        // The passes after this one must be tried again on the new working
+        // file.
+        i += job + 1;
       }
     }
     if (verbose) {
@@ -335,6 +430,8 @@ struct Reducer
     loadWorking();
     reduced = 0;
     funcsSeen = 0;
+    parallelAttempts = 0;
+    parallelSuccesses = 0;
     // Before we do any changes, it should be valid to write out the module:
     // size should be as expected, and output should be as expected.
     ProgramResult result;
@@ -383,12 +480,16 @@ struct Reducer
     return writeAndTestReduction(result);
   }
 
-  bool writeAndTestReduction(ProgramResult& out) {
-    // write the module out
+  void writeModule(Module& wasm, std::string filename) {
     ModuleWriter writer;
     writer.setBinary(binary);
     writer.setDebugInfo(debugInfo);
-    writer.write(*getModule(), test);
+    writer.write(wasm, filename);
+  }
+
+  bool writeAndTestReduction(ProgramResult& out) {
+    // write the module out
+    writeModule(*getModule(), test);
     // note that it is ok for the destructively-reduced module to be bigger
     // than the previous - each destructive reduction removes logical code,
     // and so is strictly better, even if the wasm binary format happens to
@@ -877,6 +978,102 @@ struct Reducer
     }
   }
 
+  // An attempt to reduce some functions in reduceFunctions(), with the state
+  // of the loop there right before it.
+  struct FunctionsAttempt {
+    std::vector<Name> names;
+    // The names we added to functionsWeTriedToRemove for this attempt.
+    std::vector<Name> newlyTried;
+    size_t x;
+    size_t skip;
+    size_t decisionCounter;
+  };
+
+  // How many attempts to reduce functions we ran in parallel, and how many of
+  // them succeeded. Unlike when running serially, this includes attempts after
+  // the first that succeeded, so it tells us how common successes are.
+  size_t parallelAttempts = 0;
+  size_t parallelSuccesses = 0;
+
+  // Tries to empty or remove the functions in each of the attempts, and applies
+  // the first attempt that succeeds. Returns its index, or the number of
+  // attempts if none succeeded.
+  size_t tryToReduceFunctions(std::vector<FunctionsAttempt>& attempts) {
+    if (jobs == 1) {
+      assert(attempts.size() == 1);
+      auto& names = attempts[0].names;
+      // Try to remove functions and/or empty them. Note that
+      // tryToRemoveFunctions() will reload the module if it fails, which means
+      // function names may change - for that reason, run it second.
+      if (tryToEmptyFunctions(names) || tryToRemoveFunctions(names)) {
+        noteReduction(names.size());
+        return 0;
+      }
+      return 1;
+    }
+
+    // Write out the module with the functions emptied to the job's test file,
+    // and with them removed to a file next to it, which the job copies to its
+    // test file if emptying fails. The module is not modified until we find
+    // which attempt succeeded, so there is no need to reload it.
+    auto num = attempts.size();
+    std::vector<bool> canEmpty(num), canRemove(num);
+    for (size_t k = 0; k < num; k++) {
+      auto& names = attempts[k].names;
+      std::vector<Expression*> oldBodies;
+      if (emptyFunctions(names, oldBodies) > 0) {
+        canEmpty[k] = true;
+        writeModule(*module, jobTests[k]);
+      }
+      restoreFunctions(names, oldBodies);
+      Module copy;
+      ModuleUtils::copyModule(*module, copy);
+      copy.name = module->name;
+      copy.hasFeaturesSection = module->hasFeaturesSection;
+      removeFunctions(copy, names);
+      if (WasmValidator().validate(
+            copy, WasmValidator::Globally | WasmValidator::Quiet)) {
+        canRemove[k] = true;
+        writeModule(copy, jobTests[k] + ".removed");
+      }
+    }
+
+    enum Outcome { Failed, Emptied, Removed };
+    std::vector<Outcome> outcomes(num, Failed);
+    runJobs(num, [&](size_t k) {
+      if (canEmpty[k] && ProgramResult(jobCommands[k]) == expected) {
+        outcomes[k] = Emptied;
+      } else if (canRemove[k]) {
+        copy_file(jobTests[k] + ".removed", jobTests[k]);
+        if (ProgramResult(jobCommands[k]) == expected) {
+          outcomes[k] = Removed;
+        }
+      }
+    });
+
+    parallelAttempts += num;
+    parallelSuccesses +=
+      num - std::count(outcomes.begin(), outcomes.end(), Failed);
+    for (size_t k = 0; k < num; k++) {
+      auto& names = attempts[k].names;
+      if (outcomes[k] == Emptied) {
+        std::vector<Expression*> oldBodies;
+        auto emptied = emptyFunctions(names, oldBodies);
+        std::cerr << "|        emptied " << emptied << " / " << names.size()
+                  << " functions\n";
+      } else if (outcomes[k] == Removed) {
+        removeFunctions(*module, names);
+        std::cerr << "|        removed " << names.size() << " functions\n";
+      } else {
+        continue;
+      }
+      reduced += names.size();
+      copy_file(jobTests[k], working);
+      return k;
+    }
+    return num;
+  }
+
   // Reduces entire functions at a time. Returns whether we did a significant
   // amount of reduction that justifies doing even more.
   bool reduceFunctions() {
@@ -899,42 +1096,68 @@ struct Reducer
     std::cerr << "|    try to remove functions (base: " << base
               << ", decisionCounter: " << decisionCounter << ", numFuncs "
               << numFuncs << ")\n";
-    for (size_t x = 0; x < functionNames.size(); x++) {
-      size_t i = (base + x) % numFuncs;
-      if (!justReduced &&
-          functionsWeTriedToRemove.count(functionNames[i]) == 1 &&
-          !shouldTryToReduce(std::max((factor / 5) + 1, 20000))) {
-        continue;
-      }
-      std::vector<Name> names;
-      for (size_t j = 0; names.size() < skip && i + j < functionNames.size();
-           j++) {
-        auto name = functionNames[i + j];
-        if (module->getFunctionOrNull(name)) {
-          names.push_back(name);
-          functionsWeTriedToRemove.insert(name);
+    size_t x = 0;
+    while (x < functionNames.size()) {
+      // Gather the next attempts, one for each job, as if the ones before them
+      // fail, which is the common case. If one succeeds, we return to the
+      // state we had right before it below.
+      std::vector<FunctionsAttempt> attempts;
+      while (attempts.size() < jobs && x < functionNames.size()) {
+        size_t i = (base + x) % numFuncs;
+        if (!justReduced &&
+            functionsWeTriedToRemove.count(functionNames[i]) == 1 &&
+            !shouldTryToReduce(std::max((factor / 5) + 1, 20000))) {
+          x++;
+          continue;
+        }
+        FunctionsAttempt attempt;
+        for (size_t j = 0;
+             attempt.names.size() < skip && i + j < functionNames.size();
+             j++) {
+          auto name = functionNames[i + j];
+          if (module->getFunctionOrNull(name)) {
+            attempt.names.push_back(name);
+            if (functionsWeTriedToRemove.insert(name).second) {
+              attempt.newlyTried.push_back(name);
+            }
+          }
+        }
+        if (attempt.names.size() == 0) {
+          x++;
+          continue;
         }
+        std::cerr << "|     trying at i=" << i << " of size "
+                  << attempt.names.size() << "\n";
+        attempt.x = x;
+        attempt.skip = skip;
+        attempt.decisionCounter = decisionCounter;
+        attempts.push_back(std::move(attempt));
+        justReduced = false;
+        skip = std::max(skip / 2, size_t(1)); // or 1?
+        x += factor / 100;
+        x++;
+      }
+      if (attempts.empty()) {
+        break;
       }
-      if (names.size() == 0) {
+      auto succeeded = tryToReduceFunctions(attempts);
+      if (succeeded == attempts.size()) {
         continue;
       }
-      std::cerr << "|     trying at i=" << i << " of size " << names.size()
-                << "\n";
-      // Try to remove functions and/or empty them. Note that
-      // tryToRemoveFunctions() will reload the module if it fails, which means
-      // function names may change - for that reason, run it second.
-      justReduced = tryToEmptyFunctions(names) || tryToRemoveFunctions(names);
-      if (justReduced) {
-        noteReduction(names.size());
-        // Subtract 1 since the loop increments us anyhow by one: we want to
-        // skip over the skipped functions, and not any more.
-        x += skip - 1;
-        skip = std::min(size_t(factor), 2 * skip);
-        maxSkip = std::max(skip, maxSkip);
-      } else {
-        skip = std::max(skip / 2, size_t(1)); // or 1?
-        x += factor / 100;
+      auto& attempt = attempts[succeeded];
+      for (size_t k = succeeded + 1; k < attempts.size(); k++) {
+        for (auto name : attempts[k].newlyTried) {
+          functionsWeTriedToRemove.erase(name);
+        }
       }
+      x = attempt.x;
+      skip = attempt.skip;
+      decisionCounter = attempt.decisionCounter;
+      justReduced = true;
+      // Skip over the skipped functions, and not any more.
+      x += skip;
+      skip = std::min(size_t(factor), 2 * skip);
+      maxSkip = std::max(skip, maxSkip);
     }
     // If maxSkip is 1 then we never reduced at all. If it is 2 then we did
     // manage to reduce individual functions, but all our attempts at
@@ -1027,9 +1250,10 @@ struct Reducer
     }
   }
 
-  // Try to empty out the bodies of some functions.
-  bool tryToEmptyFunctions(std::vector<Name> names) {
-    std::vector<Expression*> oldBodies;
+  // Empties out the bodies of some functions, noting the old ones. Returns how
+  // many functions were actually emptied.
+  size_t emptyFunctions(const std::vector<Name>& names,
+                        std::vector<Expression*>& oldBodies) {
     size_t actuallyEmptied = 0;
     for (auto name : names) {
       auto* func = module->getFunction(name);
@@ -1049,24 +1273,34 @@ struct Reducer
         func->body = builder->makeNop();
       }
     }
+    return actuallyEmptied;
+  }
+
+  void restoreFunctions(const std::vector<Name>& names,
+                        const std::vector<Expression*>& oldBodies) {
+    for (size_t i = 0; i < names.size(); i++) {
+      module->getFunction(names[i])->body = oldBodies[i];
+    }
+  }
+
+  // Try to empty out the bodies of some functions.
+  bool tryToEmptyFunctions(std::vector<Name> names) {
+    std::vector<Expression*> oldBodies;
+    size_t actuallyEmptied = emptyFunctions(names, oldBodies);
     if (actuallyEmptied > 0 && writeAndTestReduction()) {
       std::cerr << "|        emptied " << actuallyEmptied << " / "
                 << names.size() << " functions\n";
       return true;
     } else {
-      // Restore the bodies.
-      for (size_t i = 0; i < names.size(); i++) {
-        module->getFunction(names[i])->body = oldBodies[i];
-      }
+      restoreFunctions(names, oldBodies);
       return false;
     }
   }
 
-  // Try to actually remove functions. If they are somehow referred to, we will
-  // get a validation error and undo it.
-  bool tryToRemoveFunctions(std::vector<Name> names) {
+  // Removes some functions and all references to them.
+  static void removeFunctions(Module& wasm, const std::vector<Name>& names) {
     for (auto name : names) {
-      module->removeFunction(name);
+      wasm.removeFunction(name);
     }
 
     // remove all references to them
@@ -1075,7 +1309,7 @@ struct Reducer
       std::unordered_set<Name> names;
       std::vector<Name> exportsToRemove;
 
-      FunctionReferenceRemover(std::vector<Name>& vec) {
+      FunctionReferenceRemover(const std::vector<Name>& vec) {
         for (auto name : vec) {
           names.insert(name);
         }
@@ -1103,7 +1337,13 @@ struct Reducer
       }
     };
     FunctionReferenceRemover referenceRemover(names);
-    referenceRemover.walkModule(module.get());
+    referenceRemover.walkModule(&wasm);
+  }
+
+  // Try to actually remove functions. If they are somehow referred to, we will
+  // get a validation error and undo it.
+  bool tryToRemoveFunctions(std::vector<Name> names) {
+    removeFunctions(*module, names);
 
     if (WasmValidator().validate(
           *module, WasmValidator::Globally | WasmValidator::Quiet) &&
@@ -1295,6 +1535,22 @@ int main(int argc, const char* argv[]) {
            extraFlags = argument;
            std::cout << "|applying extraFlags: " << extraFlags << "\n";
          })
+    .add("--jobs",
+         "-j",
+         "How many commands to run in parallel when trying fewer passes and "
+         "removing or emptying functions (default: 1). Other reductions, "
+         "like those of single expressions, are still tried one at a time. "
+         "With more than one, each job writes its own copy of the test "
+         "file, with the job's number added before the suffix, and runs the "
+         "command with the test file's name replaced with it, so the command "
+         "must contain that name and must not write to files that the other "
+         "jobs use",
+         WasmReduceOption,
+         Options::Arguments::One,
+         [&](Options* o, const std::string& argument) {
+           jobs = std::max(atoi(argument.c_str()), 1);
+           std::cout << "|applying jobs: " << jobs << "\n";
+         })
     .add_positional(
       "INFILE",
       Options::Arguments::One,
@@ -1315,6 +1571,11 @@ int main(int argc, const char* argv[]) {
     Fatal() << "working file not provided\n";
   }
 
+  if (jobs > 1 && command.find(test) == std::string::npos) {
+    Fatal() << "the command must contain the name of the test file (" << test
+            << ") when running several jobs\n";
+  }
+
   if (!binary) {
     Colors::setEnabled(false);
   }
@@ -1408,6 +1669,8 @@ int main(int argc, const char* argv[]) {
 
   size_t lastDestructiveReductions = 0;
   size_t lastPostPassesSize = 0;
+  size_t lastParallelAttempts = 0;
+  size_t lastParallelSuccesses = 0;
 
   bool stopping = false;
 
@@ -1465,6 +1728,17 @@ int main(int argc, const char* argv[]) {
       }
     }
 
+    // When we run several jobs we also see how many of the attempts to reduce
+    // functions would have succeeded on their own. If most of them would have,
+    // then reductions are common, and it is worth trying more of them, so
+    // decrease the factor more.
+    if (lastParallelSuccesses * 2 > lastParallelAttempts) {
+      std::cerr << "|  most parallel attempts succeeded ("
+                << lastParallelSuccesses << " / " << lastParallelAttempts
+                << "), decrease factor more\n";
+      factor = (factor + 1) / 2; // stable on 1
+    }
+
     // no point in a factor lorger than the size
     assert(newSize > 4); // wasm modules are >4 bytes anyhow
     factor = std::min(factor, int(newSize) / 4);
@@ -1475,6 +1749,8 @@ int main(int argc, const char* argv[]) {
     while (1) {
       std::cerr << "|  reduce destructively... (factor: " << factor << ")\n";
       lastDestructiveReductions = reducer.reduceDestructively(factor);
+      lastParallelAttempts = reducer.parallelAttempts;
+      lastParallelSuccesses = reducer.parallelSuccesses;
       if (lastDestructiveReductions > 0) {
         break;
       }
@@ -1492,4 +1768,11 @@ int main(int argc, const char* argv[]) {
   }
   std::cerr << "|finished, final size: " << file_size(working) << "\n";
   copy_file(working, test); // just to avoid confusion
+  if (jobs > 1) {
+    for (size_t job = 0; job < jobs; job++) {
+      auto jobTest = getJobTest(test, job);
+      std::remove(jobTest.c_str());
+      std::remove((jobTest + ".removed").c_str());
+    }
+  }
 }
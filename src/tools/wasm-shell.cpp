@@ -75,6 +75,13 @@ struct ShellOptions : public Options {
                i = ending + 1;
              }
            })
+      .add("--bytecode",
+           "",
+           "Run functions by lowering them to a linear bytecode, instead of "
+           "walking their expressions",
+           WasmShellOption,
+           Options::Arguments::Zero,
+           [](Options*, const std::string&) { setUseBytecode(true); })
       .add_positional("INFILE",
                       Options::Arguments::One,
                       [](Options* o, const std::string& argument) {
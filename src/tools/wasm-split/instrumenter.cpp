@@ -15,8 +15,10 @@
  */
 
 #include "instrumenter.h"
+#include "ir/find_all.h"
 #include "ir/module-utils.h"
 #include "ir/names.h"
+#include "ir/split-profile.h"
 #include "support/name.h"
 #include "wasm-type.h"
 
@@ -30,12 +32,21 @@ void Instrumenter::run(PassRunner* runner, Module* wasm) {
   this->wasm = wasm;
   addGlobals();
   instrumentFuncs();
+  if (options.counters) {
+    instrumentCounters();
+  }
   addProfileExport();
 }
 
 void Instrumenter::addGlobals() {
+  if (options.counters) {
+    numCounters = SplitProfile::getNumCounters(*wasm);
+  }
   if (options.storageKind != WasmSplitOptions::StorageKind::InGlobals) {
-    // Don't need globals
+    // Don't need globals. The counters go after the byte for each function.
+    size_t numFuncs = 0;
+    ModuleUtils::iterDefinedFunctions(*wasm, [&](Function*) { ++numFuncs; });
+    countersAddr = (numFuncs + 3) & ~size_t(3);
     return;
   }
   // Create fresh global names (over-reserves, but that's ok)
@@ -60,6 +71,24 @@ void Instrumenter::addGlobals() {
   for (auto& name : functionGlobals) {
     addGlobal(name);
   }
+
+  if (!options.counters) {
+    return;
+  }
+  // Add the counters in the order in which instrumentCounters() uses them.
+  // Add each right away so that the names we pick are all different.
+  auto addCounterGlobal = [&](std::string name) {
+    counterGlobals.push_back(Names::getValidGlobalName(*wasm, name));
+    addGlobal(counterGlobals.back());
+  };
+  ModuleUtils::iterDefinedFunctions(*wasm, [&](Function* func) {
+    std::string prefix = func->name.c_str();
+    addCounterGlobal(prefix + "_calls");
+    auto numLoops = FindAll<Loop>(func->body).list.size();
+    for (size_t i = 0; i < numLoops; i++) {
+      addCounterGlobal(prefix + "_loop" + std::to_string(i) + "_iterations");
+    }
+  });
 }
 
 void Instrumenter::instrumentFuncs() {
@@ -124,6 +153,56 @@ void Instrumenter::instrumentFuncs() {
   }
 }
 
+void Instrumenter::instrumentCounters() {
+  // Increment a counter at the beginning of each function, and at the
+  // beginning of each loop, which runs at the start of each iteration.
+  Builder builder(*wasm);
+  Index counter = 0;
+  ModuleUtils::iterDefinedFunctions(*wasm, [&](Function* func) {
+    auto callsCounter = counter++;
+    for (auto* loop : FindAll<Loop>(func->body).list) {
+      loop->body = builder.makeSequence(
+        makeCounterIncrement(counter++), loop->body, loop->body->type);
+    }
+    func->body = builder.makeSequence(
+      makeCounterIncrement(callsCounter), func->body, func->body->type);
+  });
+  assert(counter == numCounters);
+}
+
+Expression* Instrumenter::makeCounterIncrement(Index counter) {
+  Builder builder(*wasm);
+  switch (options.storageKind) {
+    case WasmSplitOptions::StorageKind::InGlobals: {
+      // (global.set $counter
+      //   (i32.add (global.get $counter) (i32.const 1))
+      // )
+      auto global = counterGlobals[counter];
+      return builder.makeGlobalSet(
+        global,
+        builder.makeBinary(AddInt32,
+                           builder.makeGlobalGet(global, Type::i32),
+                           builder.makeConst(Literal::makeOne(Type::i32))));
+    }
+    case WasmSplitOptions::StorageKind::InMemory: {
+      // (drop
+      //   (i32.atomic.rmw.add offset=counterAddr
+      //     (i32.const 0)
+      //     (i32.const 1)
+      //   )
+      // )
+      return builder.makeDrop(
+        builder.makeAtomicRMW(RMWAdd,
+                              4,
+                              countersAddr + 4 * counter,
+                              builder.makeConstPtr(0),
+                              builder.makeConst(uint32_t(1)),
+                              Type::i32));
+    }
+  }
+  WASM_UNREACHABLE("unexpected storage kind");
+}
+
 // wasm-split profile format:
 //
 // The wasm-split profile is a binary format designed to be simple to produce
@@ -133,11 +212,18 @@ void Instrumenter::instrumentFuncs() {
 //
 //   2. A 4-byte timestamp for each defined function
 //
+//   3. With --counters, the 4-byte ProfileCountersMagic, a 4-byte number of
+//      counters, and a 4-byte count for each. For each defined function there
+//      is the number of calls to it, followed by the number of iterations of
+//      each of its loops, in the order FindAll finds them (nested loops first).
+//
 // The module hash is meant to guard against bugs where the module that was
 // instrumented and the module that is being split are different. The timestamps
 // are non-zero for functions that were called during the instrumented run and 0
 // otherwise. Functions with smaller non-zero timestamps were called earlier in
-// the instrumented run than funtions with larger timestamps.
+// the instrumented run than funtions with larger timestamps. The timestamps are
+// at most the number of functions, so they cannot be confused with the magic
+// number.
 
 void Instrumenter::addProfileExport() {
   // Create and export a function to dump the profile into a given memory
@@ -156,8 +242,11 @@ void Instrumenter::addProfileExport() {
 
   // Calculate the size of the profile:
   //   8 bytes module hash +
-  //   4 bytes for the timestamp for each function
-  const size_t profileSize = 8 + 4 * numFuncs;
+  //   4 bytes for the timestamp for each function +
+  //   with --counters, 8 bytes of header and 4 bytes for each counter
+  const size_t countersOffset = 8 + 4 * numFuncs;
+  const size_t profileSize =
+    countersOffset + (options.counters ? 8 + 4 * numCounters : 0);
 
   // Create the function body
   Builder builder(*wasm);
@@ -243,6 +332,81 @@ void Instrumenter::addProfileExport() {
     }
   }
 
+  if (options.counters) {
+    // Write the magic number and the number of counters, then the counters.
+    writeData = builder.blockify(
+      writeData,
+      builder.makeStore(4,
+                        countersOffset,
+                        1,
+                        getAddr(),
+                        builder.makeConst(uint32_t(ProfileCountersMagic)),
+                        Type::i32),
+      builder.makeStore(4,
+                        countersOffset + 4,
+                        1,
+                        getAddr(),
+                        builder.makeConst(uint32_t(numCounters)),
+                        Type::i32));
+    offset = countersOffset + 8;
+    switch (options.storageKind) {
+      case WasmSplitOptions::StorageKind::InGlobals: {
+        for (const auto& global : counterGlobals) {
+          writeData = builder.blockify(
+            writeData,
+            builder.makeStore(4,
+                              offset,
+                              1,
+                              getAddr(),
+                              builder.makeGlobalGet(global, Type::i32),
+                              Type::i32));
+          offset += 4;
+        }
+        break;
+      }
+      case WasmSplitOptions::StorageKind::InMemory: {
+        // The same loop as for the functions above, over the counters.
+        Index counterIdxVar =
+          Builder::addVar(writeProfile.get(), "counterIdx", Type::i32);
+        auto getCounterIdx = [&]() {
+          return builder.makeLocalGet(counterIdxVar, Type::i32);
+        };
+        auto getCounterOffset = [&]() {
+          return builder.makeBinary(
+            MulInt32, getCounterIdx(), builder.makeConst(uint32_t(4)));
+        };
+        writeData = builder.blockify(
+          writeData,
+          builder.makeBlock(
+            "counters_outer",
+            builder.makeLoop(
+              "counters_l",
+              builder.blockify(
+                builder.makeBreak(
+                  "counters_outer",
+                  nullptr,
+                  builder.makeBinary(EqInt32,
+                                     getCounterIdx(),
+                                     builder.makeConst(uint32_t(numCounters)))),
+                builder.makeStore(
+                  4,
+                  offset,
+                  4,
+                  builder.makeBinary(AddInt32, getAddr(), getCounterOffset()),
+                  builder.makeAtomicLoad(
+                    4, countersAddr, getCounterOffset(), Type::i32),
+                  Type::i32),
+                builder.makeLocalSet(
+                  counterIdxVar,
+                  builder.makeBinary(AddInt32,
+                                     getCounterIdx(),
+                                     builder.makeConst(uint32_t(1)))),
+                builder.makeBreak("counters_l")))));
+        break;
+      }
+    }
+  }
+
   writeProfile->body = builder.makeSequence(
     builder.makeIf(builder.makeBinary(GeUInt32, getSize(), profileSizeConst()),
                    writeData),
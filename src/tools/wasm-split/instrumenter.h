@@ -25,7 +25,8 @@ namespace wasm {
 
 // Add a global monotonic counter and a timestamp global for each function, code
 // at the beginning of each function to set its timestamp, and a new exported
-// function for dumping the profile data.
+// function for dumping the profile data. With --counters, also add a counter
+// for each function and loop, and code to increment it.
 struct Instrumenter : public Pass {
   PassRunner* runner = nullptr;
   Module* wasm = nullptr;
@@ -36,6 +37,11 @@ struct Instrumenter : public Pass {
   Name counterGlobal;
   std::vector<Name> functionGlobals;
 
+  // The number of counters, and with --in-memory the address of the first.
+  size_t numCounters = 0;
+  uint32_t countersAddr = 0;
+  std::vector<Name> counterGlobals;
+
   Instrumenter(const WasmSplitOptions& options, uint64_t moduleHash);
 
   void run(PassRunner* runner, Module* wasm) override;
@@ -43,6 +49,8 @@ struct Instrumenter : public Pass {
 private:
   void addGlobals();
   void instrumentFuncs();
+  void instrumentCounters();
+  Expression* makeCounterIncrement(Index counter);
   void addProfileExport();
 };
 
@@ -232,6 +232,16 @@ WasmSplitOptions::WasmSplitOptions()
       [&](Options* o, const std::string& argument) {
         storageKind = StorageKind::InMemory;
       })
+    .add("--counters",
+         "",
+         "Also count how many times each function is called and each loop "
+         "starts an iteration, and add the counts to the profile. With "
+         "--in-memory, the counters take four bytes each in the memory after "
+         "the bytes for the functions, starting at the next multiple of four.",
+         WasmSplitOption,
+         {Mode::Instrument},
+         Options::Arguments::Zero,
+         [&](Options* o, const std::string& argument) { counters = true; })
     .add(
       "--emit-module-names",
       "",
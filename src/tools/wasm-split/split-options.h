@@ -39,6 +39,10 @@ struct WasmSplitOptions : ToolOptions {
   };
   StorageKind storageKind = StorageKind::InGlobals;
 
+  // Whether to also count function calls and loop iterations when
+  // instrumenting.
+  bool counters = false;
+
   bool verbose = false;
   bool emitBinary = true;
   bool symbolMap = false;
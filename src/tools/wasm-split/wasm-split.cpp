@@ -17,8 +17,10 @@
 // wasm-split: Split a module in two or instrument a module to inform future
 // splitting.
 
+#include "ir/find_all.h"
 #include "ir/module-splitting.h"
 #include "ir/names.h"
+#include "ir/split-profile.h"
 #include "support/file.h"
 #include "support/name.h"
 #include "support/path.h"
@@ -55,16 +57,6 @@ void parseInput(Module& wasm, const WasmSplitOptions& options) {
   }
 }
 
-uint64_t hashFile(const std::string& filename) {
-  auto contents(read_file<std::vector<char>>(filename, Flags::Binary));
-  size_t digest = 0;
-  // Don't use `hash` or `rehash` - they aren't deterministic between executions
-  for (char c : contents) {
-    hash_combine(digest, c);
-  }
-  return uint64_t(digest);
-}
-
 void adjustTableSize(Module& wasm, int initialSize) {
   if (initialSize < 0) {
     return;
@@ -107,7 +99,7 @@ void instrumentModule(const WasmSplitOptions& options) {
     Fatal() << "error: Export " << options.profileExport << " already exists.";
   }
 
-  uint64_t moduleHash = hashFile(options.inputFiles[0]);
+  uint64_t moduleHash = SplitProfile::hashFile(options.inputFiles[0]);
   PassRunner runner(&wasm, options.passOptions);
   Instrumenter(options, moduleHash).run(&runner, &wasm);
 
@@ -117,38 +109,6 @@ void instrumentModule(const WasmSplitOptions& options) {
   writeModule(wasm, options.output, options);
 }
 
-struct ProfileData {
-  uint64_t hash;
-  std::vector<size_t> timestamps;
-};
-
-// See "wasm-split profile format" in instrumenter.cpp for more information.
-ProfileData readProfile(const std::string& file) {
-  auto profileData = read_file<std::vector<char>>(file, Flags::Binary);
-  size_t i = 0;
-  auto readi32 = [&]() {
-    if (i + 4 > profileData.size()) {
-      Fatal() << "Unexpected end of profile data in " << file;
-    }
-    uint32_t i32 = 0;
-    i32 |= uint32_t(uint8_t(profileData[i++]));
-    i32 |= uint32_t(uint8_t(profileData[i++])) << 8;
-    i32 |= uint32_t(uint8_t(profileData[i++])) << 16;
-    i32 |= uint32_t(uint8_t(profileData[i++])) << 24;
-    return i32;
-  };
-
-  uint64_t hash = readi32();
-  hash |= uint64_t(readi32()) << 32;
-
-  std::vector<size_t> timestamps;
-  while (i < profileData.size()) {
-    timestamps.push_back(readi32());
-  }
-
-  return {hash, timestamps};
-}
-
 void writeSymbolMap(Module& wasm, std::string filename) {
   PassOptions options;
   options.arguments["symbolmap"] = filename;
@@ -174,8 +134,8 @@ void splitModule(const WasmSplitOptions& options) {
 
   if (options.profileFile.size()) {
     // Use the profile to set `keepFuncs`.
-    uint64_t hash = hashFile(options.inputFiles[0]);
-    ProfileData profile = readProfile(options.profileFile);
+    uint64_t hash = SplitProfile::hashFile(options.inputFiles[0]);
+    auto profile = SplitProfile::read(options.profileFile);
     if (profile.hash != hash) {
       Fatal() << "error: checksum in profile does not match module checksum. "
               << "The split module must be the original module that was "
@@ -193,6 +153,25 @@ void splitModule(const WasmSplitOptions& options) {
     if (i != profile.timestamps.size()) {
       Fatal() << "Unexpected extra profile data";
     }
+    if (!profile.counters.empty()) {
+      if (profile.counters.size() != SplitProfile::getNumCounters(wasm)) {
+        Fatal() << "Profile counters do not match the module";
+      }
+      // Dump the counts if we are verbose.
+      if (options.verbose) {
+        size_t c = 0;
+        ModuleUtils::iterDefinedFunctions(wasm, [&](Function* func) {
+          std::cout << "Function " << func->name << ": "
+                    << profile.counters[c++] << " calls";
+          auto numLoops = FindAll<Loop>(func->body).list.size();
+          for (size_t l = 0; l < numLoops; l++) {
+            std::cout << ", loop " << l << ": " << profile.counters[c++]
+                      << " iterations";
+          }
+          std::cout << "\n";
+        });
+      }
+    }
   } else if (options.keepFuncs.size()) {
     // Use the explicitly provided `keepFuncs`.
     for (auto& func : options.keepFuncs) {
@@ -316,7 +295,7 @@ void splitModule(const WasmSplitOptions& options) {
 
 void mergeProfiles(const WasmSplitOptions& options) {
   // Read the initial profile. We will merge other profiles into this one.
-  ProfileData data = readProfile(options.inputFiles[0]);
+  auto data = SplitProfile::read(options.inputFiles[0]);
 
   // In verbose mode, we want to find profiles that don't contribute to the
   // merged profile. To do that, keep track of how many profiles each function
@@ -335,15 +314,22 @@ void mergeProfiles(const WasmSplitOptions& options) {
   // Read all the other profiles, taking the minimum nonzero timestamp for each
   // function.
   for (size_t i = 1; i < options.inputFiles.size(); ++i) {
-    ProfileData newData = readProfile(options.inputFiles[i]);
+    auto newData = SplitProfile::read(options.inputFiles[i]);
     if (newData.hash != data.hash) {
       Fatal() << "Checksum in profile " << options.inputFiles[i]
               << " does not match hash in profile " << options.inputFiles[0];
     }
-    if (newData.timestamps.size() != data.timestamps.size()) {
+    if (newData.timestamps.size() != data.timestamps.size() ||
+        newData.counters.size() != data.counters.size()) {
       Fatal() << "Profile " << options.inputFiles[i]
               << " incompatible with profile " << options.inputFiles[0];
     }
+    // Add up the counters, saturating rather than overflowing.
+    for (size_t c = 0; c < data.counters.size(); ++c) {
+      data.counters[c] =
+        uint32_t(std::min(uint64_t(data.counters[c]) + newData.counters[c],
+                          uint64_t(UINT32_MAX)));
+    }
     for (size_t t = 0; t < data.timestamps.size(); ++t) {
       if (data.timestamps[t] && newData.timestamps[t]) {
         data.timestamps[t] =
@@ -361,7 +347,7 @@ void mergeProfiles(const WasmSplitOptions& options) {
   if (options.verbose) {
     for (const auto& file : options.inputFiles) {
       bool useless = true;
-      ProfileData newData = readProfile(file);
+      auto newData = SplitProfile::read(file);
       for (size_t t = 0; t < newData.timestamps.size(); ++t) {
         if (newData.timestamps[t] && numProfiles[t] == 1) {
           useless = false;
@@ -381,6 +367,12 @@ void mergeProfiles(const WasmSplitOptions& options) {
   for (size_t t = 0; t < data.timestamps.size(); ++t) {
     buffer << uint32_t(data.timestamps[t]);
   }
+  if (!data.counters.empty()) {
+    buffer << ProfileCountersMagic << uint32_t(data.counters.size());
+    for (auto counter : data.counters) {
+      buffer << counter;
+    }
+  }
   Output out(options.output, Flags::Binary);
   buffer.writeTo(out.getStream());
 }
@@ -24,6 +24,7 @@
 #include "support/colors.h"
 #include "support/command-line.h"
 #include "support/file.h"
+#include "support/threads.h"
 #include "wasm-s-parser.h"
 
 using namespace cashew;
@@ -61,6 +62,76 @@ static void optimizeWasm(Module& wasm, PassOptions options) {
 
 template<typename T> static void printJS(Ref ast, T& output) {
   JSPrinter jser(true, true, ast);
+
+  // Print the functions inside the asm function in parallel, if there is work
+  // for more than one thread. Each is printed into a buffer of its own, in
+  // batches as the printer reaches them, and the printer copies them in.
+  std::vector<Ref> funcs;
+  std::unordered_map<Value*, size_t> funcIndexes;
+  for (size_t i = 0; i < ast[1]->size(); i++) {
+    Ref asmFunc = ast[1][i];
+    if (asmFunc->isArray() && asmFunc[0] == DEFUN) {
+      for (size_t j = 0; j < asmFunc[3]->size(); j++) {
+        Ref func = asmFunc[3][j];
+        if (func->isArray() && func[0] == DEFUN) {
+          funcIndexes[func.get()] = funcs.size();
+          funcs.push_back(func);
+        }
+      }
+    }
+  }
+  size_t num = 1;
+  if (funcs.size() > 1) {
+    num = ThreadPool::get()->size();
+  }
+  static const size_t FunctionsPerThreadInBatch = 64;
+  size_t batchSize = num * FunctionsPerThreadInBatch;
+  std::vector<std::string> texts;
+  size_t start = 0, end = 0;
+  auto printBatch = [&]() {
+    std::vector<std::function<ThreadWorkState()>> doWorkers;
+    std::atomic<size_t> nextFunction;
+    nextFunction.store(start);
+    for (size_t i = 0; i < num; i++) {
+      doWorkers.push_back([&]() {
+        auto index = nextFunction.fetch_add(1);
+        if (index >= end) {
+          return ThreadWorkState::Finished;
+        }
+        // These functions are statements in the body of the asm function.
+        JSPrinter funcJser(true, true, funcs[index]);
+        funcJser.indent = 1;
+        funcJser.printAst();
+        texts[index - start].assign(funcJser.buffer, funcJser.used);
+        if (index + 1 == end) {
+          return ThreadWorkState::Finished;
+        }
+        return ThreadWorkState::More;
+      });
+    }
+    ThreadPool::get()->work(doWorkers);
+  };
+  if (num > 1) {
+    jser.getPrintedDefun = [&](Ref node) -> const std::string* {
+      auto it = funcIndexes.find(node.get());
+      if (it == funcIndexes.end()) {
+        return nullptr;
+      }
+      auto index = it->second;
+      if (index >= end) {
+        start = index;
+        end = std::min(start + batchSize, funcs.size());
+        texts.clear();
+        texts.resize(end - start);
+        printBatch();
+      }
+      if (index < start) {
+        return nullptr;
+      }
+      return &texts[index - start];
+    };
+  }
+
   jser.printAst();
   output << jser.buffer << '\n';
 }
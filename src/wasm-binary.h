@@ -22,7 +22,9 @@
 #define wasm_wasm_binary_h
 
 #include <cassert>
+#include <optional>
 #include <ostream>
+#include <string_view>
 #include <type_traits>
 
 #include "ir/import-utils.h"
@@ -1235,6 +1237,17 @@ public:
     sourceMapUrl = url;
   }
   void setSymbolMap(std::string set) { symbolMap = set; }
+  // Whether to update the DWARF sections in the module for the new binary
+  // locations of the code. Only a writer whose output is not used, like one
+  // that just measures the size of the module, should skip that, as the
+  // update changes the sections in the module itself.
+  void setUpdateDWARF(bool set) { updateDWARF = set; }
+  // Write the binary to |stream| as it is produced, a section at a time (and
+  // the code section in chunks), instead of accumulating all of it in the
+  // buffer, which is left empty. Offsets that the writer reports, like those in
+  // the table of contents and the source map, are still relative to the start
+  // of the binary.
+  void setOutputStream(std::ostream* stream) { outputStream = stream; }
 
   void write();
   void writeHeader();
@@ -1326,10 +1339,20 @@ private:
   // https://bugs.chromium.org/p/v8/issues/detail?id=11808.
   bool emitModuleName = true;
 
+  bool updateDWARF = true;
+
   std::ostream* sourceMap = nullptr;
   std::string sourceMapUrl;
   std::string symbolMap;
 
+  std::ostream* outputStream = nullptr;
+  // How many bytes we wrote to the output stream and removed from the buffer.
+  size_t flushedBytes = 0;
+
+  // The position in the binary that we are writing at.
+  size_t getPosition() const { return flushedBytes + o.size(); }
+  void flushToOutputStream();
+
   MixedArena allocator;
 
   // storage of source map locations until the section is placed at its final
@@ -1337,13 +1360,14 @@ private:
   std::vector<std::pair<size_t, const Function::DebugLocation*>>
     sourceMapLocations;
   size_t sourceMapLocationsSizeAtSectionStart;
-  Function::DebugLocation lastDebugLocation;
+  // The last debug location we emitted, if any. Repeated locations are only
+  // emitted once.
+  std::optional<Function::DebugLocation> lastDebugLocation;
 
   std::unique_ptr<ImportInfo> importInfo;
 
   // General debugging info: track locations as we write.
   BinaryLocations binaryLocations;
-  size_t binaryLocationsSizeAtSectionStart;
   // Track the expressions that we added for the current function being
   // written, so that we can update those specific binary locations when
   // the function is written out.
@@ -1355,17 +1379,53 @@ private:
   std::unordered_map<Name, MappedLocals> funcMappedLocals;
 
   void prepare();
+
+  // Creates a writer for function bodies, which shares the indexes of the
+  // parent and writes into its own buffer.
+  WasmBinaryWriter(const WasmBinaryWriter& parent, BufferWithRandomAccess& o)
+    : wasm(parent.wasm), o(o), indexes(parent.indexes),
+      indexedTypes(parent.indexedTypes), debugInfo(parent.debugInfo),
+      sourceMap(parent.sourceMap) {}
+
+  // A function body encoded by itself. All offsets are relative to the start
+  // of the body (after the size LEB).
+  struct EncodedFunction {
+    BufferWithRandomAccess body;
+    MappedLocals mappedLocals;
+    std::vector<std::pair<size_t, const Function::DebugLocation*>>
+      sourceMapLocations;
+    BinaryLocations binaryLocations;
+  };
+
+  // Encodes a batch of the functions from |start| on, in parallel using one of
+  // the |writers| per thread, and returns how many are in it. The batch ends
+  // once it has enough bytes, so that we hold a bounded amount at once.
+  Index
+  encodeFunctions(std::vector<std::unique_ptr<WasmBinaryWriter>>& writers,
+                  const std::vector<Function*>& funcs,
+                  Index start,
+                  std::vector<EncodedFunction>& encoded,
+                  bool DWARF);
+  void encodeFunction(Function* func, bool DWARF, EncodedFunction& out);
+  // Appends an encoded function to the code section, whose body starts at
+  // |sectionBody|, and frees its encoding.
+  void
+  appendFunction(Function* func, EncodedFunction& curr, size_t sectionBody);
 };
 
 class WasmBinaryBuilder {
   Module& wasm;
   MixedArena& allocator;
-  const std::vector<char>& input;
+  // The input is not owned, and must outlive the builder. It may be a file
+  // mapped into memory (see MappedFile), so we only ever read from it, and
+  // everything we keep is copied out of it.
+  std::string_view input;
   std::istream* sourceMap;
   std::pair<uint32_t, Function::DebugLocation> nextDebugLocation;
   bool debugInfo = true;
   bool DWARF = false;
   bool skipFunctionBodies = false;
+  bool parallelFunctionBodies = false;
 
   size_t pos = 0;
   Index startIndex = -1;
@@ -1378,15 +1438,24 @@ class WasmBinaryBuilder {
   std::vector<HeapType> types;
 
 public:
+  WasmBinaryBuilder(Module& wasm, FeatureSet features, std::string_view input);
   WasmBinaryBuilder(Module& wasm,
                     FeatureSet features,
-                    const std::vector<char>& input);
+                    const std::vector<char>& input)
+    : WasmBinaryBuilder(
+        wasm, features, std::string_view(input.data(), input.size())) {}
 
   void setDebugInfo(bool value) { debugInfo = value; }
   void setDWARF(bool value) { DWARF = value; }
   void setSkipFunctionBodies(bool skipFunctionBodies_) {
     skipFunctionBodies = skipFunctionBodies_;
   }
+  // Decode the bodies in the code section in parallel. Each body is decoded
+  // by a separate decoder on the thread pool, and the results are identical
+  // to those of a serial read.
+  void setParallelFunctionBodies(bool parallelFunctionBodies_) {
+    parallelFunctionBodies = parallelFunctionBodies_;
+  }
   void read();
   void readUserSection(size_t payloadLen);
 
@@ -1498,6 +1567,8 @@ public:
   void requireFunctionContext(const char* error);
 
   void readFunctions();
+  void
+  readFunctionBody(Function* func, Index index, size_t sizePos, size_t size);
   void readVars();
 
   std::map<Export*, Index> exportIndices;
@@ -1711,6 +1782,14 @@ public:
 
 private:
   bool hasDWARFSections();
+
+  bool shouldReadFunctionsInParallel(size_t total);
+  void readFunctionsInParallel(size_t total);
+  // Create a builder that can decode function bodies independently of this
+  // one, using the state from the sections before the code section.
+  std::unique_ptr<WasmBinaryBuilder> makeFunctionBodyDecoder();
+  // Clear the per-function state after an error while decoding a body.
+  void resetFunctionBodyState();
 };
 
 } // namespace wasm
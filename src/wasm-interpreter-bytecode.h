@@ -0,0 +1,149 @@
+/*
+ * Copyright 2022 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// A linear bytecode that the interpreter can run functions in, instead of
+// walking their trees of expressions.
+//
+// Each function is lowered once, the first time it is called, into a flat
+// array of instructions over a frame of slots. The first slots are the
+// function's locals, and the rest hold temporary values. Branches become jumps
+// to instruction indexes, and calls refer to the called Function directly, so
+// running the code does not look anything up by name or build a Flow for each
+// expression. Semantics are those of the tree-walking interpreter: the
+// instructions keep the original expressions, and the runner computes results,
+// accesses memory and traps using the same code paths as when walking.
+//
+// Only functions whose contents are all supported are lowered, and the others
+// are run by walking them as before, so the two can be mixed freely in a
+// module. Unsupported are multivalue, exception handling, GC, and a few
+// expressions whose children the walker evaluates in the middle of the
+// operation, like memory.fill.
+//
+
+#ifndef wasm_wasm_interpreter_bytecode_h
+#define wasm_wasm_interpreter_bytecode_h
+
+#include <memory>
+#include <vector>
+
+#include "literal.h"
+#include "wasm.h"
+
+namespace wasm {
+
+enum class BytecodeOp : uint8_t {
+  // dst = consts[a]
+  Const,
+  // dst = slots[a]
+  Copy,
+  // dst = the result of running the original expression, which must have no
+  // children. If dst is NoSlot the result, if any, is ignored.
+  Leaf,
+  // dst = unary(slots[a])
+  Unary,
+  // dst = binary(slots[a], slots[b])
+  Binary,
+  // Common i32 operations, which we compute directly.
+  EqZI32,
+  AddI32,
+  SubI32,
+  MulI32,
+  AndI32,
+  OrI32,
+  XorI32,
+  ShlI32,
+  ShrSI32,
+  ShrUI32,
+  EqI32,
+  NeI32,
+  LtSI32,
+  LtUI32,
+  GtSI32,
+  GtUI32,
+  LeSI32,
+  LeUI32,
+  GeSI32,
+  GeUI32,
+  // dst = slots[c] ? slots[a] : slots[b]
+  Select,
+  // Go to instruction a.
+  Jump,
+  // If slots[b] is zero, go to instruction a.
+  JumpIfZero,
+  // If slots[b] is not zero, go to instruction a.
+  JumpIfNonZero,
+  // dst = slots[c], and go to instruction a.
+  CopyAndJump,
+  // If slots[b] is not zero, dst = slots[c] and go to instruction a.
+  CopyAndJumpIfNonZero,
+  // Go to the instruction right after this one plus slots[b], if it is less
+  // than a, or plus a otherwise. Those instructions are the jumps to the
+  // targets, and then to the default.
+  JumpTable,
+  // Return slots[a], or nothing if a is NoSlot.
+  Return,
+  Unreachable,
+  // dst = global, slots[a] = global
+  GlobalSet,
+  // dst = load(slots[a]), store(slots[a], slots[b])
+  Load,
+  Store,
+  // dst = memory.grow(slots[a])
+  MemoryGrow,
+  // dst = call(functions[c], operands), where the operands are in the slots
+  // listed in operands[a .. a + b). For call_indirect the last of those is
+  // the index in the table.
+  Call,
+  CallIndirect,
+};
+
+struct BytecodeInstruction {
+  BytecodeOp op;
+  Index dst;
+  Index a;
+  Index b;
+  Index c;
+  // The expression this was lowered from, if the operation needs it.
+  Expression* expr;
+};
+
+struct BytecodeFunction {
+  // A slot index that means there is no slot.
+  static const Index NoSlot = Index(-1);
+
+  std::vector<BytecodeInstruction> code;
+  std::vector<Literal> consts;
+  std::vector<Index> operands;
+  std::vector<Function*> functions;
+  // The initial values of the locals after the params.
+  std::vector<Literal> varValues;
+  // The number of slots in a frame, including the locals.
+  Index numSlots = 0;
+};
+
+// Lowers a function to bytecode, or returns nullptr if it contains things that
+// we do not support.
+std::unique_ptr<BytecodeFunction> compileToBytecode(Module& wasm,
+                                                    Function* func);
+
+// Whether interpreters run functions as bytecode. Off by default.
+bool getUseBytecode();
+void setUseBytecode(bool useBytecode);
+
+} // namespace wasm
+
+#endif // wasm_wasm_interpreter_bytecode_h
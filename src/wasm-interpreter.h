@@ -32,6 +32,7 @@
 #include "support/bits.h"
 #include "support/safe_integer.h"
 #include "wasm-builder.h"
+#include "wasm-interpreter-bytecode.h"
 #include "wasm-traversal.h"
 #include "wasm.h"
 
@@ -351,6 +352,9 @@ public:
     }
     Literal value = flow.getSingleValue();
     NOTE_EVAL1(value);
+    return evalUnary(curr, value);
+  }
+  Literal evalUnary(Unary* curr, Literal value) {
     switch (curr->op) {
       case ClzInt32:
       case ClzInt64:
@@ -601,6 +605,9 @@ public:
                                          : true);
     assert(curr->right->type.isConcrete() ? right.type == curr->right->type
                                           : true);
+    return evalBinary(curr, left, right);
+  }
+  Literal evalBinary(Binary* curr, const Literal& left, const Literal& right) {
     switch (curr->op) {
       case AddInt32:
       case AddInt64:
@@ -2635,6 +2642,24 @@ private:
   }
 
 public:
+  static void checkArguments(Function* function, const Literals& arguments) {
+    if (function->getParams().size() != arguments.size()) {
+      std::cerr << "Function `" << function->name << "` expects "
+                << function->getParams().size() << " parameters, got "
+                << arguments.size() << " arguments." << std::endl;
+      WASM_UNREACHABLE("invalid param count");
+    }
+    Type params = function->getParams();
+    for (size_t i = 0; i < arguments.size(); i++) {
+      if (!Type::isSubType(arguments[i].type, params[i])) {
+        std::cerr << "Function `" << function->name << "` expects type "
+                  << params[i] << " for parameter " << i << ", got "
+                  << arguments[i].type << "." << std::endl;
+        WASM_UNREACHABLE("invalid param count");
+      }
+    }
+  }
+
   class FunctionScope {
   public:
     std::vector<Literals> locals;
@@ -2650,22 +2675,10 @@ public:
       oldScope = parent.scope;
       parent.scope = this;
 
-      if (function->getParams().size() != arguments.size()) {
-        std::cerr << "Function `" << function->name << "` expects "
-                  << function->getParams().size() << " parameters, got "
-                  << arguments.size() << " arguments." << std::endl;
-        WASM_UNREACHABLE("invalid param count");
-      }
+      checkArguments(function, arguments);
       locals.resize(function->getNumLocals());
-      Type params = function->getParams();
       for (size_t i = 0; i < function->getNumLocals(); i++) {
         if (i < arguments.size()) {
-          if (!Type::isSubType(arguments[i].type, params[i])) {
-            std::cerr << "Function `" << function->name << "` expects type "
-                      << params[i] << " for parameter " << i << ", got "
-                      << arguments[i].type << "." << std::endl;
-            WASM_UNREACHABLE("invalid param count");
-          }
           locals[i] = {arguments[i]};
         } else {
           assert(function->isVar(i));
@@ -2728,7 +2741,7 @@ public:
     if (func->imported()) {
       ret.values = externalInterface->callImport(func, arguments);
     } else {
-      ret.values = callFunctionInternal(curr->target, arguments);
+      ret.values = self()->callFunctionInternal(curr->target, arguments);
     }
 #ifdef WASM_INTERPRETER_DEBUG
     std::cout << "(returned to " << scope->function->name << ")\n";
@@ -2785,7 +2798,7 @@ public:
     if (func->imported()) {
       ret.values = externalInterface->callImport(func, arguments);
     } else {
-      ret.values = callFunctionInternal(funcName, arguments);
+      ret.values = self()->callFunctionInternal(funcName, arguments);
     }
 #ifdef WASM_INTERPRETER_DEBUG
     std::cout << "(returned to " << scope->function->name << ")\n";
@@ -3261,15 +3274,18 @@ public:
   }
   Flow visitMemoryGrow(MemoryGrow* curr) {
     NOTE_ENTER("MemoryGrow");
-    auto* inst = getMemoryInstance();
-    auto indexType = inst->wasm.memory.indexType;
-    auto fail = Literal::makeFromInt64(-1, indexType);
     Flow flow = self()->visit(curr->delta);
     if (flow.breaking()) {
       return flow;
     }
-    Flow ret = Literal::makeFromInt64(inst->memorySize, indexType);
-    uint64_t delta = flow.getSingleValue().getUnsigned();
+    return doMemoryGrow(flow.getSingleValue());
+  }
+  Literal doMemoryGrow(const Literal& deltaValue) {
+    auto* inst = getMemoryInstance();
+    auto indexType = inst->wasm.memory.indexType;
+    auto fail = Literal::makeFromInt64(-1, indexType);
+    Literal ret = Literal::makeFromInt64(inst->memorySize, indexType);
+    uint64_t delta = deltaValue.getUnsigned();
     if (delta > uint32_t(-1) / Memory::kPageSize && indexType == Type::i32) {
       return fail;
     }
@@ -3541,19 +3557,22 @@ public:
   }
 
   // Internal function call. Must be public so that callTable implementations
-  // can use it (refactor?)
+  // can use it (refactor?). Calls in the code we run go through self(), so a
+  // subclass can intercept them by defining its own versions of these.
   Literals callFunctionInternal(Name name, const Literals& arguments) {
+    Function* function = wasm.getFunction(name);
+    assert(function);
+    return callFunctionInternal(function, arguments);
+  }
+
+  Literals callFunctionInternal(Function* function, const Literals& arguments) {
     if (callDepth > maxDepth) {
       externalInterface->trap("stack limit");
     }
     auto previousCallDepth = callDepth;
     callDepth++;
     auto previousFunctionStackSize = functionStack.size();
-    functionStack.push_back(name);
-
-    Function* function = wasm.getFunction(name);
-    assert(function);
-    FunctionScope scope(function, arguments, *self());
+    functionStack.push_back(function->name);
 
 #ifdef WASM_INTERPRETER_DEBUG
     std::cout << "entering " << function->name << "\n  with arguments:\n";
@@ -3562,9 +3581,16 @@ public:
     }
 #endif
 
-    Flow flow = self()->visit(function->body);
-    // cannot still be breaking, it means we missed our stop
-    assert(!flow.breaking() || flow.breakTo == RETURN_FLOW);
+    Flow flow;
+    if (auto* code = getBytecode(function)) {
+      checkArguments(function, arguments);
+      flow = runBytecode(function, *code, arguments);
+    } else {
+      FunctionScope scope(function, arguments, *self());
+      flow = self()->visit(function->body);
+      // cannot still be breaking, it means we missed our stop
+      assert(!flow.breaking() || flow.breakTo == RETURN_FLOW);
+    }
     auto type = flow.getType();
     if (!Type::isSubType(type, function->getResults())) {
       std::cerr << "calling " << function->name << " resulted in " << type
@@ -3586,6 +3612,271 @@ public:
     return flow.values;
   }
 
+private:
+  // Functions lowered to bytecode, or null for functions that we cannot lower.
+  std::unordered_map<Function*, std::unique_ptr<BytecodeFunction>> bytecode;
+
+  // The frames of the functions that run as bytecode, one after the other.
+  std::vector<Literal> bytecodeStack;
+  size_t bytecodeStackTop = 0;
+
+  BytecodeFunction* getBytecode(Function* function) {
+    if (!getUseBytecode()) {
+      return nullptr;
+    }
+    auto iter = bytecode.find(function);
+    if (iter == bytecode.end()) {
+      iter = bytecode.emplace(function, compileToBytecode(wasm, function))
+               .first;
+    }
+    return iter->second.get();
+  }
+
+  Flow runBytecode(Function* function,
+                   const BytecodeFunction& code,
+                   const Literals& arguments) {
+    // Pop our frame however we leave, including by a trap or an exception.
+    struct FramePopper {
+      size_t& top;
+      size_t base;
+      ~FramePopper() { top = base; }
+    } popper{bytecodeStackTop, bytecodeStackTop};
+
+    size_t base = bytecodeStackTop;
+    bytecodeStackTop += code.numSlots;
+    if (bytecodeStack.size() < bytecodeStackTop) {
+      bytecodeStack.resize(
+        std::max(bytecodeStackTop, 2 * bytecodeStack.size()));
+    }
+    // Calls may add frames and reallocate the stack, after which we must reload
+    // this.
+    Literal* slots = &bytecodeStack[base];
+    for (Index i = 0; i < arguments.size(); i++) {
+      slots[i] = arguments[i];
+    }
+    for (Index i = 0; i < code.varValues.size(); i++) {
+      slots[arguments.size() + i] = code.varValues[i];
+    }
+
+    auto getArguments = [&](const BytecodeInstruction& inst) {
+      Literals args;
+      args.reserve(inst.b);
+      for (Index i = 0; i < inst.b; i++) {
+        args.push_back(slots[code.operands[inst.a + i]]);
+      }
+      return args;
+    };
+    auto setResult = [&](Index dst, Literals&& results) {
+      slots = &bytecodeStack[base];
+      if (dst != BytecodeFunction::NoSlot) {
+        slots[dst] = results[0];
+      }
+    };
+
+    const BytecodeInstruction* pc = code.code.data();
+    while (1) {
+      auto& inst = *pc++;
+      switch (inst.op) {
+        case BytecodeOp::Const:
+          slots[inst.dst] = code.consts[inst.a];
+          break;
+        case BytecodeOp::Copy:
+          slots[inst.dst] = slots[inst.a];
+          break;
+        case BytecodeOp::Leaf: {
+          Flow flow = self()->visit(inst.expr);
+          if (inst.dst != BytecodeFunction::NoSlot) {
+            slots[inst.dst] = flow.getSingleValue();
+          }
+          break;
+        }
+        case BytecodeOp::Unary:
+          slots[inst.dst] =
+            self()->evalUnary(inst.expr->template cast<Unary>(), slots[inst.a]);
+          break;
+        case BytecodeOp::Binary:
+          slots[inst.dst] = self()->evalBinary(
+            inst.expr->template cast<Binary>(), slots[inst.a], slots[inst.b]);
+          break;
+        case BytecodeOp::EqZI32:
+          slots[inst.dst] = Literal(int32_t(slots[inst.a].geti32() == 0));
+          break;
+        case BytecodeOp::AddI32:
+          slots[inst.dst] = Literal(
+            int32_t(uint32_t(slots[inst.a].geti32()) +
+                    uint32_t(slots[inst.b].geti32())));
+          break;
+        case BytecodeOp::SubI32:
+          slots[inst.dst] = Literal(
+            int32_t(uint32_t(slots[inst.a].geti32()) -
+                    uint32_t(slots[inst.b].geti32())));
+          break;
+        case BytecodeOp::MulI32:
+          slots[inst.dst] = Literal(
+            int32_t(uint32_t(slots[inst.a].geti32()) *
+                    uint32_t(slots[inst.b].geti32())));
+          break;
+        case BytecodeOp::AndI32:
+          slots[inst.dst] =
+            Literal(slots[inst.a].geti32() & slots[inst.b].geti32());
+          break;
+        case BytecodeOp::OrI32:
+          slots[inst.dst] =
+            Literal(slots[inst.a].geti32() | slots[inst.b].geti32());
+          break;
+        case BytecodeOp::XorI32:
+          slots[inst.dst] =
+            Literal(slots[inst.a].geti32() ^ slots[inst.b].geti32());
+          break;
+        case BytecodeOp::ShlI32:
+          slots[inst.dst] =
+            Literal(int32_t(uint32_t(slots[inst.a].geti32())
+                            << (slots[inst.b].geti32() & 31)));
+          break;
+        case BytecodeOp::ShrSI32:
+          slots[inst.dst] = Literal(slots[inst.a].geti32() >>
+                                    (slots[inst.b].geti32() & 31));
+          break;
+        case BytecodeOp::ShrUI32:
+          slots[inst.dst] = Literal(int32_t(
+            uint32_t(slots[inst.a].geti32()) >> (slots[inst.b].geti32() & 31)));
+          break;
+        case BytecodeOp::EqI32:
+          slots[inst.dst] =
+            Literal(int32_t(slots[inst.a].geti32() == slots[inst.b].geti32()));
+          break;
+        case BytecodeOp::NeI32:
+          slots[inst.dst] =
+            Literal(int32_t(slots[inst.a].geti32() != slots[inst.b].geti32()));
+          break;
+        case BytecodeOp::LtSI32:
+          slots[inst.dst] =
+            Literal(int32_t(slots[inst.a].geti32() < slots[inst.b].geti32()));
+          break;
+        case BytecodeOp::LtUI32:
+          slots[inst.dst] = Literal(int32_t(uint32_t(slots[inst.a].geti32()) <
+                                            uint32_t(slots[inst.b].geti32())));
+          break;
+        case BytecodeOp::GtSI32:
+          slots[inst.dst] =
+            Literal(int32_t(slots[inst.a].geti32() > slots[inst.b].geti32()));
+          break;
+        case BytecodeOp::GtUI32:
+          slots[inst.dst] = Literal(int32_t(uint32_t(slots[inst.a].geti32()) >
+                                            uint32_t(slots[inst.b].geti32())));
+          break;
+        case BytecodeOp::LeSI32:
+          slots[inst.dst] =
+            Literal(int32_t(slots[inst.a].geti32() <= slots[inst.b].geti32()));
+          break;
+        case BytecodeOp::LeUI32:
+          slots[inst.dst] = Literal(int32_t(uint32_t(slots[inst.a].geti32()) <=
+                                            uint32_t(slots[inst.b].geti32())));
+          break;
+        case BytecodeOp::GeSI32:
+          slots[inst.dst] =
+            Literal(int32_t(slots[inst.a].geti32() >= slots[inst.b].geti32()));
+          break;
+        case BytecodeOp::GeUI32:
+          slots[inst.dst] = Literal(int32_t(uint32_t(slots[inst.a].geti32()) >=
+                                            uint32_t(slots[inst.b].geti32())));
+          break;
+        case BytecodeOp::Select:
+          slots[inst.dst] =
+            slots[inst.c].geti32() ? slots[inst.a] : slots[inst.b];
+          break;
+        case BytecodeOp::Jump:
+          pc = &code.code[inst.a];
+          break;
+        case BytecodeOp::JumpIfZero:
+          if (slots[inst.b].geti32() == 0) {
+            pc = &code.code[inst.a];
+          }
+          break;
+        case BytecodeOp::JumpIfNonZero:
+          if (slots[inst.b].geti32() != 0) {
+            pc = &code.code[inst.a];
+          }
+          break;
+        case BytecodeOp::CopyAndJump:
+          slots[inst.dst] = slots[inst.c];
+          pc = &code.code[inst.a];
+          break;
+        case BytecodeOp::CopyAndJumpIfNonZero:
+          if (slots[inst.b].geti32() != 0) {
+            slots[inst.dst] = slots[inst.c];
+            pc = &code.code[inst.a];
+          }
+          break;
+        case BytecodeOp::JumpTable: {
+          uint32_t index = slots[inst.b].geti32();
+          pc += index < inst.a ? index : inst.a;
+          break;
+        }
+        case BytecodeOp::Return:
+          if (inst.a == BytecodeFunction::NoSlot) {
+            return Flow();
+          }
+          return Flow(slots[inst.a]);
+        case BytecodeOp::Unreachable:
+          trap("unreachable");
+          WASM_UNREACHABLE("unreachable");
+        case BytecodeOp::GlobalSet:
+          getGlobal(inst.expr->template cast<GlobalSet>()->name) = {
+            slots[inst.a]};
+          break;
+        case BytecodeOp::Load: {
+          auto* curr = inst.expr->template cast<Load>();
+          auto* memory = getMemoryInstance();
+          auto addr = memory->getFinalAddress(curr, slots[inst.a]);
+          if (curr->isAtomic) {
+            memory->checkAtomicAddress(addr, curr->bytes);
+          }
+          slots[inst.dst] = memory->externalInterface->load(curr, addr);
+          break;
+        }
+        case BytecodeOp::Store: {
+          auto* curr = inst.expr->template cast<Store>();
+          auto* memory = getMemoryInstance();
+          auto addr = memory->getFinalAddress(curr, slots[inst.a]);
+          if (curr->isAtomic) {
+            memory->checkAtomicAddress(addr, curr->bytes);
+          }
+          memory->externalInterface->store(curr, addr, slots[inst.b]);
+          break;
+        }
+        case BytecodeOp::MemoryGrow:
+          slots[inst.dst] = doMemoryGrow(slots[inst.a]);
+          break;
+        case BytecodeOp::Call: {
+          auto* target = code.functions[inst.c];
+          auto args = getArguments(inst);
+          if (target->imported()) {
+            setResult(inst.dst, externalInterface->callImport(target, args));
+          } else {
+            setResult(inst.dst, self()->callFunctionInternal(target, args));
+          }
+          break;
+        }
+        case BytecodeOp::CallIndirect: {
+          auto* curr = inst.expr->template cast<CallIndirect>();
+          auto args = getArguments(inst);
+          Index index = args.back().geti32();
+          args.pop_back();
+          Type type =
+            curr->isReturn ? curr->heapType.getSignature().results : curr->type;
+          auto info = getTableInterfaceInfo(curr->table);
+          setResult(inst.dst,
+                    info.interface->callTable(
+                      info.name, index, curr->heapType, args, type, *self()));
+          break;
+        }
+      }
+    }
+  }
+
+public:
+
   // The maximum call stack depth to evaluate into.
   static const Index maxDepth = 250;
 
@@ -53,6 +53,12 @@ public:
     skipFunctionBodies = skipFunctionBodies_;
   }
 
+  // Whether to decode function bodies in binaries in parallel. This is on by
+  // default as the result is identical to a serial read.
+  void setParallelFunctionBodies(bool parallelFunctionBodies_) {
+    parallelFunctionBodies = parallelFunctionBodies_;
+  }
+
   // read text
   void readText(std::string filename, Module& wasm);
   // read binary
@@ -73,9 +79,11 @@ private:
 
   bool skipFunctionBodies = false;
 
+  bool parallelFunctionBodies = true;
+
   void readStdin(Module& wasm, std::string sourceMapFilename);
 
-  void readBinaryData(std::vector<char>& input,
+  void readBinaryData(std::string_view input,
                       Module& wasm,
                       std::string sourceMapFilename);
 };
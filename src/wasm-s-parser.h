@@ -120,14 +120,30 @@ class SExpressionWasmBuilder {
   MixedArena& allocator;
   IRProfile profile;
 
+  // Information about the module that is gathered before function bodies are
+  // parsed, and only read while parsing them. When function bodies are parsed
+  // in parallel, the builders that parse them share it with this one.
+  struct ModuleInfo {
+    std::vector<HeapType> types;
+    std::unordered_map<std::string, size_t> typeIndices;
+    std::vector<Name> functionNames;
+    std::vector<Name> tableNames;
+    std::vector<Name> globalNames;
+    std::vector<Name> tagNames;
+    std::map<Name, HeapType> functionTypes;
+    std::unordered_map<cashew::IString, Index> debugInfoFileIndices;
+    std::unordered_map<size_t, std::unordered_map<Index, Name>> fieldNames;
+  };
+  std::shared_ptr<ModuleInfo> info = std::make_shared<ModuleInfo>();
+
   // The main list of types declared in the module
-  std::vector<HeapType> types;
-  std::unordered_map<std::string, size_t> typeIndices;
+  std::vector<HeapType>& types = info->types;
+  std::unordered_map<std::string, size_t>& typeIndices = info->typeIndices;
 
-  std::vector<Name> functionNames;
-  std::vector<Name> tableNames;
-  std::vector<Name> globalNames;
-  std::vector<Name> tagNames;
+  std::vector<Name>& functionNames = info->functionNames;
+  std::vector<Name>& tableNames = info->tableNames;
+  std::vector<Name>& globalNames = info->globalNames;
+  std::vector<Name>& tagNames = info->tagNames;
   int functionCounter = 0;
   int globalCounter = 0;
   int tagCounter = 0;
@@ -135,8 +151,9 @@ class SExpressionWasmBuilder {
   int elemCounter = 0;
   int memoryCounter = 0;
   // we need to know function return types before we parse their contents
-  std::map<Name, HeapType> functionTypes;
-  std::unordered_map<cashew::IString, Index> debugInfoFileIndices;
+  std::map<Name, HeapType>& functionTypes = info->functionTypes;
+  std::unordered_map<cashew::IString, Index>& debugInfoFileIndices =
+    info->debugInfoFileIndices;
 
   // Maps type indexes to a mapping of field index => name. This is not the same
   // as the field names stored on the wasm object, as that maps types after
@@ -144,13 +161,18 @@ class SExpressionWasmBuilder {
   // that structurally identical types cannot have different names. However,
   // while parsing the text format we keep this mapping of type indexes to names
   // which does allow reading such content.
-  std::unordered_map<size_t, std::unordered_map<Index, Name>> fieldNames;
+  std::unordered_map<size_t, std::unordered_map<Index, Name>>& fieldNames =
+    info->fieldNames;
 
 public:
   // Assumes control of and modifies the input.
   SExpressionWasmBuilder(Module& wasm, Element& module, IRProfile profile);
 
 private:
+  // Creates a builder that parses function bodies for a parent builder, on
+  // another thread.
+  SExpressionWasmBuilder(SExpressionWasmBuilder* parent);
+
   void preParseHeapTypes(Element& module);
   // pre-parse types and function definitions, so we know function return types
   // before parsing their contents
@@ -160,11 +182,37 @@ private:
   void parseModuleElement(Element& curr);
 
   // function parsing state
-  std::unique_ptr<Function> currFunction;
+  Function* currFunction = nullptr;
   bool brokeToAutoBlock;
 
   UniqueNameMapper nameMapper;
 
+  // Function bodies are parsed after the rest of the module, in parallel when
+  // there are threads. Until then, the functions are in the module without
+  // bodies, and we note where their bodies are.
+  struct PendingFunction {
+    Function* func;
+    Element* s;
+    // The index in s where the body starts.
+    Index bodyStart;
+  };
+  bool deferFunctionBodies = false;
+  std::vector<PendingFunction> pendingFunctions;
+
+  // Whether this builder parses function bodies for a parent builder, and
+  // whether the last body it parsed must be parsed again by the parent, in the
+  // order of the functions. That is the case when the result depends on the
+  // functions before it: when it makes label names unique using a counter
+  // that is shared by all the functions, or when it mentions a new file in
+  // its debug info. It is also the case on errors, so that the error for the
+  // first function is reported.
+  bool isFunctionBodyBuilder = false;
+  bool needsParseInOrder = false;
+
+  void parseFunctionBody(Function* func, Element& s, Index i);
+  void parsePendingFunctionBodies();
+  void parsePendingFunctionBodiesInOrder();
+
   Name getFunctionName(Element& s);
   Name getTableName(Element& s);
   Name getGlobalName(Element& s);
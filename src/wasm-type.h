@@ -51,6 +51,18 @@ void setTypeSystem(TypeSystem system);
 
 TypeSystem getTypeSystem();
 
+// Counts of the times that creating a type had to wait for another thread to
+// release the lock on one of the global stores of canonical types. This is
+// useful for profiling multithreaded code that creates many types.
+struct TypeStoreStats {
+  size_t typeContention = 0;
+  size_t heapTypeContention = 0;
+  size_t recGroupContention = 0;
+  size_t signatureContention = 0;
+};
+
+TypeStoreStats getTypeStoreStats();
+
 // Dangerous! Frees all types and heap types that have ever been created and
 // resets the type system's internal state. This is only really meant to be used
 // for tests.
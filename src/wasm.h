@@ -682,11 +682,14 @@ public:
     RefAsId,
     NumExpressionIds
   };
-  Id _id;
 
   // the type of the expression: its *output*, not necessarily its input(s)
   Type type = Type::none;
 
+  // This comes after the type, so that a 32-bit field in a subclass can be
+  // placed in the padding after it, which makes many nodes 8 bytes smaller.
+  Id _id;
+
   Expression(Id id) : _id(id) {}
 
   void finalize() {}
@@ -842,9 +845,9 @@ class Call : public SpecificExpression<Expression::CallId> {
 public:
   Call(MixedArena& allocator) : operands(allocator) {}
 
+  bool isReturn = false;
   ExpressionList operands;
   Name target;
-  bool isReturn = false;
 
   void finalize();
 };
@@ -852,11 +855,11 @@ public:
 class CallIndirect : public SpecificExpression<Expression::CallIndirectId> {
 public:
   CallIndirect(MixedArena& allocator) : operands(allocator) {}
+  bool isReturn = false;
   HeapType heapType;
   ExpressionList operands;
   Expression* target;
   Name table;
-  bool isReturn = false;
 
   void finalize();
 };
@@ -1393,8 +1396,8 @@ class TupleExtract : public SpecificExpression<Expression::TupleExtractId> {
 public:
   TupleExtract(MixedArena& allocator) {}
 
-  Expression* tuple;
   Index index;
+  Expression* tuple;
 
   void finalize();
 };
@@ -1412,8 +1415,8 @@ class I31Get : public SpecificExpression<Expression::I31GetId> {
 public:
   I31Get(MixedArena& allocator) {}
 
-  Expression* i31;
   bool signed_ = false;
+  Expression* i31;
 
   void finalize();
 };
@@ -1421,9 +1424,9 @@ public:
 class CallRef : public SpecificExpression<Expression::CallRefId> {
 public:
   CallRef(MixedArena& allocator) : operands(allocator) {}
+  bool isReturn = false;
   ExpressionList operands;
   Expression* target;
-  bool isReturn = false;
 
   void finalize();
   void finalize(Type type_);
@@ -1589,10 +1592,10 @@ class ArrayGet : public SpecificExpression<Expression::ArrayGetId> {
 public:
   ArrayGet(MixedArena& allocator) {}
 
-  Expression* ref;
-  Expression* index;
   // Packed fields have a sign.
   bool signed_ = false;
+  Expression* ref;
+  Expression* index;
 
   void finalize();
 };
@@ -23,6 +23,7 @@
 #include "ir/type-updating.h"
 #include "support/bits.h"
 #include "support/debug.h"
+#include "support/threads.h"
 #include "wasm-binary.h"
 #include "wasm-debug.h"
 #include "wasm-stack.h"
@@ -31,6 +32,32 @@
 
 namespace wasm {
 
+namespace {
+
+size_t getU32LEBSize(uint32_t value) {
+  size_t size = 1;
+  while (value >= 128) {
+    value >>= 7;
+    size++;
+  }
+  return size;
+}
+
+// When streaming, how much of the code section we accumulate before writing
+// it out.
+const size_t StreamingChunkSize = 1 << 20;
+
+// How many bytes of function bodies we encode in a batch before appending them
+// to the code section, and the most functions in a batch.
+const size_t FunctionBatchBytes = 1 << 22;
+const size_t MaxFunctionBatch = 1 << 12;
+
+// When streaming, how many bytes of function bodies we keep from measuring
+// the code section, to write them without encoding them again.
+const size_t StreamingKeptBytes = 1 << 24;
+
+} // anonymous namespace
+
 void WasmBinaryWriter::prepare() {
   // Collect function types and their frequencies. Collect information in each
   // function in parallel, then merge.
@@ -78,13 +105,17 @@ void WasmBinaryWriter::write() {
 #ifdef BUILD_LLVM_DWARF
   // Update DWARF user sections after writing the data they refer to
   // (function bodies), and before writing the user sections themselves.
-  if (Debug::hasDWARFSections(*wasm)) {
+  if (updateDWARF && Debug::hasDWARFSections(*wasm)) {
     Debug::writeDWARFSections(*wasm, binaryLocations);
   }
 #endif
 
   writeLateUserSections();
   writeFeaturesSection();
+
+  if (outputStream) {
+    flushToOutputStream();
+  }
 }
 
 void WasmBinaryWriter::writeHeader() {
@@ -93,6 +124,12 @@ void WasmBinaryWriter::writeHeader() {
   o << int32_t(BinaryConsts::Version);
 }
 
+void WasmBinaryWriter::flushToOutputStream() {
+  outputStream->write(reinterpret_cast<const char*>(o.data()), o.size());
+  flushedBytes += o.size();
+  o.clear();
+}
+
 int32_t WasmBinaryWriter::writeU32LEBPlaceholder() {
   int32_t ret = o.size();
   o << int32_t(0);
@@ -120,11 +157,16 @@ void WasmBinaryWriter::writeResizableLimits(
 }
 
 template<typename T> int32_t WasmBinaryWriter::startSection(T code) {
+  if constexpr (std::is_same_v<T, BinaryConsts::Section>) {
+    // Everything before a new section is final.
+    if (outputStream) {
+      flushToOutputStream();
+    }
+  }
   o << uint8_t(code);
   if (sourceMap) {
     sourceMapLocationsSizeAtSectionStart = sourceMapLocations.size();
   }
-  binaryLocationsSizeAtSectionStart = binaryLocations.expressions.size();
   return writeU32LEBPlaceholder(); // section size to be filled in later
 }
 
@@ -151,36 +193,6 @@ void WasmBinaryWriter::finishSection(int32_t start) {
       }
     }
   }
-
-  if (binaryLocationsSizeAtSectionStart != binaryLocations.expressions.size()) {
-    // We added the binary locations, adjust them: they must be relative
-    // to the code section.
-    assert(binaryLocationsSizeAtSectionStart == 0);
-    // The section type byte is right before the LEB for the size; we want
-    // offsets that are relative to the body, which is after that section type
-    // byte and the the size LEB.
-    auto body = start + sizeFieldSize;
-    // Offsets are relative to the body of the code section: after the
-    // section type byte and the size.
-    // Everything was moved by the adjustment, track that. After this,
-    // we are at the right absolute address.
-    // We are relative to the section start.
-    auto totalAdjustment = adjustmentForLEBShrinking + body;
-    for (auto& [_, locations] : binaryLocations.expressions) {
-      locations.start -= totalAdjustment;
-      locations.end -= totalAdjustment;
-    }
-    for (auto& [_, locations] : binaryLocations.functions) {
-      locations.start -= totalAdjustment;
-      locations.declarations -= totalAdjustment;
-      locations.end -= totalAdjustment;
-    }
-    for (auto& [_, locations] : binaryLocations.delimiters) {
-      for (auto& item : locations) {
-        item -= totalAdjustment;
-      }
-    }
-  }
 }
 
 int32_t
@@ -372,78 +384,225 @@ void WasmBinaryWriter::writeFunctions() {
     return;
   }
   BYN_TRACE("== writeFunctions\n");
-  auto sectionStart = startSection(BinaryConsts::Section::Code);
-  o << U32LEB(importInfo->getNumDefinedFunctions());
   bool DWARF = Debug::hasDWARFSections(*getModule());
-  ModuleUtils::iterDefinedFunctions(*wasm, [&](Function* func) {
-    assert(binaryLocationTrackedExpressionsForFunc.empty());
-    size_t sourceMapLocationsSizeAtFunctionStart = sourceMapLocations.size();
-    BYN_TRACE("write one at" << o.size() << std::endl);
-    size_t sizePos = writeU32LEBPlaceholder();
-    size_t start = o.size();
-    BYN_TRACE("writing" << func->name << std::endl);
-    // Emit Stack IR if present, and if we can
-    if (func->stackIR && !sourceMap && !DWARF) {
-      BYN_TRACE("write Stack IR\n");
-      StackIRToBinaryWriter writer(*this, o, func);
-      writer.write();
-      if (debugInfo) {
-        funcMappedLocals[func->name] = std::move(writer.getMappedLocals());
-      }
-    } else {
-      BYN_TRACE("write Binaryen IR\n");
-      BinaryenIRToBinaryWriter writer(*this, o, func, sourceMap, DWARF);
-      writer.write();
-      if (debugInfo) {
-        funcMappedLocals[func->name] = std::move(writer.getMappedLocals());
-      }
-    }
-    size_t size = o.size() - start;
-    assert(size <= std::numeric_limits<uint32_t>::max());
-    BYN_TRACE("body size: " << size << ", writing at " << sizePos
-                            << ", next starts at " << o.size() << "\n");
-    auto sizeFieldSize = o.writeAt(sizePos, U32LEB(size));
-    // We can move things back if the actual LEB for the size doesn't use the
-    // maximum 5 bytes. In that case we need to adjust offsets after we move
-    // things backwards.
-    auto adjustmentForLEBShrinking = MaxLEB32Bytes - sizeFieldSize;
-    if (adjustmentForLEBShrinking) {
-      // we can save some room, nice
-      assert(sizeFieldSize < MaxLEB32Bytes);
-      std::move(&o[start], &o[start] + size, &o[sizePos] + sizeFieldSize);
-      o.resize(o.size() - adjustmentForLEBShrinking);
-      if (sourceMap) {
-        for (auto i = sourceMapLocationsSizeAtFunctionStart;
-             i < sourceMapLocations.size();
-             ++i) {
-          sourceMapLocations[i].first -= adjustmentForLEBShrinking;
-        }
-      }
-      for (auto* curr : binaryLocationTrackedExpressionsForFunc) {
-        // We added the binary locations, adjust them: they must be relative
-        // to the code section.
-        auto& span = binaryLocations.expressions[curr];
-        span.start -= adjustmentForLEBShrinking;
-        span.end -= adjustmentForLEBShrinking;
-        auto iter = binaryLocations.delimiters.find(curr);
-        if (iter != binaryLocations.delimiters.end()) {
-          for (auto& item : iter->second) {
-            item -= adjustmentForLEBShrinking;
-          }
-        }
-      }
+  std::vector<Function*> funcs;
+  ModuleUtils::iterDefinedFunctions(
+    *wasm, [&](Function* func) { funcs.push_back(func); });
+
+  // Each thread encodes using a writer of its own, as writers keep state about
+  // the current function. The writers share nothing that they modify.
+  size_t numWriters = 1;
+  if (funcs.size() > 1) {
+    numWriters = ThreadPool::get()->size();
+  }
+  std::vector<BufferWithRandomAccess> buffers(numWriters);
+  std::vector<std::unique_ptr<WasmBinaryWriter>> writers;
+  for (size_t i = 0; i < numWriters; i++) {
+    writers.push_back(std::unique_ptr<WasmBinaryWriter>(
+      new WasmBinaryWriter(*this, buffers[i])));
+  }
+
+  // Encode the functions in parallel, in batches, appending each batch in
+  // order and freeing it before we encode the next one.
+  std::vector<EncodedFunction> batch;
+  auto appendFrom = [&](Index start, size_t sectionBody) {
+    for (Index i = start; i < funcs.size();) {
+      auto num = encodeFunctions(writers, funcs, i, batch, DWARF);
+      for (Index j = 0; j < num; j++) {
+        appendFunction(funcs[i + j], batch[j], sectionBody);
+      }
+      i += num;
+    }
+  };
+
+  if (!outputStream) {
+    auto start = startSection(BinaryConsts::Section::Code);
+    // Binary locations in the code section are relative to its body, so they
+    // stay valid when finishSection() moves the body back.
+    size_t sectionBody = getPosition();
+    auto firstEntry = tableOfContents.functionBodies.size();
+    o << U32LEB(funcs.size());
+    appendFrom(0, sectionBody);
+    auto unfinishedSize = o.size();
+    finishSection(start);
+    auto moved = unfinishedSize - o.size();
+    for (auto i = firstEntry; i < tableOfContents.functionBodies.size(); i++) {
+      tableOfContents.functionBodies[i].offset -= moved;
     }
-    if (!binaryLocationTrackedExpressionsForFunc.empty()) {
-      binaryLocations.functions[func] = BinaryLocations::FunctionLocations{
-        BinaryLocation(sizePos),
-        BinaryLocation(start - adjustmentForLEBShrinking),
-        BinaryLocation(o.size())};
+    return;
+  }
+
+  // When streaming we cannot move what we have written, so we need the size
+  // of the section before we write any of it. Encode all the functions to
+  // measure them, keeping the encodings of the first ones, up to a limit, and
+  // encode the rest again when we write them. Smaller modules are therefore
+  // encoded just once.
+  std::vector<EncodedFunction> kept;
+  size_t keptBytes = 0;
+  size_t sectionSize = getU32LEBSize(funcs.size());
+  for (Index i = 0; i < funcs.size();) {
+    auto num = encodeFunctions(writers, funcs, i, batch, DWARF);
+    for (Index j = 0; j < num; j++) {
+      size_t size = batch[j].body.size();
+      assert(size <= std::numeric_limits<uint32_t>::max());
+      sectionSize += getU32LEBSize(size) + size;
+      if (kept.size() == i + j && keptBytes + size <= StreamingKeptBytes) {
+        kept.push_back(std::move(batch[j]));
+        keptBytes += size;
+      }
+    }
+    i += num;
+  }
+  if (sectionSize > std::numeric_limits<uint32_t>::max()) {
+    Fatal() << "code section too large";
+  }
+  flushToOutputStream();
+  o << uint8_t(BinaryConsts::Section::Code);
+  o << U32LEB(sectionSize);
+  size_t sectionBody = getPosition();
+  o << U32LEB(funcs.size());
+  for (Index i = 0; i < kept.size(); i++) {
+    appendFunction(funcs[i], kept[i], sectionBody);
+  }
+  Index numKept = kept.size();
+  std::vector<EncodedFunction>().swap(kept);
+  appendFrom(numKept, sectionBody);
+  // Encoding is deterministic, so the functions we encoded again have the
+  // sizes we measured.
+  assert(getPosition() - sectionBody == sectionSize);
+}
+
+void WasmBinaryWriter::appendFunction(Function* func,
+                                      EncodedFunction& curr,
+                                      size_t sectionBody) {
+  size_t size = curr.body.size();
+  size_t sizePos = getPosition();
+  o << U32LEB(size);
+  size_t start = getPosition();
+  BYN_TRACE("body size: " << size << ", writing at " << sizePos
+                          << ", next starts at " << start + size << "\n");
+  o.insert(o.end(), curr.body.begin(), curr.body.end());
+  BufferWithRandomAccess().swap(curr.body);
+  if (sourceMap) {
+    // Debug locations that repeat the previous one are omitted, which the
+    // function's own encoding could not know about at its start.
+    for (auto& [offset, loc] : curr.sourceMapLocations) {
+      if (lastDebugLocation && *loc == *lastDebugLocation) {
+        continue;
+      }
+      sourceMapLocations.emplace_back(start + offset, loc);
+      lastDebugLocation = *loc;
+    }
+  }
+  // Binary locations of the function are relative to its body, adjust them
+  // to be relative to the body of the section.
+  auto bodyOffset = start - sectionBody;
+  for (auto& [expr, span] : curr.binaryLocations.expressions) {
+    binaryLocations.expressions[expr] =
+      BinaryLocations::Span{BinaryLocation(bodyOffset + span.start),
+                            BinaryLocation(bodyOffset + span.end)};
+  }
+  for (auto& [expr, locations] : curr.binaryLocations.delimiters) {
+    auto& delimiters = binaryLocations.delimiters[expr];
+    delimiters = locations;
+    for (auto& item : delimiters) {
+      // Delimiters that were never set are zero, which means there is no
+      // location, and must stay that way.
+      if (item) {
+        item += bodyOffset;
+      }
+    }
+  }
+  if (!curr.binaryLocations.expressions.empty()) {
+    binaryLocations.functions[func] = BinaryLocations::FunctionLocations{
+      BinaryLocation(sizePos - sectionBody),
+      BinaryLocation(bodyOffset),
+      BinaryLocation(getPosition() - sectionBody)};
+  }
+  if (debugInfo) {
+    funcMappedLocals[func->name] = std::move(curr.mappedLocals);
+  }
+  tableOfContents.functionBodies.emplace_back(func->name, start, size);
+  if (outputStream && o.size() >= StreamingChunkSize) {
+    flushToOutputStream();
+  }
+}
+
+Index WasmBinaryWriter::encodeFunctions(
+  std::vector<std::unique_ptr<WasmBinaryWriter>>& writers,
+  const std::vector<Function*>& funcs,
+  Index start,
+  std::vector<EncodedFunction>& encoded,
+  bool DWARF) {
+  size_t end = std::min(funcs.size(), size_t(start) + MaxFunctionBatch);
+  encoded.clear();
+  encoded.resize(end - start);
+
+  // Threads stop taking functions once the batch has enough bytes. They check
+  // that before they take one, so every function that was taken is encoded,
+  // and the batch is all the functions before the next one to take.
+  std::vector<std::function<ThreadWorkState()>> doWorkers;
+  std::atomic<size_t> nextFunction;
+  nextFunction.store(start);
+  std::atomic<size_t> batchBytes;
+  batchBytes.store(0);
+  for (size_t i = 0; i < writers.size(); i++) {
+    doWorkers.push_back([&, i]() {
+      if (batchBytes.load() >= FunctionBatchBytes) {
+        return ThreadWorkState::Finished;
+      }
+      auto index = nextFunction.fetch_add(1);
+      if (index >= end) {
+        return ThreadWorkState::Finished;
+      }
+      auto& out = encoded[index - start];
+      writers[i]->encodeFunction(funcs[index], DWARF, out);
+      batchBytes.fetch_add(out.body.size());
+      if (index + 1 == end) {
+        return ThreadWorkState::Finished;
+      }
+      return ThreadWorkState::More;
+    });
+  }
+  if (writers.size() == 1) {
+    while (doWorkers[0]() == ThreadWorkState::More) {
     }
-    tableOfContents.functionBodies.emplace_back(
-      func->name, sizePos + sizeFieldSize, size);
-    binaryLocationTrackedExpressionsForFunc.clear();
-  });
-  finishSection(sectionStart);
+  } else {
+    ThreadPool::get()->work(doWorkers);
+  }
+  Index num = std::min(nextFunction.load(), end) - start;
+  encoded.resize(num);
+  return num;
+}
+
+void WasmBinaryWriter::encodeFunction(Function* func,
+                                      bool DWARF,
+                                      EncodedFunction& out) {
+  assert(o.empty());
+  assert(binaryLocationTrackedExpressionsForFunc.empty());
+  BYN_TRACE("writing" << func->name << std::endl);
+  // Emit Stack IR if present, and if we can
+  if (func->stackIR && !sourceMap && !DWARF) {
+    BYN_TRACE("write Stack IR\n");
+    StackIRToBinaryWriter writer(*this, o, func);
+    writer.write();
+    if (debugInfo) {
+      out.mappedLocals = std::move(writer.getMappedLocals());
+    }
+  } else {
+    BYN_TRACE("write Binaryen IR\n");
+    BinaryenIRToBinaryWriter writer(*this, o, func, sourceMap, DWARF);
+    writer.write();
+    if (debugInfo) {
+      out.mappedLocals = std::move(writer.getMappedLocals());
+    }
+  }
+  // Hand over the results, leaving this writer empty for the next function.
+  out.body.swap(o);
+  out.sourceMapLocations.swap(sourceMapLocations);
+  std::swap(out.binaryLocations, binaryLocations);
+  binaryLocationTrackedExpressionsForFunc.clear();
+  lastDebugLocation.reset();
 }
 
 void WasmBinaryWriter::writeGlobals() {
@@ -1168,7 +1327,7 @@ void WasmBinaryWriter::writeDylinkSection() {
 }
 
 void WasmBinaryWriter::writeDebugLocation(const Function::DebugLocation& loc) {
-  if (loc == lastDebugLocation) {
+  if (lastDebugLocation && loc == *lastDebugLocation) {
     return;
   }
   auto offset = o.size();
@@ -1381,7 +1540,7 @@ void WasmBinaryWriter::writeField(const Field& field) {
 
 WasmBinaryBuilder::WasmBinaryBuilder(Module& wasm,
                                      FeatureSet features,
-                                     const std::vector<char>& input)
+                                     std::string_view input)
   : wasm(wasm), allocator(wasm.allocator), input(input), sourceMap(nullptr),
     nextDebugLocation(0, {0, 0, 0}), debugLocation() {
   wasm.features = features;
@@ -1806,14 +1965,14 @@ Name WasmBinaryBuilder::getInlineString() {
 
   auto data = getByteView(len);
 
-  std::string str(data.first, data.second);
-  if (str.find('\0') != std::string::npos) {
+  std::string_view str(data.first, data.second - data.first);
+  if (str.find('\0') != std::string_view::npos) {
     throwError(
       "inline string contains NULL (0). that is technically valid in wasm, "
       "but you shouldn't do it, and it's not supported in binaryen");
   }
   BYN_TRACE("getInlineString: " << str << " ==>\n");
-  return Name(str);
+  return cashew::IString(str);
 }
 
 void WasmBinaryBuilder::verifyInt8(int8_t x) {
@@ -2248,6 +2407,10 @@ void WasmBinaryBuilder::readFunctions() {
   if (total != functionTypes.size() - functionImports.size()) {
     throwError("invalid function section size, must equal types");
   }
+  if (shouldReadFunctionsInParallel(total)) {
+    readFunctionsInParallel(total);
+    return;
+  }
   for (size_t i = 0; i < total; i++) {
     BYN_TRACE("read one at " << pos << std::endl);
     auto sizePos = pos;
@@ -2255,83 +2418,255 @@ void WasmBinaryBuilder::readFunctions() {
     if (size == 0) {
       throwError("empty function size");
     }
-    endOfFunction = pos + size;
 
     auto* func = new Function;
     func->name = Name::fromInt(i);
     func->type = getTypeByFunctionIndex(functionImports.size() + i);
-    currFunction = func;
-
-    if (DWARF) {
-      func->funcLocation = BinaryLocations::FunctionLocations{
-        BinaryLocation(sizePos - codeSectionLocation),
-        BinaryLocation(pos - codeSectionLocation),
-        BinaryLocation(pos - codeSectionLocation + size)};
-    }
-
-    readNextDebugLocation();
-
-    BYN_TRACE("reading " << i << std::endl);
-
-    readVars();
-
-    std::swap(func->prologLocation, debugLocation);
-    {
-      // process the function body
-      BYN_TRACE("processing function: " << i << std::endl);
-      nextLabel = 0;
-      debugLocation.clear();
-      willBeIgnored = false;
-      // process body
-      assert(breakStack.empty());
-      assert(breakTargetNames.empty());
-      assert(exceptionTargetNames.empty());
-      assert(expressionStack.empty());
-      assert(controlFlowStack.empty());
-      assert(letStack.empty());
-      assert(depth == 0);
-      // Even if we are skipping function bodies we need to not skip the start
-      // function. That contains important code for wasm-emscripten-finalize in
-      // the form of pthread-related segment initializations. As this is just
-      // one function, it doesn't add significant time, so the optimization of
-      // skipping bodies is still very useful.
-      auto currFunctionIndex = functionImports.size() + functions.size();
-      bool isStart = startIndex == currFunctionIndex;
-      if (!skipFunctionBodies || isStart) {
-        func->body = getBlockOrSingleton(func->getResults());
-      } else {
-        // When skipping the function body we need to put something valid in
-        // their place so we validate. An unreachable is always acceptable
-        // there.
-        func->body = Builder(wasm).makeUnreachable();
+    readFunctionBody(func, i, sizePos, size);
+    functions.push_back(func);
+  }
+  BYN_TRACE(" end function bodies\n");
+}
 
-        // Skip reading the contents.
-        pos = endOfFunction;
-      }
-      assert(depth == 0);
-      assert(breakStack.empty());
-      assert(breakTargetNames.empty());
-      assert(exceptionTargetNames.empty());
-      if (!expressionStack.empty()) {
-        throwError("stack not empty on function exit");
-      }
-      assert(controlFlowStack.empty());
-      assert(letStack.empty());
-      if (pos != endOfFunction) {
-        throwError("binary offset at function exit not at expected location");
-      }
+bool WasmBinaryBuilder::shouldReadFunctionsInParallel(size_t total) {
+  if (!parallelFunctionBodies || total < 2) {
+    return false;
+  }
+  // The source map is a stream that we read in lockstep with the binary, so it
+  // forces us to decode the bodies in order.
+  if (sourceMap) {
+    return false;
+  }
+  // When skipping bodies there is almost no work to parallelize.
+  if (skipFunctionBodies) {
+    return false;
+  }
+  return ThreadPool::get()->size() > 1;
+}
+
+void WasmBinaryBuilder::readFunctionsInParallel(size_t total) {
+  // Each body is length-prefixed, so first scan the offsets of all of them,
+  // and then decode them independently of each other.
+  struct BodyRange {
+    size_t sizePos;
+    size_t size;
+  };
+  std::vector<BodyRange> ranges;
+  ranges.reserve(total);
+  for (size_t i = 0; i < total; i++) {
+    auto sizePos = pos;
+    size_t size = getU32LEB();
+    if (size == 0) {
+      throwError("empty function size");
+    }
+    if (size > input.size() || pos > input.size() - size) {
+      throwError("unexpected end of input");
     }
+    ranges.push_back({sizePos, size});
+    pos += size;
+  }
+  auto endPos = pos;
 
-    if (!wasm.features.hasGCNNLocals()) {
-      TypeUpdating::handleNonDefaultableLocals(func, wasm);
+  std::vector<Function*> bodies;
+  bodies.reserve(total);
+  for (size_t i = 0; i < total; i++) {
+    auto* func = new Function;
+    func->name = Name::fromInt(i);
+    func->type = getTypeByFunctionIndex(functionImports.size() + i);
+    bodies.push_back(func);
+  }
+
+  // The references to module elements that each body contains. We gather them
+  // per function and append them in order at the end, so that the result is
+  // identical to reading serially.
+  struct BodyRefs {
+    std::map<Index, std::vector<Expression*>> functionRefs;
+    std::map<Index, std::vector<Expression*>> tableRefs;
+    std::map<Index, std::vector<Expression*>> globalRefs;
+  };
+  std::vector<BodyRefs> refs(total);
+  std::vector<std::exception_ptr> errors(total);
+
+  // Each thread gets its own decoder, as decoding has a lot of per-function
+  // state. Allocations from the module's arena are done in a per-thread side
+  // arena, see MixedArena.
+  auto* pool = ThreadPool::get();
+  size_t num = pool->size();
+  std::vector<std::unique_ptr<WasmBinaryBuilder>> decoders;
+  for (size_t i = 0; i < num; i++) {
+    decoders.push_back(makeFunctionBodyDecoder());
+  }
+
+  std::vector<std::function<ThreadWorkState()>> doWorkers;
+  std::atomic<size_t> nextFunction;
+  nextFunction.store(0);
+  for (size_t i = 0; i < num; i++) {
+    doWorkers.push_back([&, i]() {
+      auto index = nextFunction.fetch_add(1);
+      if (index >= total) {
+        return ThreadWorkState::Finished;
+      }
+      auto& decoder = *decoders[i];
+      auto& range = ranges[index];
+      try {
+        decoder.pos = range.sizePos;
+        decoder.getU32LEB();
+        decoder.readFunctionBody(
+          bodies[index], index, range.sizePos, range.size);
+      } catch (...) {
+        errors[index] = std::current_exception();
+        decoder.resetFunctionBodyState();
+      }
+      auto& bodyRefs = refs[index];
+      std::swap(bodyRefs.functionRefs, decoder.functionRefs);
+      std::swap(bodyRefs.tableRefs, decoder.tableRefs);
+      std::swap(bodyRefs.globalRefs, decoder.globalRefs);
+      if (index + 1 == total) {
+        return ThreadWorkState::Finished;
+      }
+      return ThreadWorkState::More;
+    });
+  }
+  pool->work(doWorkers);
+
+  for (size_t i = 0; i < total; i++) {
+    functions.push_back(bodies[i]);
+  }
+  // Report the same error a serial read would have, which is the first one.
+  for (auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  for (auto& bodyRefs : refs) {
+    for (auto& [index, exprs] : bodyRefs.functionRefs) {
+      auto& all = functionRefs[index];
+      all.insert(all.end(), exprs.begin(), exprs.end());
     }
+    for (auto& [index, exprs] : bodyRefs.tableRefs) {
+      auto& all = tableRefs[index];
+      all.insert(all.end(), exprs.begin(), exprs.end());
+    }
+    for (auto& [index, exprs] : bodyRefs.globalRefs) {
+      auto& all = globalRefs[index];
+      all.insert(all.end(), exprs.begin(), exprs.end());
+    }
+  }
+  pos = endPos;
+  BYN_TRACE(" end function bodies\n");
+}
+
+std::unique_ptr<WasmBinaryBuilder>
+WasmBinaryBuilder::makeFunctionBodyDecoder() {
+  auto decoder =
+    std::make_unique<WasmBinaryBuilder>(wasm, wasm.features, input);
+  decoder->debugInfo = debugInfo;
+  decoder->DWARF = DWARF;
+  decoder->codeSectionLocation = codeSectionLocation;
+  decoder->startIndex = startIndex;
+  decoder->types = types;
+  decoder->functionTypes = functionTypes;
+  decoder->functionImports = functionImports;
+  decoder->tableImports = tableImports;
+  decoder->globalImports = globalImports;
+  // Bodies only look at the types and the (temporary) names of tables and
+  // globals, so shallow copies are enough.
+  for (auto& table : tables) {
+    decoder->tables.push_back(std::make_unique<Table>(*table));
+  }
+  for (auto& global : globals) {
+    decoder->globals.push_back(std::make_unique<Global>(*global));
+  }
+  return decoder;
+}
 
-    std::swap(func->epilogLocation, debugLocation);
-    currFunction = nullptr;
+void WasmBinaryBuilder::resetFunctionBodyState() {
+  currFunction = nullptr;
+  endOfFunction = -1;
+  depth = 0;
+  debugLocation.clear();
+  breakStack.clear();
+  breakTargetNames.clear();
+  exceptionTargetNames.clear();
+  expressionStack.clear();
+  controlFlowStack.clear();
+  letStack.clear();
+}
+
+void WasmBinaryBuilder::readFunctionBody(Function* func,
+                                         Index index,
+                                         size_t sizePos,
+                                         size_t size) {
+  endOfFunction = pos + size;
+  currFunction = func;
+
+  if (DWARF) {
+    func->funcLocation = BinaryLocations::FunctionLocations{
+      BinaryLocation(sizePos - codeSectionLocation),
+      BinaryLocation(pos - codeSectionLocation),
+      BinaryLocation(pos - codeSectionLocation + size)};
+  }
+
+  readNextDebugLocation();
+
+  BYN_TRACE("reading " << index << std::endl);
+
+  readVars();
+
+  std::swap(func->prologLocation, debugLocation);
+  {
+    // process the function body
+    BYN_TRACE("processing function: " << index << std::endl);
+    nextLabel = 0;
     debugLocation.clear();
-    functions.push_back(func);
+    willBeIgnored = false;
+    // process body
+    assert(breakStack.empty());
+    assert(breakTargetNames.empty());
+    assert(exceptionTargetNames.empty());
+    assert(expressionStack.empty());
+    assert(controlFlowStack.empty());
+    assert(letStack.empty());
+    assert(depth == 0);
+    // Even if we are skipping function bodies we need to not skip the start
+    // function. That contains important code for wasm-emscripten-finalize in
+    // the form of pthread-related segment initializations. As this is just
+    // one function, it doesn't add significant time, so the optimization of
+    // skipping bodies is still very useful.
+    auto currFunctionIndex = functionImports.size() + index;
+    bool isStart = startIndex == currFunctionIndex;
+    if (!skipFunctionBodies || isStart) {
+      func->body = getBlockOrSingleton(func->getResults());
+    } else {
+      // When skipping the function body we need to put something valid in
+      // their place so we validate. An unreachable is always acceptable
+      // there.
+      func->body = Builder(wasm).makeUnreachable();
+
+      // Skip reading the contents.
+      pos = endOfFunction;
+    }
+    assert(depth == 0);
+    assert(breakStack.empty());
+    assert(breakTargetNames.empty());
+    assert(exceptionTargetNames.empty());
+    if (!expressionStack.empty()) {
+      throwError("stack not empty on function exit");
+    }
+    assert(controlFlowStack.empty());
+    assert(letStack.empty());
+    if (pos != endOfFunction) {
+      throwError("binary offset at function exit not at expected location");
+    }
   }
-  BYN_TRACE(" end function bodies\n");
+
+  if (!wasm.features.hasGCNNLocals()) {
+    TypeUpdating::handleNonDefaultableLocals(func, wasm);
+  }
+
+  std::swap(func->epilogLocation, debugLocation);
+  currFunction = nullptr;
+  debugLocation.clear();
 }
 
 void WasmBinaryBuilder::readVars() {
@@ -3098,6 +3433,13 @@ void WasmBinaryBuilder::readNames(size_t payloadLen) {
     } else if (nameType ==
                BinaryConsts::UserSections::Subsection::NameFunction) {
       auto num = getU32LEB();
+      // Make room for all the names at once. The count has not been checked
+      // yet, so do not trust it beyond the number of entries that can fit in
+      // the subsection, which take at least two bytes each, or beyond the
+      // number of functions, as names of other indexes are ignored.
+      Name::reserve(std::min({size_t(num),
+                              size_t(subsectionSize) / 2,
+                              functionImports.size() + functions.size()}));
       NameProcessor processor;
       for (size_t i = 0; i < num; i++) {
         auto index = getU32LEB();
@@ -0,0 +1,549 @@
+/*
+ * Copyright 2022 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unordered_set>
+
+#include "ir/iteration.h"
+#include "wasm-interpreter-bytecode.h"
+
+namespace wasm {
+
+namespace {
+
+bool useBytecode = false;
+
+// Lowers a function. Values are computed into slots chosen by the parent
+// expression, which must not be written until the value is complete: an
+// expression writes its slot only in the last instruction it runs, or right
+// before it branches out of itself. That lets us compute values directly into
+// the locals that they are assigned to.
+struct BytecodeCompiler {
+  static const Index NoSlot = BytecodeFunction::NoSlot;
+
+  Module& wasm;
+  Function* func;
+  BytecodeFunction& out;
+
+  // Expressions that set locals, or contain something that does. Reading a
+  // local directly from its slot is only valid if nothing sets locals between
+  // the read and the use of the value.
+  std::unordered_set<Expression*> setsLocals;
+
+  struct Label {
+    Name name;
+    bool isLoop;
+    // For a loop, the instruction that branches go to.
+    Index start;
+    // For a block, the slot that branches put their value in, and the
+    // branches, whose targets we fill in when we reach the end of the block.
+    Index dst;
+    std::vector<Index> branches;
+  };
+  std::vector<Label> labels;
+
+  // The first slot that is not in use.
+  Index nextSlot;
+
+  BytecodeCompiler(Module& wasm, Function* func, BytecodeFunction& out)
+    : wasm(wasm), func(func), out(out), nextSlot(func->getNumLocals()) {
+    out.numSlots = nextSlot;
+  }
+
+  // Returns whether we support an expression and everything in it.
+  bool scan(Expression* curr) {
+    if (curr->type.isTuple()) {
+      return false;
+    }
+    bool sets = false;
+    switch (curr->_id) {
+      case Expression::LocalSetId:
+        sets = true;
+        break;
+      case Expression::NopId:
+      case Expression::BlockId:
+      case Expression::IfId:
+      case Expression::LoopId:
+      case Expression::BreakId:
+      case Expression::SwitchId:
+      case Expression::CallId:
+      case Expression::CallIndirectId:
+      case Expression::LocalGetId:
+      case Expression::GlobalGetId:
+      case Expression::GlobalSetId:
+      case Expression::LoadId:
+      case Expression::StoreId:
+      case Expression::ConstId:
+      case Expression::UnaryId:
+      case Expression::BinaryId:
+      case Expression::SelectId:
+      case Expression::DropId:
+      case Expression::ReturnId:
+      case Expression::MemorySizeId:
+      case Expression::MemoryGrowId:
+      case Expression::UnreachableId:
+      case Expression::AtomicFenceId:
+      case Expression::DataDropId:
+      case Expression::RefNullId:
+      case Expression::RefFuncId:
+      case Expression::TableSizeId:
+        break;
+      default:
+        return false;
+    }
+    for (auto* child : ChildIterator(curr)) {
+      if (!scan(child)) {
+        return false;
+      }
+      if (setsLocals.count(child)) {
+        sets = true;
+      }
+    }
+    if (sets) {
+      setsLocals.insert(curr);
+    }
+    return true;
+  }
+
+  bool compileFunction() {
+    for (Index i = 0; i < func->getNumLocals(); i++) {
+      if (func->getLocalType(i).isTuple()) {
+        return false;
+      }
+    }
+    if (func->getResults().isTuple() || !scan(func->body)) {
+      return false;
+    }
+    for (auto type : func->vars) {
+      out.varValues.push_back(Literal::makeZero(type));
+    }
+    Index result = NoSlot;
+    if (func->getResults().isConcrete()) {
+      result = allocSlot();
+    }
+    compile(func->body, result);
+    emit(BytecodeOp::Return, NoSlot, result);
+    return true;
+  }
+
+  Index allocSlot() {
+    Index slot = nextSlot++;
+    out.numSlots = std::max(out.numSlots, nextSlot);
+    return slot;
+  }
+
+  Index emit(BytecodeOp op,
+             Index dst = NoSlot,
+             Index a = 0,
+             Index b = 0,
+             Index c = 0,
+             Expression* expr = nullptr) {
+    out.code.push_back({op, dst, a, b, c, expr});
+    return out.code.size() - 1;
+  }
+
+  Index findLabel(Name name) {
+    for (Index i = labels.size(); i > 0; i--) {
+      if (labels[i - 1].name == name) {
+        return i - 1;
+      }
+    }
+    WASM_UNREACHABLE("missing label");
+  }
+
+  void addBranch(Index label, Index branch) {
+    if (labels[label].isLoop) {
+      out.code[branch].a = labels[label].start;
+    } else {
+      labels[label].branches.push_back(branch);
+    }
+  }
+
+  // Returns the slot that has the value of an expression. If locals will not
+  // change before the value is used, a local.get can use the local's slot.
+  Index getOperand(Expression* curr, bool localsMayChange) {
+    if (!localsMayChange) {
+      if (auto* get = curr->dynCast<LocalGet>()) {
+        return get->index;
+      }
+    }
+    Index slot = allocSlot();
+    compile(curr, slot);
+    return slot;
+  }
+
+  // Returns the slots for a list of expressions that are evaluated in order,
+  // and then used.
+  std::vector<Index> getOperands(const std::vector<Expression*>& list) {
+    std::vector<bool> localsMayChange(list.size());
+    bool sets = false;
+    for (Index i = list.size(); i > 0; i--) {
+      localsMayChange[i - 1] = sets;
+      sets = sets || setsLocals.count(list[i - 1]);
+    }
+    std::vector<Index> slots;
+    for (Index i = 0; i < list.size(); i++) {
+      slots.push_back(getOperand(list[i], localsMayChange[i]));
+    }
+    return slots;
+  }
+
+  Index addOperands(const std::vector<Index>& slots) {
+    Index start = out.operands.size();
+    out.operands.insert(out.operands.end(), slots.begin(), slots.end());
+    return start;
+  }
+
+  static BytecodeOp getBinaryOp(BinaryOp op) {
+    switch (op) {
+      case AddInt32:
+        return BytecodeOp::AddI32;
+      case SubInt32:
+        return BytecodeOp::SubI32;
+      case MulInt32:
+        return BytecodeOp::MulI32;
+      case AndInt32:
+        return BytecodeOp::AndI32;
+      case OrInt32:
+        return BytecodeOp::OrI32;
+      case XorInt32:
+        return BytecodeOp::XorI32;
+      case ShlInt32:
+        return BytecodeOp::ShlI32;
+      case ShrSInt32:
+        return BytecodeOp::ShrSI32;
+      case ShrUInt32:
+        return BytecodeOp::ShrUI32;
+      case EqInt32:
+        return BytecodeOp::EqI32;
+      case NeInt32:
+        return BytecodeOp::NeI32;
+      case LtSInt32:
+        return BytecodeOp::LtSI32;
+      case LtUInt32:
+        return BytecodeOp::LtUI32;
+      case GtSInt32:
+        return BytecodeOp::GtSI32;
+      case GtUInt32:
+        return BytecodeOp::GtUI32;
+      case LeSInt32:
+        return BytecodeOp::LeSI32;
+      case LeUInt32:
+        return BytecodeOp::LeUI32;
+      case GeSInt32:
+        return BytecodeOp::GeSI32;
+      case GeUInt32:
+        return BytecodeOp::GeUI32;
+      default:
+        return BytecodeOp::Binary;
+    }
+  }
+
+  // Lowers an expression, putting its value in |dst|.
+  void compile(Expression* curr, Index dst) {
+    if (dst == NoSlot && curr->type.isConcrete()) {
+      dst = allocSlot();
+    }
+    // Temporary slots are free again once we have the value.
+    auto firstFreeSlot = nextSlot;
+    compileInto(curr, dst);
+    nextSlot = firstFreeSlot;
+  }
+
+  void compileInto(Expression* curr, Index dst) {
+    // An unreachable operation is never reached, as one of its children
+    // diverges, so we only need the children. Control flow structures and
+    // return calls are unreachable for other reasons, and handled below.
+    bool isControlFlow = curr->is<Block>() || curr->is<If>() ||
+                         curr->is<Loop>() || curr->is<Break>() ||
+                         curr->is<Switch>() || curr->is<Return>() ||
+                         curr->is<Unreachable>();
+    if (auto* call = curr->dynCast<Call>()) {
+      isControlFlow = call->isReturn;
+    } else if (auto* call = curr->dynCast<CallIndirect>()) {
+      isControlFlow = call->isReturn;
+    }
+    if (curr->type == Type::unreachable && !isControlFlow) {
+      for (auto* child : ChildIterator(curr)) {
+        compile(child, NoSlot);
+      }
+      return;
+    }
+
+    switch (curr->_id) {
+      case Expression::NopId:
+        break;
+      case Expression::BlockId: {
+        auto* block = curr->cast<Block>();
+        auto resultDst = block->type.isConcrete() ? dst : NoSlot;
+        if (block->name.is()) {
+          labels.push_back({block->name, false, 0, resultDst, {}});
+        }
+        for (Index i = 0; i < block->list.size(); i++) {
+          bool last = i + 1 == block->list.size();
+          compile(block->list[i], last ? resultDst : NoSlot);
+        }
+        if (block->name.is()) {
+          for (auto branch : labels.back().branches) {
+            out.code[branch].a = out.code.size();
+          }
+          labels.pop_back();
+        }
+        break;
+      }
+      case Expression::IfId: {
+        auto* iff = curr->cast<If>();
+        auto resultDst = iff->type.isConcrete() ? dst : NoSlot;
+        Index condition = getOperand(iff->condition, false);
+        Index toElse = emit(BytecodeOp::JumpIfZero, NoSlot, 0, condition);
+        compile(iff->ifTrue, resultDst);
+        if (iff->ifFalse) {
+          Index toEnd = emit(BytecodeOp::Jump);
+          out.code[toElse].a = out.code.size();
+          compile(iff->ifFalse, resultDst);
+          out.code[toEnd].a = out.code.size();
+        } else {
+          out.code[toElse].a = out.code.size();
+        }
+        break;
+      }
+      case Expression::LoopId: {
+        auto* loop = curr->cast<Loop>();
+        if (loop->name.is()) {
+          labels.push_back({loop->name, true, Index(out.code.size()), 0, {}});
+        }
+        compile(loop->body, loop->type.isConcrete() ? dst : NoSlot);
+        if (loop->name.is()) {
+          labels.pop_back();
+        }
+        break;
+      }
+      case Expression::BreakId: {
+        auto* br = curr->cast<Break>();
+        Index label = findLabel(br->name);
+        if (!br->condition) {
+          if (br->value) {
+            compile(br->value, labels[label].dst);
+          }
+          addBranch(label, emit(BytecodeOp::Jump));
+          break;
+        }
+        if (!br->value) {
+          Index condition = getOperand(br->condition, false);
+          addBranch(label,
+                    emit(BytecodeOp::JumpIfNonZero, NoSlot, 0, condition));
+          break;
+        }
+        // The value is only copied to the target if we branch, and otherwise
+        // it is the value of the br_if.
+        Index value = getOperand(br->value, setsLocals.count(br->condition));
+        Index condition = getOperand(br->condition, false);
+        if (labels[label].dst != NoSlot) {
+          addBranch(label,
+                    emit(BytecodeOp::CopyAndJumpIfNonZero,
+                         labels[label].dst,
+                         0,
+                         condition,
+                         value));
+        } else {
+          addBranch(label,
+                    emit(BytecodeOp::JumpIfNonZero, NoSlot, 0, condition));
+        }
+        if (dst != NoSlot) {
+          emit(BytecodeOp::Copy, dst, value);
+        }
+        break;
+      }
+      case Expression::SwitchId: {
+        auto* sw = curr->cast<Switch>();
+        Index value = NoSlot;
+        if (sw->value) {
+          value = getOperand(sw->value, setsLocals.count(sw->condition));
+        }
+        Index condition = getOperand(sw->condition, false);
+        emit(BytecodeOp::JumpTable, NoSlot, sw->targets.size(), condition);
+        auto addTarget = [&](Name name) {
+          Index label = findLabel(name);
+          if (value != NoSlot && labels[label].dst != NoSlot) {
+            addBranch(label,
+                      emit(BytecodeOp::CopyAndJump,
+                           labels[label].dst,
+                           0,
+                           0,
+                           value));
+          } else {
+            addBranch(label, emit(BytecodeOp::Jump));
+          }
+        };
+        for (auto target : sw->targets) {
+          addTarget(target);
+        }
+        addTarget(sw->default_);
+        break;
+      }
+      case Expression::CallId: {
+        auto* call = curr->cast<Call>();
+        std::vector<Expression*> list(call->operands.begin(),
+                                      call->operands.end());
+        Index operands = addOperands(getOperands(list));
+        auto* target = wasm.getFunction(call->target);
+        Index function = out.functions.size();
+        out.functions.push_back(target);
+        if (call->isReturn) {
+          Index result = NoSlot;
+          if (target->getResults().isConcrete()) {
+            result = allocSlot();
+          }
+          emit(BytecodeOp::Call, result, operands, list.size(), function, call);
+          emit(BytecodeOp::Return, NoSlot, result);
+        } else {
+          emit(BytecodeOp::Call, dst, operands, list.size(), function, call);
+        }
+        break;
+      }
+      case Expression::CallIndirectId: {
+        auto* call = curr->cast<CallIndirect>();
+        std::vector<Expression*> list(call->operands.begin(),
+                                      call->operands.end());
+        list.push_back(call->target);
+        Index operands = addOperands(getOperands(list));
+        if (call->isReturn) {
+          Index result = NoSlot;
+          if (func->getResults().isConcrete()) {
+            result = allocSlot();
+          }
+          emit(BytecodeOp::CallIndirect,
+               result,
+               operands,
+               list.size(),
+               0,
+               call);
+          emit(BytecodeOp::Return, NoSlot, result);
+        } else {
+          emit(
+            BytecodeOp::CallIndirect, dst, operands, list.size(), 0, call);
+        }
+        break;
+      }
+      case Expression::LocalGetId:
+        emit(BytecodeOp::Copy, dst, curr->cast<LocalGet>()->index);
+        break;
+      case Expression::LocalSetId: {
+        auto* set = curr->cast<LocalSet>();
+        compile(set->value, set->index);
+        if (set->isTee() && dst != NoSlot) {
+          emit(BytecodeOp::Copy, dst, set->index);
+        }
+        break;
+      }
+      case Expression::GlobalSetId: {
+        auto* set = curr->cast<GlobalSet>();
+        emit(BytecodeOp::GlobalSet,
+             NoSlot,
+             getOperand(set->value, false),
+             0,
+             0,
+             curr);
+        break;
+      }
+      case Expression::LoadId:
+        emit(BytecodeOp::Load,
+             dst,
+             getOperand(curr->cast<Load>()->ptr, false),
+             0,
+             0,
+             curr);
+        break;
+      case Expression::StoreId: {
+        auto* store = curr->cast<Store>();
+        auto slots = getOperands({store->ptr, store->value});
+        emit(BytecodeOp::Store, NoSlot, slots[0], slots[1], 0, curr);
+        break;
+      }
+      case Expression::ConstId:
+        out.consts.push_back(curr->cast<Const>()->value);
+        emit(BytecodeOp::Const, dst, out.consts.size() - 1);
+        break;
+      case Expression::UnaryId: {
+        auto* unary = curr->cast<Unary>();
+        auto op =
+          unary->op == EqZInt32 ? BytecodeOp::EqZI32 : BytecodeOp::Unary;
+        emit(op, dst, getOperand(unary->value, false), 0, 0, curr);
+        break;
+      }
+      case Expression::BinaryId: {
+        auto* binary = curr->cast<Binary>();
+        auto slots = getOperands({binary->left, binary->right});
+        emit(getBinaryOp(binary->op), dst, slots[0], slots[1], 0, curr);
+        break;
+      }
+      case Expression::SelectId: {
+        auto* select = curr->cast<Select>();
+        auto slots =
+          getOperands({select->ifTrue, select->ifFalse, select->condition});
+        emit(BytecodeOp::Select, dst, slots[0], slots[1], slots[2]);
+        break;
+      }
+      case Expression::DropId:
+        compile(curr->cast<Drop>()->value, NoSlot);
+        break;
+      case Expression::ReturnId: {
+        auto* ret = curr->cast<Return>();
+        Index value = NoSlot;
+        if (ret->value) {
+          value = getOperand(ret->value, false);
+        }
+        emit(BytecodeOp::Return, NoSlot, value);
+        break;
+      }
+      case Expression::MemoryGrowId:
+        emit(BytecodeOp::MemoryGrow,
+             dst,
+             getOperand(curr->cast<MemoryGrow>()->delta, false));
+        break;
+      case Expression::UnreachableId:
+        emit(BytecodeOp::Unreachable);
+        break;
+      case Expression::GlobalGetId:
+      case Expression::MemorySizeId:
+      case Expression::AtomicFenceId:
+      case Expression::DataDropId:
+      case Expression::RefNullId:
+      case Expression::RefFuncId:
+      case Expression::TableSizeId:
+        emit(BytecodeOp::Leaf, dst, 0, 0, 0, curr);
+        break;
+      default:
+        WASM_UNREACHABLE("unexpected expression");
+    }
+  }
+};
+
+} // anonymous namespace
+
+std::unique_ptr<BytecodeFunction> compileToBytecode(Module& wasm,
+                                                    Function* func) {
+  auto ret = std::make_unique<BytecodeFunction>();
+  if (!BytecodeCompiler(wasm, func, *ret).compileFunction()) {
+    return nullptr;
+  }
+  return ret;
+}
+
+bool getUseBytecode() { return useBytecode; }
+
+void setUseBytecode(bool useBytecode_) { useBytecode = useBytecode_; }
+
+} // namespace wasm
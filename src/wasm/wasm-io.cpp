@@ -45,7 +45,7 @@ void ModuleReader::readText(std::string filename, Module& wasm) {
   readTextData(input, wasm, profile);
 }
 
-void ModuleReader::readBinaryData(std::vector<char>& input,
+void ModuleReader::readBinaryData(std::string_view input,
                                   Module& wasm,
                                   std::string sourceMapFilename) {
   std::unique_ptr<std::ifstream> sourceMapStream;
@@ -55,6 +55,7 @@ void ModuleReader::readBinaryData(std::vector<char>& input,
   parser.setDebugInfo(debugInfo);
   parser.setDWARF(DWARF);
   parser.setSkipFunctionBodies(skipFunctionBodies);
+  parser.setParallelFunctionBodies(parallelFunctionBodies);
   if (sourceMapFilename.size()) {
     sourceMapStream = make_unique<std::ifstream>();
     sourceMapStream->open(sourceMapFilename);
@@ -70,8 +71,10 @@ void ModuleReader::readBinary(std::string filename,
                               Module& wasm,
                               std::string sourceMapFilename) {
   BYN_TRACE("reading binary from " << filename << "\n");
-  auto input(read_file<std::vector<char>>(filename, Flags::Binary));
-  readBinaryData(input, wasm, sourceMapFilename);
+  // Parse directly from a mapping of the file, if we can, which avoids
+  // reading all of it into memory first.
+  MappedFile input(filename);
+  readBinaryData(input.view(), wasm, sourceMapFilename);
 }
 
 bool ModuleReader::isBinaryFile(std::string filename) {
@@ -111,7 +114,7 @@ void ModuleReader::readStdin(Module& wasm, std::string sourceMapFilename) {
   std::vector<char> input = read_stdin();
   if (input.size() >= 4 && input[0] == '\0' && input[1] == 'a' &&
       input[2] == 's' && input[3] == 'm') {
-    readBinaryData(input, wasm, sourceMapFilename);
+    readBinaryData({input.data(), input.size()}, wasm, sourceMapFilename);
   } else {
     std::ostringstream s;
     s.write(input.data(), input.size());
@@ -135,8 +138,11 @@ void ModuleWriter::writeText(Module& wasm, std::string filename) {
 }
 
 void ModuleWriter::writeBinary(Module& wasm, Output& output) {
+  // Stream the binary to the output as we write it, so that we never have all
+  // of it in memory.
   BufferWithRandomAccess buffer;
   WasmBinaryWriter writer(&wasm, buffer);
+  writer.setOutputStream(&output.getStream());
   // if debug info is used, then we want to emit the names section
   writer.setNamesSection(debugInfo);
   if (emitModuleName) {
@@ -152,7 +158,6 @@ void ModuleWriter::writeBinary(Module& wasm, Output& output) {
     writer.setSymbolMap(symbolMap);
   }
   writer.write();
-  buffer.writeTo(output);
   if (sourceMapStream) {
     sourceMapStream->close();
   }
@@ -24,6 +24,7 @@
 #include "ir/table-utils.h"
 #include "shared-constants.h"
 #include "support/string.h"
+#include "support/threads.h"
 #include "wasm-binary.h"
 #include "wasm-builder.h"
 
@@ -385,8 +386,96 @@ SExpressionWasmBuilder::SExpressionWasmBuilder(Module& wasm,
   // we go through the functions again, now parsing them, and the counter begins
   // from where imports ended
   functionCounter -= implementedFunctions;
-  for (unsigned j = i; j < module.size(); j++) {
-    parseModuleElement(*module[j]);
+  // Parse the function bodies after the rest of the module, so that they can
+  // refer to anything in it. This must not depend on whether we have threads,
+  // as otherwise whether a module is accepted would depend on the machine.
+  deferFunctionBodies = true;
+  try {
+    for (unsigned j = i; j < module.size(); j++) {
+      parseModuleElement(*module[j]);
+    }
+  } catch (ParseException&) {
+    // Had we parsed the function bodies in order, an error in one of the
+    // functions before this element would have been reported instead.
+    parsePendingFunctionBodiesInOrder();
+    throw;
+  }
+  parsePendingFunctionBodies();
+}
+
+SExpressionWasmBuilder::SExpressionWasmBuilder(SExpressionWasmBuilder* parent)
+  : wasm(parent->wasm), allocator(parent->allocator), profile(parent->profile),
+    info(parent->info), isFunctionBodyBuilder(true) {}
+
+void SExpressionWasmBuilder::parsePendingFunctionBodies() {
+  size_t num = ThreadPool::get()->size();
+  if (num == 1 || pendingFunctions.size() <= 1) {
+    parsePendingFunctionBodiesInOrder();
+    return;
+  }
+
+  // Each thread parses using a builder of its own, as builders keep state
+  // about the current function. The builders share the module information,
+  // which they only read, and allocate in the module's arena, which has a
+  // separate arena for each thread.
+  std::vector<std::unique_ptr<SExpressionWasmBuilder>> builders;
+  for (size_t i = 0; i < num; i++) {
+    builders.emplace_back(new SExpressionWasmBuilder(this));
+  }
+
+  std::vector<uint8_t> parseInOrder(pendingFunctions.size());
+  std::vector<std::function<ThreadWorkState()>> doWorkers;
+  std::atomic<size_t> nextFunction;
+  nextFunction.store(0);
+  size_t numFunctions = pendingFunctions.size();
+  for (size_t i = 0; i < num; i++) {
+    doWorkers.push_back([&, i]() {
+      auto index = nextFunction.fetch_add(1);
+      if (index >= numFunctions) {
+        return ThreadWorkState::Finished;
+      }
+      auto& builder = *builders[i];
+      auto& pending = pendingFunctions[index];
+      builder.needsParseInOrder = false;
+      builder.nameMapper.otherIndex = 0;
+      try {
+        builder.parseFunctionBody(pending.func, *pending.s, pending.bodyStart);
+      } catch (ParseException&) {
+        builder.needsParseInOrder = true;
+        builder.nameMapper.clear();
+      }
+      if (builder.needsParseInOrder || builder.nameMapper.otherIndex != 0) {
+        parseInOrder[index] = 1;
+      }
+      if (index + 1 == numFunctions) {
+        return ThreadWorkState::Finished;
+      }
+      return ThreadWorkState::More;
+    });
+  }
+  ThreadPool::get()->work(doWorkers);
+
+  // Parse again the bodies whose results depend on the functions before them.
+  std::vector<PendingFunction> remaining;
+  for (Index i = 0; i < numFunctions; i++) {
+    if (parseInOrder[i]) {
+      auto* func = pendingFunctions[i].func;
+      func->body = nullptr;
+      func->debugLocations.clear();
+      func->prologLocation.clear();
+      func->epilogLocation.clear();
+      remaining.push_back(pendingFunctions[i]);
+    }
+  }
+  pendingFunctions = std::move(remaining);
+  parsePendingFunctionBodiesInOrder();
+}
+
+void SExpressionWasmBuilder::parsePendingFunctionBodiesInOrder() {
+  auto pending = std::move(pendingFunctions);
+  pendingFunctions.clear();
+  for (auto& [func, s, bodyStart] : pending) {
+    parseFunctionBody(func, *s, bodyStart);
   }
 }
 
@@ -1014,8 +1103,6 @@ size_t SExpressionWasmBuilder::parseFunctionNames(Element& s,
 }
 
 void SExpressionWasmBuilder::parseFunction(Element& s, bool preParseImport) {
-  brokeToAutoBlock = false;
-
   Name name, exportName;
   size_t i = parseFunctionNames(s, name, exportName);
   bool hasExplicitName = name.is();
@@ -1097,9 +1184,31 @@ void SExpressionWasmBuilder::parseFunction(Element& s, bool preParseImport) {
   }
 
   // make a new function
-  currFunction = std::unique_ptr<Function>(
+  auto func = std::unique_ptr<Function>(
     Builder(wasm).makeFunction(name, std::move(params), type, std::move(vars)));
-  currFunction->profile = profile;
+  func->profile = profile;
+
+  if (deferFunctionBodies) {
+    if (wasm.getFunctionOrNull(func->name)) {
+      throw ParseException("duplicate function", s.line, s.col);
+    }
+    pendingFunctions.push_back({func.get(), &s, Index(i)});
+    wasm.addFunction(func.release());
+    return;
+  }
+
+  parseFunctionBody(func.get(), s, i);
+  if (wasm.getFunctionOrNull(func->name)) {
+    throw ParseException("duplicate function", s.line, s.col);
+  }
+  wasm.addFunction(func.release());
+}
+
+void SExpressionWasmBuilder::parseFunctionBody(Function* func,
+                                               Element& s,
+                                               Index i) {
+  currFunction = func;
+  brokeToAutoBlock = false;
 
   // parse body
   Block* autoBlock = nullptr; // may need to add a block for the very top level
@@ -1125,7 +1234,7 @@ void SExpressionWasmBuilder::parseFunction(Element& s, bool preParseImport) {
     autoBlock->name = FAKE_RETURN;
   }
   if (autoBlock) {
-    autoBlock->finalize(type.getSignature().results);
+    autoBlock->finalize(func->getResults());
   }
   if (!currFunction->body) {
     currFunction->body = allocator.alloc<Nop>();
@@ -1136,10 +1245,7 @@ void SExpressionWasmBuilder::parseFunction(Element& s, bool preParseImport) {
   if (s.endLoc) {
     currFunction->epilogLocation.insert(getDebugLocation(*s.endLoc));
   }
-  if (wasm.getFunctionOrNull(currFunction->name)) {
-    throw ParseException("duplicate function", s.line, s.col);
-  }
-  wasm.addFunction(currFunction.release());
+  currFunction = nullptr;
   nameMapper.clear();
 }
 
@@ -1314,11 +1420,16 @@ SExpressionWasmBuilder::getDebugLocation(const SourceLocation& loc) {
   auto& debugInfoFileNames = wasm.debugInfoFileNames;
   auto iter = debugInfoFileIndices.find(file);
   if (iter == debugInfoFileIndices.end()) {
+    if (isFunctionBodyBuilder) {
+      // The index of a new file depends on the functions before this one.
+      needsParseInOrder = true;
+      return {0, loc.line, loc.column};
+    }
     Index index = debugInfoFileNames.size();
     debugInfoFileNames.push_back(file.c_str());
-    debugInfoFileIndices[file] = index;
+    iter = debugInfoFileIndices.insert({file, index}).first;
   }
-  uint32_t fileIndex = debugInfoFileIndices[file];
+  uint32_t fileIndex = iter->second;
   return {fileIndex, loc.line, loc.column};
 }
 
@@ -2777,14 +2888,21 @@ Expression* SExpressionWasmBuilder::makeStructNewStatic(Element& s,
 Index SExpressionWasmBuilder::getStructIndex(Element& type, Element& field) {
   if (field.dollared()) {
     auto name = field.str();
-    auto index = typeIndices[type.str().str];
+    auto typeIt = typeIndices.find(type.str().str);
+    if (typeIt == typeIndices.end()) {
+      throw ParseException("unknown struct type", type.line, type.col);
+    }
+    auto index = typeIt->second;
     auto struct_ = types[index].getStruct();
     auto& fields = struct_.fields;
-    const auto& names = fieldNames[index];
-    for (Index i = 0; i < fields.size(); i++) {
-      auto it = names.find(i);
-      if (it != names.end() && it->second == name) {
-        return i;
+    auto namesIt = fieldNames.find(index);
+    if (namesIt != fieldNames.end()) {
+      auto& names = namesIt->second;
+      for (Index i = 0; i < fields.size(); i++) {
+        auto it = names.find(i);
+        if (it != names.end() && it->second == name) {
+          return i;
+        }
       }
     }
     throw ParseException("bad struct field name", field.line, field.col);
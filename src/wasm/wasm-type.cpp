@@ -725,9 +725,31 @@ bool HeapTypeInfo::operator==(const HeapTypeInfo& other) const {
   return FiniteShapeEquator().eq(*this, other);
 }
 
+// Acquire a lock, counting the times we had to wait for another thread.
+template<typename Lock>
+static void lockCountingContention(Lock& lock, std::atomic<size_t>& counter) {
+  if (!lock.try_lock()) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+    lock.lock();
+  }
+}
+
 template<typename Info> struct Store {
   std::recursive_mutex mutex;
 
+  // Types are looked up far more often than they are created, so lookups of
+  // Types (but not HeapTypes, see below) take only a shared lock on this, and
+  // do not wait for each other. Insertions hold both this and |mutex|.
+  //
+  // HeapTypes cannot be looked up this way as TypeBuilder holds |mutex| while
+  // it canonicalizes, during which it modifies types in the store that other
+  // threads must not observe.
+  std::shared_mutex lookupMutex;
+  static constexpr bool sharedLookups = std::is_same_v<Info, TypeInfo>;
+
+  // The number of times a thread had to wait for another to release |mutex|.
+  std::atomic<size_t> contention{0};
+
   // Track unique_ptrs for constructed types to avoid leaks.
   std::vector<std::unique_ptr<Info>> constructedTypes;
 
@@ -773,6 +795,7 @@ private:
       auto ptr = getPtr();
       TypeID id = uintptr_t(ptr.get());
       assert(id > Info::type_t::_last_basic_type);
+      std::unique_lock<std::shared_mutex> lookupLock(lookupMutex);
       typeIDs.insert({*ptr, id});
       constructedTypes.emplace_back(std::move(ptr));
       return typename Info::type_t(id);
@@ -782,14 +805,24 @@ private:
     if (auto canonical = info.getCanonical()) {
       return *canonical;
     }
-    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if constexpr (sharedLookups) {
+      std::shared_lock<std::shared_mutex> lookupLock(lookupMutex);
+      auto indexIt = typeIDs.find(std::cref(info));
+      if (indexIt != typeIDs.end()) {
+        return typename Info::type_t(indexIt->second);
+      }
+    }
+    std::unique_lock<std::recursive_mutex> lock(mutex, std::defer_lock);
+    lockCountingContention(lock, contention);
     // Nominal HeapTypes are always unique, so don't bother deduplicating them.
     if constexpr (std::is_same_v<Info, HeapTypeInfo>) {
       if (typeSystem == TypeSystem::Nominal) {
         return insertNew();
       }
     }
-    // Check whether we already have a type for this structural Info.
+    // Check whether we already have a type for this structural Info. Only
+    // insertions, which hold |mutex| like us, modify the map, so we do not need
+    // the lookup lock here.
     auto indexIt = typeIDs.find(std::cref(info));
     if (indexIt != typeIDs.end()) {
       return typename Info::type_t(indexIt->second);
@@ -832,10 +865,20 @@ template<typename Info> bool Store<Info>::isGlobalStore() {
 // `HeapType::HeapType(Signature)`.
 struct SignatureTypeCache {
   std::unordered_map<Signature, HeapType> cache;
-  std::mutex mutex;
+  std::shared_mutex mutex;
+  std::atomic<size_t> contention{0};
 
   HeapType getType(Signature sig) {
-    std::lock_guard<std::mutex> lock(mutex);
+    // Most lookups find a type, which only needs a shared lock.
+    {
+      std::shared_lock<std::shared_mutex> lock(mutex);
+      auto it = cache.find(sig);
+      if (it != cache.end()) {
+        return it->second;
+      }
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    lockCountingContention(lock, contention);
     // Try inserting a placeholder type, then replace it with a real type if we
     // don't already have a canonical type for this signature.
     auto [entry, inserted] = cache.insert({sig, {}});
@@ -847,7 +890,8 @@ struct SignatureTypeCache {
   }
 
   void insertType(HeapType type) {
-    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    lockCountingContention(lock, contention);
     cache.insert({type.getSignature(), type});
   }
 
@@ -859,6 +903,8 @@ static SignatureTypeCache nominalSignatureCache;
 // Keep track of the constructed recursion groups.
 struct RecGroupStore {
   std::mutex mutex;
+  // The number of times a thread had to wait for another to release |mutex|.
+  std::atomic<size_t> contention{0};
   // Store the structures of all rec groups created so far so we can avoid
   // creating duplicates.
   std::unordered_set<RecGroupStructure> canonicalGroups;
@@ -887,7 +933,8 @@ struct RecGroupStore {
 
   // Utility for canonicalizing HeapTypes with trivial recursion groups.
   HeapType insert(std::unique_ptr<HeapTypeInfo>&& info) {
-    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+    lockCountingContention(lock, contention);
     assert(!info->recGroup && "Unexpected nontrivial rec group");
     auto group = asHeapType(info).getRecGroup();
     auto canonical = insert(group);
@@ -907,6 +954,15 @@ static RecGroupStore globalRecGroupStore;
 
 } // anonymous namespace
 
+TypeStoreStats getTypeStoreStats() {
+  TypeStoreStats stats;
+  stats.typeContention = globalTypeStore.contention.load();
+  stats.heapTypeContention = globalHeapTypeStore.contention.load();
+  stats.recGroupContention = globalRecGroupStore.contention.load();
+  stats.signatureContention = nominalSignatureCache.contention.load();
+  return stats;
+}
+
 void destroyAllTypesForTestingPurposesOnly() {
   globalTypeStore.clear();
   globalHeapTypeStore.clear();
@@ -3563,7 +3619,9 @@ void globallyCanonicalize(CanonicalizationState& state) {
   // same shape as one being canonicalized here. This cannot happen with Types
   // because they are hashed in the global store by pointer identity, which has
   // not yet escaped the builder, rather than shape.
-  std::lock_guard<std::recursive_mutex> lock(globalHeapTypeStore.mutex);
+  std::unique_lock<std::recursive_mutex> lock(globalHeapTypeStore.mutex,
+                                              std::defer_lock);
+  lockCountingContention(lock, globalHeapTypeStore.contention);
   std::unordered_map<HeapType, HeapType> canonicalHeapTypes;
   for (auto& info : state.newInfos) {
     HeapType original = asHeapType(info);
@@ -3772,7 +3830,9 @@ std::optional<TypeBuilder::Error> canonicalizeIsorecursive(
   // replacements accordingly.
   CanonicalizationState::ReplacementMap replacements;
   {
-    std::lock_guard<std::mutex> lock(globalRecGroupStore.mutex);
+    std::unique_lock<std::mutex> lock(globalRecGroupStore.mutex,
+                                      std::defer_lock);
+    lockCountingContention(lock, globalRecGroupStore.contention);
     groupStart = 0;
     for (auto group : groups) {
       size_t size = group.size();
@@ -44,6 +44,7 @@
 #include "passes/passes.h"
 #include "support/base64.h"
 #include "support/file.h"
+#include "support/threads.h"
 #include "wasm-builder.h"
 #include "wasm-io.h"
 #include "wasm-validator.h"
@@ -232,10 +233,13 @@ public:
     if (it != map.end()) {
       return it->second;
     }
-    // The mangled names in our scope.
-    auto& scopeMangledNames = mangledNames[(int)scope];
-    // In some cases (see below) we need to also check the Top scope.
-    auto& topMangledNames = mangledNames[int(NameScope::Top)];
+    if (mainBuilder) {
+      auto& mainMap = mainBuilder->wasmNameToMangledName[(int)scope];
+      auto it = mainMap.find(name.c_str());
+      if (it != mainMap.end()) {
+        return it->second;
+      }
+    }
 
     // This is the first time we've seen the `name` and `scope` pair. Generate a
     // globally unique name based on `name` and then register that in our cache
@@ -253,7 +257,7 @@ public:
       }
       auto mangled = asmangle(out.str());
       ret = stringToIString(mangled);
-      if (scopeMangledNames.count(ret)) {
+      if (isMangledName(ret, scope)) {
         // When export names collide things may be confusing, as this is
         // observable externally by the person using the JS. Report a warning.
         if (scope == NameScope::Export) {
@@ -269,20 +273,79 @@ public:
       //   var bar = 0;
       // }
       // function bar() { ..
-      if (scope == NameScope::Local && topMangledNames.count(ret)) {
+      if (scope == NameScope::Local && isMangledName(ret, NameScope::Top)) {
         continue;
       }
       // We found a good name, use it.
-      scopeMangledNames.insert(ret);
+      mangledNames[(int)scope].insert(ret);
       map[name.c_str()] = ret;
+      if (mainBuilder) {
+        newNames.push_back({name, scope, ret});
+      }
       return ret;
     }
   }
 
+  bool isMangledName(IString name, NameScope scope) {
+    return mangledNames[(int)scope].count(name) ||
+           (mainBuilder && mainBuilder->mangledNames[(int)scope].count(name));
+  }
+
+  bool isCallableFromOutside(Name name) {
+    auto* builder = mainBuilder ? mainBuilder : this;
+    return builder->functionsCallableFromOutside.count(name);
+  }
+
+  // Adds a helper import that the JS we emit calls.
+  void ensureHelper(Module* wasm, IString name) {
+    if (mainBuilder) {
+      // Other threads are translating functions, so do not modify the module
+      // now. The main builder adds it later.
+      newHelpers.push_back(name);
+      return;
+    }
+    ABI::wasm2js::ensureHelpers(wasm, name);
+  }
+
 private:
+  // Creates a builder that translates functions for a main builder, on another
+  // thread.
+  Wasm2JSBuilder(Wasm2JSBuilder* mainBuilder)
+    : flags(mainBuilder->flags), options(mainBuilder->options),
+      mainBuilder(mainBuilder) {}
+
   Flags flags;
   PassOptions options;
 
+  // When functions are translated in parallel, each thread uses a builder of
+  // its own, which only reads the main builder's state. The names it mangles
+  // for the first time and the helpers it needs are noted, so that the main
+  // builder can apply them afterwards, in order.
+  Wasm2JSBuilder* mainBuilder = nullptr;
+
+  struct NewName {
+    Name name;
+    NameScope scope;
+    IString mangled;
+  };
+  std::vector<NewName> newNames;
+  std::vector<IString> newHelpers;
+
+  // Translating a function moves code out of blocks whose code is emitted in a
+  // switch. A worker builder notes the original code, so that the function can
+  // be translated again.
+  using TruncatedBlocks =
+    std::vector<std::pair<Block*, std::vector<Expression*>>>;
+  TruncatedBlocks truncatedBlocks;
+
+  // What a worker builder noted while translating a function.
+  struct FunctionTranslation {
+    Ref ast;
+    std::vector<NewName> newNames;
+    std::vector<IString> newHelpers;
+    TruncatedBlocks truncatedBlocks;
+  };
+
   // How many temp vars we need
   std::vector<size_t> temps; // type => num temps
   // Which are currently free to use
@@ -301,6 +364,8 @@ private:
   std::unordered_set<Name> functionsCallableFromOutside;
 
   void addBasics(Ref ast, Module* wasm);
+  void addFunctions(Ref ast, Module* wasm);
+  bool applyTranslation(Module* wasm, FunctionTranslation& translation);
   void addFunctionImport(Ref ast, Function* import);
   void addGlobalImport(Ref ast, Global* import);
   void addTable(Ref ast, Module* wasm);
@@ -493,10 +558,7 @@ Ref Wasm2JSBuilder::processWasm(Module* wasm, Name funcName) {
     asmFunc[3]->push_back(
       ValueBuilder::makeName("// EMSCRIPTEN_START_FUNCS\n"));
   }
-  // functions
-  ModuleUtils::iterDefinedFunctions(*wasm, [&](Function* func) {
-    asmFunc[3]->push_back(processFunction(wasm, func));
-  });
+  addFunctions(asmFunc[3], wasm);
   if (generateFetchHighBits) {
     Builder builder(*wasm);
     asmFunc[3]->push_back(
@@ -535,6 +597,93 @@ Ref Wasm2JSBuilder::processWasm(Module* wasm, Name funcName) {
   return ret;
 }
 
+void Wasm2JSBuilder::addFunctions(Ref ast, Module* wasm) {
+  std::vector<Function*> funcs;
+  ModuleUtils::iterDefinedFunctions(
+    *wasm, [&](Function* func) { funcs.push_back(func); });
+
+  // Use the thread pool if there is work for more than one thread.
+  size_t num = 1;
+  if (funcs.size() > 1) {
+    num = ThreadPool::get()->size();
+  }
+  if (num == 1) {
+    for (auto* func : funcs) {
+      ast->push_back(processFunction(wasm, func));
+    }
+    return;
+  }
+
+  // Translate the functions in parallel. The AST is allocated in the global
+  // arena, which has a separate arena for each thread.
+  std::vector<std::unique_ptr<Wasm2JSBuilder>> workers;
+  for (size_t i = 0; i < num; i++) {
+    workers.emplace_back(new Wasm2JSBuilder(this));
+  }
+  std::vector<FunctionTranslation> translations(funcs.size());
+  std::vector<std::function<ThreadWorkState()>> doWorkers;
+  std::atomic<size_t> nextFunction;
+  nextFunction.store(0);
+  for (size_t i = 0; i < num; i++) {
+    doWorkers.push_back([&, i]() {
+      auto index = nextFunction.fetch_add(1);
+      if (index >= funcs.size()) {
+        return ThreadWorkState::Finished;
+      }
+      auto& worker = *workers[i];
+      auto& translation = translations[index];
+      // Forget the names from the worker's previous function, so that each of
+      // the names this function mangles for the first time is noted.
+      for (int scope = 0; scope < (int)NameScope::Max; scope++) {
+        worker.wasmNameToMangledName[scope].clear();
+        worker.mangledNames[scope].clear();
+      }
+      translation.ast = worker.processFunction(wasm, funcs[index]);
+      translation.newNames = std::move(worker.newNames);
+      translation.newHelpers = std::move(worker.newHelpers);
+      translation.truncatedBlocks = std::move(worker.truncatedBlocks);
+      worker.newNames.clear();
+      worker.newHelpers.clear();
+      worker.truncatedBlocks.clear();
+      if (index + 1 == funcs.size()) {
+        return ThreadWorkState::Finished;
+      }
+      return ThreadWorkState::More;
+    });
+  }
+  ThreadPool::get()->work(doWorkers);
+
+  // Apply the names and helpers in order. The workers mangled names without
+  // seeing the names that the functions before them added, so in rare cases
+  // (like two local names that mangle to the same identifier) a function gets
+  // different names than it would have. Translate those functions again, here,
+  // so that the output is the same as when translating in order.
+  for (size_t i = 0; i < funcs.size(); i++) {
+    auto& translation = translations[i];
+    if (!applyTranslation(wasm, translation)) {
+      auto& truncated = translation.truncatedBlocks;
+      for (auto it = truncated.rbegin(); it != truncated.rend(); ++it) {
+        it->first->list.set(it->second);
+      }
+      translation.ast = processFunction(wasm, funcs[i]);
+    }
+    ast->push_back(translation.ast);
+  }
+}
+
+bool Wasm2JSBuilder::applyTranslation(Module* wasm,
+                                      FunctionTranslation& translation) {
+  for (auto& newName : translation.newNames) {
+    if (fromName(newName.name, newName.scope) != newName.mangled) {
+      return false;
+    }
+  }
+  for (auto helper : translation.newHelpers) {
+    ensureHelper(wasm, helper);
+  }
+  return true;
+}
+
 void Wasm2JSBuilder::addBasics(Ref ast, Module* wasm) {
   if (wasm->memory.exists) {
     // heaps, var HEAP8 = new global.Int8Array(buffer); etc
@@ -882,7 +1031,7 @@ Ref Wasm2JSBuilder::processFunction(Module* m,
   temps[Type::i32] = temps[Type::f32] = temps[Type::f64] = 0;
   // arguments
   bool needCoercions = options.optimizeLevel == 0 || standaloneFunction ||
-                       functionsCallableFromOutside.count(func->name);
+                       isCallableFromOutside(func->name);
   for (Index i = 0; i < func->getNumParams(); i++) {
     IString name = fromName(func->getLocalNameOrGeneric(i), NameScope::Local);
     ValueBuilder::appendArgumentToFunction(ret, name);
@@ -964,6 +1113,9 @@ Ref Wasm2JSBuilder::processFunctionBody(Module* m,
     // The switch cases we found that we can hoist up.
     std::map<Switch*, std::vector<SwitchCase>> hoistedSwitchCases;
 
+    // If set, we note the original code of the blocks we truncate here.
+    TruncatedBlocks* truncatedBlocks = nullptr;
+
     void visitSwitch(Switch* brTable) {
       Index i = expressionStack.size() - 1;
       assert(expressionStack[i] == brTable);
@@ -1032,6 +1184,10 @@ Ref Wasm2JSBuilder::processFunctionBody(Module* m,
             case_.code.push_back(item);
           }
         }
+        if (truncatedBlocks) {
+          truncatedBlocks->emplace_back(
+            block, std::vector<Expression*>(list.begin(), list.end()));
+        }
         list.resize(1);
         // Finally, mark the block as unneeded outside the switch.
         unneededExpressions.insert(childBlock);
@@ -1054,7 +1210,11 @@ Ref Wasm2JSBuilder::processFunctionBody(Module* m,
                         Function* func,
                         bool standaloneFunction)
       : parent(parent), func(func), module(m),
-        standaloneFunction(standaloneFunction) {}
+        standaloneFunction(standaloneFunction) {
+      if (parent->mainBuilder) {
+        switchProcessor.truncatedBlocks = &parent->truncatedBlocks;
+      }
+    }
 
     Ref process() {
       switchProcessor.walk(func->body);
@@ -1620,10 +1780,8 @@ Ref Wasm2JSBuilder::processFunctionBody(Module* m,
                 L_NOT, visit(curr->value, EXPRESSION_RESULT));
             }
             case ReinterpretFloat32: {
-              ABI::wasm2js::ensureHelpers(module,
-                                          ABI::wasm2js::SCRATCH_STORE_F32);
-              ABI::wasm2js::ensureHelpers(module,
-                                          ABI::wasm2js::SCRATCH_LOAD_I32);
+              parent->ensureHelper(module, ABI::wasm2js::SCRATCH_STORE_F32);
+              parent->ensureHelper(module, ABI::wasm2js::SCRATCH_LOAD_I32);
 
               Ref store =
                 ValueBuilder::makeCall(ABI::wasm2js::SCRATCH_STORE_F32,
@@ -1719,10 +1877,8 @@ Ref Wasm2JSBuilder::processFunctionBody(Module* m,
               return makeJsCoercion(visit(curr->value, EXPRESSION_RESULT),
                                     JS_FLOAT);
             case ReinterpretInt32: {
-              ABI::wasm2js::ensureHelpers(module,
-                                          ABI::wasm2js::SCRATCH_STORE_I32);
-              ABI::wasm2js::ensureHelpers(module,
-                                          ABI::wasm2js::SCRATCH_LOAD_F32);
+              parent->ensureHelper(module, ABI::wasm2js::SCRATCH_STORE_I32);
+              parent->ensureHelper(module, ABI::wasm2js::SCRATCH_LOAD_F32);
 
               // 32-bit scratch memory uses index 2, so that it does not
               // conflict with indexes 0, 1 which are used for 64-bit, see
@@ -1994,7 +2150,7 @@ Ref Wasm2JSBuilder::processFunctionBody(Module* m,
       Ref val = visit(curr->value, EXPRESSION_RESULT);
       bool needCoercion =
         parent->options.optimizeLevel == 0 || standaloneFunction ||
-        parent->functionsCallableFromOutside.count(func->name);
+        parent->isCallableFromOutside(func->name);
       if (needCoercion) {
         val = makeJsCoercion(val, wasmToJsType(curr->value->type));
       }
@@ -2153,7 +2309,7 @@ Ref Wasm2JSBuilder::processFunctionBody(Module* m,
       WASM_UNREACHABLE("unimp");
     }
     Ref visitMemoryInit(MemoryInit* curr) {
-      ABI::wasm2js::ensureHelpers(module, ABI::wasm2js::MEMORY_INIT);
+      parent->ensureHelper(module, ABI::wasm2js::MEMORY_INIT);
       return ValueBuilder::makeCall(ABI::wasm2js::MEMORY_INIT,
                                     ValueBuilder::makeNum(curr->segment),
                                     visit(curr->dest, EXPRESSION_RESULT),
@@ -2161,19 +2317,19 @@ Ref Wasm2JSBuilder::processFunctionBody(Module* m,
                                     visit(curr->size, EXPRESSION_RESULT));
     }
     Ref visitDataDrop(DataDrop* curr) {
-      ABI::wasm2js::ensureHelpers(module, ABI::wasm2js::DATA_DROP);
+      parent->ensureHelper(module, ABI::wasm2js::DATA_DROP);
       return ValueBuilder::makeCall(ABI::wasm2js::DATA_DROP,
                                     ValueBuilder::makeNum(curr->segment));
     }
     Ref visitMemoryCopy(MemoryCopy* curr) {
-      ABI::wasm2js::ensureHelpers(module, ABI::wasm2js::MEMORY_COPY);
+      parent->ensureHelper(module, ABI::wasm2js::MEMORY_COPY);
       return ValueBuilder::makeCall(ABI::wasm2js::MEMORY_COPY,
                                     visit(curr->dest, EXPRESSION_RESULT),
                                     visit(curr->source, EXPRESSION_RESULT),
                                     visit(curr->size, EXPRESSION_RESULT));
     }
     Ref visitMemoryFill(MemoryFill* curr) {
-      ABI::wasm2js::ensureHelpers(module, ABI::wasm2js::MEMORY_FILL);
+      parent->ensureHelper(module, ABI::wasm2js::MEMORY_FILL);
       return ValueBuilder::makeCall(ABI::wasm2js::MEMORY_FILL,
                                     visit(curr->dest, EXPRESSION_RESULT),
                                     visit(curr->value, EXPRESSION_RESULT),
@@ -0,0 +1,51 @@
+(module
+  (import "import" "import" (func $import))
+
+  (memory 256 256)
+  (data (i32.const 10) "_________________")
+
+  (export "test1" $test1)
+
+  (global $sp (mut i32) (i32.const 100))
+
+  ;; A pure function, whose results we can reuse for the same arguments.
+  (func $square (param $x i32) (result i32)
+    (i32.mul
+      (local.get $x)
+      (local.get $x)
+    )
+  )
+
+  (func $store-square (param $addr i32) (param $x i32)
+    (i32.store8
+      (local.get $addr)
+      (call $square
+        (local.get $x)
+      )
+    )
+  )
+
+  (func $test1
+    ;; Safe stores, which should alter memory. The same pure call is made
+    ;; several times.
+    (call $store-square (i32.const 12) (i32.const 10))
+    (call $store-square (i32.const 13) (i32.const 10))
+    (call $store-square (i32.const 14) (i32.const 11))
+
+    ;; Stores to memory and to a global, including after the end of the data
+    ;; so far and in another page, followed by a call to an import, which
+    ;; prevents evalling. We will stop here, and none of the changes here may
+    ;; be applied.
+    (block
+      (i32.store8 (i32.const 15) (i32.const 115))
+      (i32.store8 (i32.const 9000) (i32.const 115))
+      (global.set $sp
+        (i32.const 200)
+      )
+      (call $import)
+    )
+
+    ;; A safe store that we never reach
+    (i32.store8 (i32.const 16) (i32.const 115))
+  )
+)
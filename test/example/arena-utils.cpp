@@ -0,0 +1,119 @@
+#include <cassert>
+#include <iostream>
+#include <sstream>
+
+#include "ir/arena-utils.h"
+#include "mixed_arena.h"
+#include "wasm-builder.h"
+#include "wasm-stack.h"
+#include "wasm.h"
+
+using namespace wasm;
+
+std::string print(Module& wasm) {
+  std::stringstream stream;
+  stream << wasm;
+  return stream.str();
+}
+
+void test_swap() {
+  std::cout << ";; Test swap\n";
+  MixedArena a, b;
+  a.alloc<Nop>();
+  assert(a.getTotalChunkBytes() == MixedArena::CHUNK_SIZE);
+  assert(b.getTotalChunkBytes() == 0);
+  a.swap(b);
+  assert(a.getTotalChunkBytes() == 0);
+  assert(b.getTotalChunkBytes() == MixedArena::CHUNK_SIZE);
+  b.clear();
+  assert(b.getTotalChunkBytes() == 0);
+}
+
+Function* addFunction(Module& wasm, Name name) {
+  Builder builder(wasm);
+  auto* body = builder.makeBlock(
+    {builder.makeLocalSet(0, builder.makeConst(int32_t(1))),
+     builder.makeBreak("out", nullptr, builder.makeLocalGet(0, Type::i32)),
+     builder.makeDrop(builder.makeBinary(AddInt32,
+                                         builder.makeLocalGet(0, Type::i32),
+                                         builder.makeConst(int32_t(2))))});
+  body->name = "out";
+  auto* func = wasm.addFunction(
+    builder.makeFunction(name, Signature(), {Type::i32}, body));
+  if (wasm.debugInfoFileNames.empty()) {
+    wasm.debugInfoFileNames.push_back("a.c");
+  }
+  func->debugLocations[body->list[0]] = {0, 1, 2};
+  return func;
+}
+
+void test_rehome() {
+  std::cout << ";; Test rehome\n";
+  Module wasm;
+  Builder builder(wasm);
+  auto* func = addFunction(wasm, "a");
+  addFunction(wasm, "b");
+  wasm.addGlobal(builder.makeGlobal(
+    "g", Type::i32, builder.makeConst(int32_t(3)), Builder::Immutable));
+
+  auto live = ArenaUtils::getLiveBytes(wasm);
+  assert(live > 0);
+  assert(live <= wasm.allocator.getTotalChunkBytes());
+
+  // Replacing code leaves the old nodes in the arena.
+  auto* body = func->body->cast<Block>();
+  body->list[2] = builder.makeNop();
+  assert(ArenaUtils::getLiveBytes(wasm) < live);
+  live = ArenaUtils::getLiveBytes(wasm);
+
+  // Fill a few chunks with nodes that are not used.
+  for (Index i = 0; i < 10000; i++) {
+    builder.makeNop();
+  }
+  auto before = print(wasm);
+  auto chunkBytes = wasm.allocator.getTotalChunkBytes();
+  auto* oldSet = body->list[0];
+
+  ArenaUtils::rehome(wasm);
+
+  // The module is the same, but everything moved to a smaller arena.
+  assert(print(wasm) == before);
+  assert(ArenaUtils::getLiveBytes(wasm) == live);
+  assert(wasm.allocator.getTotalChunkBytes() < chunkBytes);
+  assert(func->body != body);
+
+  // The debug location moved along with its expression.
+  auto* newSet = func->body->cast<Block>()->list[0];
+  assert(newSet != oldSet);
+  assert(func->debugLocations.size() == 1);
+  assert(func->debugLocations.count(newSet));
+  assert(func->debugLocations[newSet].lineNumber == 1);
+  std::cout << before;
+}
+
+void test_rehome_stack_ir() {
+  std::cout << ";; Test rehome with Stack IR\n";
+  Module wasm;
+  auto* func = addFunction(wasm, "a");
+  StackIRGenerator generator(wasm, func);
+  generator.write();
+  func->stackIR = std::make_unique<StackIR>();
+  func->stackIR->swap(generator.getStackIR());
+  auto size = func->stackIR->size();
+
+  ArenaUtils::rehome(wasm);
+
+  // The Stack IR is kept, and refers to the new expressions.
+  assert(func->stackIR);
+  assert(func->stackIR->size() == size);
+  auto* body = func->body->cast<Block>();
+  assert((*func->stackIR)[0]->origin == body);
+  assert((*func->stackIR).back()->origin == body);
+  assert((*func->stackIR)[1]->origin == body->list[0]->cast<LocalSet>()->value);
+}
+
+int main() {
+  test_swap();
+  test_rehome();
+  test_rehome_stack_ir();
+}
@@ -0,0 +1,80 @@
+// test that writing a binary to a stream gives the same result as writing it
+// to a buffer, with code sections of various sizes
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "wasm-binary.h"
+#include "wasm-builder.h"
+#include "wasm.h"
+
+using namespace wasm;
+
+// Makes a module with |numFuncs| functions whose bodies each have |numDrops|
+// drops of a v128 constant. All the functions share one body, which is fine to
+// write, and lets us make a large code section with little memory.
+std::unique_ptr<Module> makeModule(Index numFuncs, Index numDrops) {
+  auto wasm = std::make_unique<Module>();
+  wasm->features = FeatureSet::SIMD;
+  Builder builder(*wasm);
+  uint8_t bytes[16];
+  for (Index i = 0; i < 16; i++) {
+    bytes[i] = i;
+  }
+  auto* drop = builder.makeDrop(builder.makeConst(Literal(bytes)));
+  auto* body = builder.makeBlock();
+  body->list.resize(numDrops);
+  for (Index i = 0; i < numDrops; i++) {
+    body->list[i] = drop;
+  }
+  body->finalize();
+  for (Index i = 0; i < numFuncs; i++) {
+    wasm->addFunction(builder.makeFunction(
+      Name("f" + std::to_string(i)), Signature(), {}, body));
+  }
+  return wasm;
+}
+
+void test(Index numFuncs, Index numDrops) {
+  auto wasm = makeModule(numFuncs, numDrops);
+
+  BufferWithRandomAccess buffer;
+  WasmBinaryWriter writer(wasm.get(), buffer);
+  writer.write();
+
+  std::stringstream stream;
+  BufferWithRandomAccess unused;
+  WasmBinaryWriter streamingWriter(wasm.get(), unused);
+  streamingWriter.setOutputStream(&stream);
+  streamingWriter.write();
+
+  auto streamed = stream.str();
+  assert(unused.empty());
+  assert(streamed.size() == buffer.size());
+  assert(memcmp(streamed.data(), buffer.data(), buffer.size()) == 0);
+
+  auto& bodies = writer.tableOfContents.functionBodies;
+  auto& streamedBodies = streamingWriter.tableOfContents.functionBodies;
+  assert(bodies.size() == numFuncs);
+  assert(streamedBodies.size() == numFuncs);
+  for (Index i = 0; i < numFuncs; i++) {
+    assert(bodies[i].name == streamedBodies[i].name);
+    assert(bodies[i].offset == streamedBodies[i].offset);
+    assert(bodies[i].size == streamedBodies[i].size);
+    // The body ends with the end of the block and of the function.
+    assert(buffer[bodies[i].offset + bodies[i].size - 1] ==
+           int8_t(BinaryConsts::End));
+  }
+  std::cout << numFuncs << " functions, " << buffer.size() << " bytes\n";
+}
+
+int main() {
+  // A small module.
+  test(3, 10);
+  // More functions than fit in a batch.
+  test(10000, 1);
+  // More bytes than fit in a batch, and than are kept while streaming.
+  test(1000, 1200);
+}
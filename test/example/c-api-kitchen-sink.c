@@ -1686,6 +1686,88 @@ void test_func_opt() {
   BinaryenModuleDispose(module);
 }
 
+void test_pass_options() {
+  BinaryenPassOptionsRef options = BinaryenPassOptionsCreate();
+
+  // The defaults are those of the global options.
+  assert(BinaryenPassOptionsGetOptimizeLevel(options) ==
+         BinaryenGetOptimizeLevel());
+  assert(BinaryenPassOptionsGetShrinkLevel(options) ==
+         BinaryenGetShrinkLevel());
+  assert(BinaryenPassOptionsGetDebugInfo(options) == BinaryenGetDebugInfo());
+  assert(BinaryenPassOptionsGetLowMemoryUnused(options) ==
+         BinaryenGetLowMemoryUnused());
+  assert(BinaryenPassOptionsGetZeroFilledMemory(options) ==
+         BinaryenGetZeroFilledMemory());
+  assert(BinaryenPassOptionsGetFastMath(options) == BinaryenGetFastMath());
+  assert(BinaryenPassOptionsGetAlwaysInlineMaxSize(options) ==
+         BinaryenGetAlwaysInlineMaxSize());
+  assert(BinaryenPassOptionsGetFlexibleInlineMaxSize(options) ==
+         BinaryenGetFlexibleInlineMaxSize());
+  assert(BinaryenPassOptionsGetOneCallerInlineMaxSize(options) ==
+         BinaryenGetOneCallerInlineMaxSize());
+  assert(BinaryenPassOptionsGetAllowInliningFunctionsWithLoops(options) ==
+         BinaryenGetAllowInliningFunctionsWithLoops());
+
+  // Setting the options does not change the global ones.
+  BinaryenPassOptionsSetOptimizeLevel(options, 3);
+  BinaryenPassOptionsSetShrinkLevel(options, 1);
+  BinaryenPassOptionsSetDebugInfo(options, true);
+  BinaryenPassOptionsSetLowMemoryUnused(options, true);
+  BinaryenPassOptionsSetZeroFilledMemory(options, true);
+  BinaryenPassOptionsSetFastMath(options, true);
+  BinaryenPassOptionsSetAlwaysInlineMaxSize(options, 11);
+  BinaryenPassOptionsSetFlexibleInlineMaxSize(options, 22);
+  BinaryenPassOptionsSetOneCallerInlineMaxSize(options, 33);
+  BinaryenPassOptionsSetAllowInliningFunctionsWithLoops(options, true);
+  BinaryenPassOptionsSetPassArgument(options, "theKey", "theValue");
+  assert(BinaryenPassOptionsGetOptimizeLevel(options) == 3);
+  assert(BinaryenPassOptionsGetShrinkLevel(options) == 1);
+  assert(BinaryenPassOptionsGetDebugInfo(options));
+  assert(BinaryenPassOptionsGetLowMemoryUnused(options));
+  assert(BinaryenPassOptionsGetZeroFilledMemory(options));
+  assert(BinaryenPassOptionsGetFastMath(options));
+  assert(BinaryenPassOptionsGetAlwaysInlineMaxSize(options) == 11);
+  assert(BinaryenPassOptionsGetFlexibleInlineMaxSize(options) == 22);
+  assert(BinaryenPassOptionsGetOneCallerInlineMaxSize(options) == 33);
+  assert(BinaryenPassOptionsGetAllowInliningFunctionsWithLoops(options));
+  assert(strcmp(BinaryenPassOptionsGetPassArgument(options, "theKey"),
+                "theValue") == 0);
+  assert(BinaryenPassOptionsGetPassArgument(options, "other") == NULL);
+  assert(BinaryenGetPassArgument("theKey") == NULL);
+  assert(BinaryenGetOptimizeLevel() != 3);
+  BinaryenPassOptionsClearPassArguments(options);
+  assert(BinaryenPassOptionsGetPassArgument(options, "theKey") == NULL);
+
+  // Optimize using the options.
+  BinaryenModuleRef module = BinaryenModuleCreate();
+  BinaryenExpressionRef x = BinaryenConst(module, BinaryenLiteralInt32(1)),
+                        y = BinaryenConst(module, BinaryenLiteralInt32(3));
+  BinaryenExpressionRef add = BinaryenBinary(module, BinaryenAddInt32(), x, y);
+  BinaryenFunctionRef adder = BinaryenAddFunction(
+    module, "adder", BinaryenTypeNone(), BinaryenTypeInt32(), NULL, 0, add);
+  BinaryenExpressionRef drop =
+    BinaryenDrop(module, BinaryenConst(module, BinaryenLiteralInt32(5)));
+  BinaryenFunctionRef dropper = BinaryenAddFunction(
+    module, "dropper", BinaryenTypeNone(), BinaryenTypeNone(), NULL, 0, drop);
+  BinaryenAddFunctionExport(module, "adder", "adder");
+  BinaryenAddFunctionExport(module, "dropper", "dropper");
+  const char* passes[] = {"vacuum"};
+  BinaryenFunctionOptimizeWithOptions(adder, module, options);
+  BinaryenFunctionRunPassesWithOptions(dropper, module, passes, 1, options);
+  assert(BinaryenModuleValidate(module));
+  puts("module with functions optimized with options:");
+  BinaryenModulePrint(module);
+  BinaryenModuleRunPassesWithOptions(module, passes, 1, options);
+  BinaryenModuleOptimizeWithOptions(module, options);
+  assert(BinaryenModuleValidate(module));
+  puts("module optimized with options:");
+  BinaryenModulePrint(module);
+  BinaryenModuleDispose(module);
+
+  BinaryenPassOptionsDispose(options);
+}
+
 int main() {
   test_types();
   test_features();
@@ -1698,6 +1780,7 @@ int main() {
   test_color_status();
   test_for_each();
   test_func_opt();
+  test_pass_options();
 
   return 0;
 }
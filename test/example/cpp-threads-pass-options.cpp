@@ -0,0 +1,83 @@
+// test optimizing modules on multiple threads at once, each with its own pass
+// options
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <binaryen-c.h>
+
+int NUM_THREADS = 33;
+
+// Each thread writes the size of its optimized module here.
+std::vector<size_t> sizes(NUM_THREADS);
+
+int getOptimizeLevel(int index) { return index % 2 ? 2 : 0; }
+
+void worker(int index) {
+  BinaryenModuleRef module = BinaryenModuleCreate();
+
+  BinaryenPassOptionsRef options = BinaryenPassOptionsCreate();
+  BinaryenPassOptionsSetOptimizeLevel(options, getOptimizeLevel(index));
+  BinaryenPassOptionsSetShrinkLevel(options, 0);
+  BinaryenPassOptionsSetPassArgument(options, "thread", "yes");
+
+  // Create a function that adds one to its param, and an exported function
+  // that calls it. Only -O2 inlines the call.
+  BinaryenType i32 = BinaryenTypeInt32();
+  BinaryenExpressionRef inc =
+    BinaryenBinary(module,
+                   BinaryenAddInt32(),
+                   BinaryenLocalGet(module, 0, i32),
+                   BinaryenConst(module, BinaryenLiteralInt32(1)));
+  BinaryenAddFunction(module, "inc", i32, i32, NULL, 0, inc);
+  BinaryenExpressionRef operands[] = {BinaryenLocalGet(module, 0, i32)};
+  BinaryenExpressionRef call = BinaryenCall(module, "inc", operands, 1, i32);
+  BinaryenAddFunction(module, "caller", i32, i32, NULL, 0, call);
+  BinaryenAddFunctionExport(module, "caller", "caller");
+  assert(BinaryenModuleValidate(module));
+
+  BinaryenModuleOptimizeWithOptions(module, options);
+  assert(BinaryenModuleValidate(module));
+
+  // The options of other threads and the global options are not changed.
+  assert(BinaryenPassOptionsGetOptimizeLevel(options) ==
+         getOptimizeLevel(index));
+  assert(BinaryenGetPassArgument("thread") == NULL);
+  BinaryenPassOptionsDispose(options);
+
+  BinaryenModuleAllocateAndWriteResult result =
+    BinaryenModuleAllocateAndWrite(module, NULL);
+  sizes[index] = result.binaryBytes;
+  free(result.binary);
+
+  BinaryenModuleDispose(module);
+}
+
+int main() {
+  std::vector<std::thread> threads;
+
+  std::cout << "create threads...\n";
+  for (int i = 0; i < NUM_THREADS; i++) {
+    threads.emplace_back(worker, i);
+  }
+
+  std::cout << "waiting for threads to join...\n";
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Each thread got the result of its own optimize level.
+  for (int i = 2; i < NUM_THREADS; i++) {
+    assert(sizes[i] == sizes[i - 2]);
+  }
+  assert(sizes[0] > sizes[1]);
+  std::cout << "size with -O0: " << sizes[0] << '\n';
+  std::cout << "size with -O2: " << sizes[1] << '\n';
+
+  std::cout << "all done.\n";
+
+  return 0;
+}
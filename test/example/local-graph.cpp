@@ -1,4 +1,6 @@
+#include <cassert>
 #include <iostream>
+#include <set>
 
 #include <ir/local-graph.h>
 #include <wasm-builder.h>
@@ -6,7 +8,7 @@
 
 using namespace wasm;
 
-int main() {
+template<typename Graph> void testEquivalent() {
   Module wasm;
   Builder builder(wasm);
 
@@ -22,7 +24,7 @@ int main() {
       builder.makeDrop(get1),
       builder.makeDrop(get2),
     });
-    LocalGraph graph(&foo);
+    Graph graph(&foo);
     assert(graph.equivalent(get1, get2));
   }
 
@@ -38,7 +40,7 @@ int main() {
       builder.makeLocalSet(0, builder.makeConst(Literal(int32_t(0)))),
       builder.makeDrop(get2),
     });
-    LocalGraph graph(&foo);
+    Graph graph(&foo);
     assert(!graph.equivalent(get1, get2));
   }
 
@@ -52,7 +54,7 @@ int main() {
       builder.makeDrop(get1),
       builder.makeDrop(get2),
     });
-    LocalGraph graph(&foo);
+    Graph graph(&foo);
     assert(graph.equivalent(get1, get2));
   }
 
@@ -67,7 +69,7 @@ int main() {
       builder.makeLocalSet(0, builder.makeConst(Literal(int32_t(0)))),
       builder.makeDrop(get2),
     });
-    LocalGraph graph(&foo);
+    Graph graph(&foo);
     assert(!graph.equivalent(get1, get2));
   }
 
@@ -81,7 +83,7 @@ int main() {
       builder.makeDrop(get1),
       builder.makeDrop(get2),
     });
-    LocalGraph graph(&foo);
+    Graph graph(&foo);
     assert(!graph.equivalent(get1, get2));
   }
 
@@ -97,7 +99,7 @@ int main() {
       builder.makeDrop(get1),
       builder.makeDrop(get2),
     });
-    LocalGraph graph(&foo);
+    Graph graph(&foo);
     assert(graph.equivalent(get1, get2));
   }
 
@@ -112,10 +114,91 @@ int main() {
       builder.makeDrop(get1),
       builder.makeDrop(get2),
     });
-    LocalGraph graph(&foo);
+    Graph graph(&foo);
     assert(!graph.equivalent(get1, get2));
   }
 
+}
+
+template<typename Range> auto toSet(const Range& range) {
+  std::set<typename std::decay<decltype(*range.begin())>::type> ret;
+  for (auto item : range) {
+    ret.insert(item);
+  }
+  return ret;
+}
+
+// Checks that FlatLocalGraph finds the same sets and influences as LocalGraph.
+void testSameAsLocalGraph() {
+  Module wasm;
+  Builder builder(wasm);
+
+  Function foo;
+  foo.type = Signature({Type::i32}, Type::none);
+  foo.vars = {Type::i32};
+  auto* set1 = builder.makeLocalSet(1, builder.makeConst(Literal(int32_t(1))));
+  auto* set2 = builder.makeLocalSet(1, builder.makeConst(Literal(int32_t(2))));
+  auto* set3 = builder.makeLocalSet(0, builder.makeLocalGet(1, Type::i32));
+  std::vector<LocalGet*> gets;
+  auto makeGet = [&](Index index) {
+    gets.push_back(builder.makeLocalGet(index, Type::i32));
+    return gets.back();
+  };
+  // (local.set 1 (i32.const 1))
+  // (loop $l
+  //   (drop (local.get 0)) ;; the param, or set3
+  //   (drop (local.get 1)) ;; set1, set2 or set3's influence
+  //   (if (local.get 0)
+  //     (local.set 1 (i32.const 2))
+  //     (local.set 0 (local.get 1)))
+  //   (drop (local.get 1)) ;; set1 or set2
+  //   (br_if $l (local.get 1)))
+  // (drop (local.get 1)) ;; set1 or set2
+  foo.body = builder.makeBlock({
+    set1,
+    builder.makeLoop(
+      "l",
+      builder.makeBlock({
+        builder.makeDrop(makeGet(0)),
+        builder.makeDrop(makeGet(1)),
+        builder.makeIf(makeGet(0), set2, set3),
+        builder.makeDrop(makeGet(1)),
+        builder.makeBreak("l", nullptr, makeGet(1)),
+      })),
+    builder.makeDrop(makeGet(1)),
+  });
+  gets.push_back(set3->value->cast<LocalGet>());
+
+  LocalGraph graph(&foo);
+  graph.computeInfluences();
+  graph.computeSSAIndexes();
+  FlatLocalGraph flatGraph(&foo);
+  flatGraph.computeInfluences();
+  flatGraph.computeSSAIndexes();
+
+  for (auto* get : gets) {
+    assert(toSet(flatGraph.getSetses[get]) == toSet(graph.getSetses[get]));
+    assert(toSet(flatGraph.getInfluences[get]) ==
+           toSet(graph.getInfluences[get]));
+  }
+  for (auto* set : {set1, set2, set3}) {
+    assert(toSet(flatGraph.setInfluences[set]) ==
+           toSet(graph.setInfluences[set]));
+  }
+  for (Index i = 0; i < foo.getNumLocals(); i++) {
+    assert(flatGraph.isSSA(i) == graph.isSSA(i));
+  }
+  assert(flatGraph.locations.size() == graph.locations.size());
+  for (auto& [curr, location] : flatGraph.locations) {
+    assert(graph.locations[curr] == location);
+  }
+}
+
+int main() {
+  testEquivalent<LocalGraph>();
+  testEquivalent<FlatLocalGraph>();
+  testSameAsLocalGraph();
+
   std::cout << "Success." << std::endl;
 
   return 0;
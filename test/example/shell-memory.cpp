@@ -0,0 +1,55 @@
+// test growing and shrinking the memory of the shell interpreter
+
+#include <cassert>
+#include <iostream>
+
+#include "shell-interface.h"
+
+using namespace wasm;
+
+using ShellMemory = ShellExternalInterface::Memory;
+
+void test_grow() {
+  std::cout << ";; Test grow\n";
+  ShellMemory memory;
+  memory.resize(wasm::Memory::kPageSize);
+  memory.set<uint32_t>(0, 1);
+  memory.set<uint32_t>(wasm::Memory::kPageSize - 4, 2);
+  for (Index pages = 2; pages <= 100; pages++) {
+    memory.resize(pages * wasm::Memory::kPageSize);
+    // The new page is zero, and the old contents are kept.
+    assert(memory.get<uint64_t>((pages - 1) * wasm::Memory::kPageSize) == 0);
+    assert(memory.get<uint64_t>(pages * wasm::Memory::kPageSize - 8) == 0);
+    memory.set<uint8_t>(pages * wasm::Memory::kPageSize - 1, pages);
+  }
+  assert(memory.get<uint32_t>(0) == 1);
+  assert(memory.get<uint32_t>(wasm::Memory::kPageSize - 4) == 2);
+  for (Index pages = 2; pages <= 100; pages++) {
+    assert(memory.get<uint8_t>(pages * wasm::Memory::kPageSize - 1) == pages);
+  }
+}
+
+void test_shrink() {
+  std::cout << ";; Test shrink\n";
+  // Sizes that do not end at a page of the host, so part of the last page is
+  // dropped.
+  const size_t sizes[] = {3 * wasm::Memory::kPageSize + 1000, 6000, 100, 0};
+  for (auto size : sizes) {
+    ShellMemory memory;
+    memory.resize(4 * wasm::Memory::kPageSize);
+    for (size_t i = 0; i < 4 * wasm::Memory::kPageSize; i += 8) {
+      memory.set<uint64_t>(i, ~uint64_t(0));
+    }
+    memory.resize(size);
+    memory.resize(4 * wasm::Memory::kPageSize);
+    // What we kept is there, and what we dropped reads as zeros.
+    for (size_t i = 0; i < 4 * wasm::Memory::kPageSize; i++) {
+      assert(memory.get<uint8_t>(i) == (i < size ? 0xff : 0));
+    }
+  }
+}
+
+int main() {
+  test_grow();
+  test_shrink();
+}
@@ -0,0 +1,122 @@
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "support/small_bitset.h"
+
+using namespace wasm;
+
+template<typename T>
+void assertContents(T& t, const std::vector<Index>& expectedContents) {
+  assert(t.size() == expectedContents.size());
+  assert(t.empty() == expectedContents.empty());
+  for (auto item : expectedContents) {
+    assert(t.count(item) == 1);
+  }
+  // Iteration is in increasing order.
+  std::vector<Index> items;
+  for (auto item : t) {
+    items.push_back(item);
+  }
+  assert(items == expectedContents);
+}
+
+template<typename T> void testAPI() {
+  {
+    T t;
+
+    // build up with no duplicates, crossing word boundaries and going past the
+    // inline words
+    assertContents(t, {});
+    t.insert(1);
+    assertContents(t, {1});
+    t.insert(63);
+    assertContents(t, {1, 63});
+    t.insert(64);
+    assertContents(t, {1, 63, 64});
+    t.insert(1000);
+    assertContents(t, {1, 63, 64, 1000});
+    assert(t.count(0) == 0);
+    assert(t.count(999) == 0);
+    assert(t.count(100000) == 0);
+
+    // duplicates have no effect
+    t.insert(64);
+    assertContents(t, {1, 63, 64, 1000});
+
+    // unwind
+    t.erase(1000);
+    assertContents(t, {1, 63, 64});
+    t.erase(5000);
+    assertContents(t, {1, 63, 64});
+    t.erase(1);
+    assertContents(t, {63, 64});
+    t.erase(64);
+    t.erase(63);
+    assertContents(t, {});
+
+    t.insert(7);
+    t.insert(2000);
+    t.clear();
+    assertContents(t, {});
+  }
+  {
+    // intersections and merging
+    T a = {1, 100, 3000};
+    T b = {2, 200};
+    assert(!a.intersects(b));
+    assert(!b.intersects(a));
+    b.insert(3000);
+    assert(a.intersects(b));
+    assert(b.intersects(a));
+    b.erase(3000);
+    b.insert(1);
+    assert(a.intersects(b));
+    assert(b.intersects(a));
+    assert(!a.intersects(T()));
+
+    a |= b;
+    assertContents(a, {1, 2, 100, 200, 3000});
+    assertContents(b, {1, 2, 200});
+    b |= a;
+    assertContents(b, {1, 2, 100, 200, 3000});
+  }
+  {
+    // equality does not depend on how many words were allocated
+    T a = {1, 2};
+    T b = {1, 2, 5000};
+    assert(a != b);
+    b.erase(5000);
+    assert(a == b);
+    assert(b == a);
+    b.insert(3);
+    assert(a != b);
+  }
+  {
+    // large integers that are far apart
+    T a = {5, 4000000000u, 1u << 30, 100000};
+    assertContents(a, {5, 100000, 1u << 30, 4000000000u});
+    T b = {6, (1u << 30) + 1, 4000000001u};
+    assert(!a.intersects(b));
+    b.insert(100000);
+    assert(a.intersects(b));
+    assert(b.intersects(a));
+    a |= b;
+    assertContents(
+      a, {5, 6, 100000, 1u << 30, (1u << 30) + 1, 4000000000u, 4000000001u});
+    a.erase(100000);
+    a.erase(4000000000u);
+    a.erase(4000000001u);
+    assertContents(a, {5, 6, 1u << 30, (1u << 30) + 1});
+    assert(!a.intersects(T{100000, 4000000000u}));
+  }
+}
+
+int main() {
+  testAPI<SmallBitSet<0>>();
+  testAPI<SmallBitSet<1>>();
+  testAPI<SmallBitSet<2>>();
+  testAPI<SmallBitSet<10>>();
+
+  std::cout << "ok.\n";
+}
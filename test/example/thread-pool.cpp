@@ -0,0 +1,99 @@
+// test nested and concurrent work in the thread pool
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "support/threads.h"
+
+using namespace wasm;
+
+// Runs |total| items of work on the pool, calling |func| on each.
+template<typename T> void runItems(size_t total, T func) {
+  auto* pool = ThreadPool::get();
+  std::atomic<size_t> next;
+  next.store(0);
+  std::vector<std::function<ThreadWorkState()>> doWorkers;
+  for (size_t i = 0; i < pool->size(); i++) {
+    doWorkers.push_back([&]() {
+      auto index = next.fetch_add(1);
+      if (index >= total) {
+        return ThreadWorkState::Finished;
+      }
+      func(index);
+      return ThreadWorkState::More;
+    });
+  }
+  pool->work(doWorkers);
+}
+
+void test_nested() {
+  std::cout << ";; Test nested work\n";
+  const size_t outer = 16, inner = 100;
+  std::vector<std::atomic<size_t>> sums(outer);
+  for (auto& sum : sums) {
+    sum.store(0);
+  }
+  runItems(outer, [&](size_t i) {
+    // Each outer item runs work of its own, and waits for it.
+    runItems(inner, [&](size_t j) { sums[i].fetch_add(j); });
+    assert(sums[i].load() == inner * (inner - 1) / 2);
+  });
+  for (auto& sum : sums) {
+    assert(sum.load() == inner * (inner - 1) / 2);
+  }
+}
+
+void test_concurrent() {
+  std::cout << ";; Test concurrent work\n";
+  // Two threads outside the pool send work to it at the same time. While a
+  // thread waits for its own work, it must not run the other's.
+  const size_t num = 2, items = 200;
+  std::thread::id callers[num];
+  std::mutex mutex;
+  std::set<std::thread::id> ranOn[num];
+  std::atomic<size_t> counts[num];
+  for (auto& count : counts) {
+    count.store(0);
+  }
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num; i++) {
+    threads.emplace_back([&, i]() {
+      callers[i] = std::this_thread::get_id();
+      runItems(items, [&](size_t) {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          ranOn[i].insert(std::this_thread::get_id());
+        }
+        counts[i].fetch_add(1);
+        std::this_thread::yield();
+      });
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (size_t i = 0; i < num; i++) {
+    assert(counts[i].load() == items);
+    for (size_t j = 0; j < num; j++) {
+      if (j != i) {
+        assert(ranOn[i].count(callers[j]) == 0);
+      }
+    }
+  }
+}
+
+int main() {
+  // Use several threads even on machines with one core.
+  setenv("BINARYEN_CORES", "4", 1);
+  assert(ThreadPool::get()->size() == 4);
+
+  test_nested();
+  test_concurrent();
+  std::cout << "success.\n";
+}
@@ -1,3 +1,5 @@
+#include <thread>
+
 #include "type-test.h"
 #include "wasm-type-printing.h"
 #include "wasm-type.h"
@@ -498,3 +500,35 @@ TEST_F(EquirecursiveTest, CanonicalizeBasicTypes) {
 TEST_F(IsorecursiveTest, CanonicalizeBasicTypes) {
   testCanonicalizeBasicTypes();
 }
+
+TEST_F(TypeTest, ConcurrentCanonicalization) {
+  // Threads that create the same types at the same time must all get the same
+  // canonical types.
+  const size_t numThreads = 4;
+  const size_t numTypes = 200;
+  std::vector<std::vector<Type>> results(numThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < numThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (size_t i = 0; i < numTypes; i++) {
+        Type tuple = Tuple(std::vector<Type>(i % 8 + 2, Type::i32));
+        Type sig = Type(Signature(tuple, Type(i % 2 ? Type::i64 : Type::f32)),
+                        Nullable);
+        results[t].push_back(tuple);
+        results[t].push_back(sig);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 1; t < numThreads; t++) {
+    EXPECT_EQ(results[t], results[0]);
+  }
+  // The types for i = 0 and i = 16 are the same, and different from those for
+  // i = 1.
+  EXPECT_EQ(results[0][0], results[0][32]);
+  EXPECT_EQ(results[0][1], results[0][33]);
+  EXPECT_NE(results[0][0], results[0][2]);
+  EXPECT_NE(results[0][1], results[0][3]);
+}
@@ -0,0 +1,22 @@
+;; Function bodies are parsed after the rest of the module, in parallel when
+;; there are threads, but the error that is reported is the first one in the
+;; module, whether it is in a body or not.
+
+;; RUN: not env BINARYEN_CORES=1 wasm-opt %s 2>&1 | filecheck %s
+;; RUN: not env BINARYEN_CORES=4 wasm-opt %s 2>&1 | filecheck %s
+
+;; CHECK: [parse exception: abc (at 16:4)]
+
+(module
+  (func $ok
+    (nop)
+  )
+  (func $first
+    (nop)
+    (abc)
+  )
+  (func $second
+    (def)
+  )
+  (global $g i32 (ghi))
+)
@@ -0,0 +1,54 @@
+;; Function bodies are parsed after the rest of the module, in parallel when
+;; there are threads. Bodies whose results depend on the functions before them
+;; are parsed again in order, so the result is the same with any number of
+;; threads.
+
+;; RUN: env BINARYEN_CORES=1 wasm-opt %s -g -S -o - | filecheck %s
+;; RUN: env BINARYEN_CORES=4 wasm-opt %s -g -S -o - | filecheck %s
+
+(module
+ ;; Repeated label names are made unique using a counter that all the
+ ;; functions share.
+ ;; CHECK:      (func $a
+ ;; CHECK-NEXT:  ;;@ a.c:1:2
+ ;; CHECK-NEXT:  (block $l
+ ;; CHECK-NEXT:   (block $l0
+ ;; CHECK-NEXT:    (br $l0)
+ ;; CHECK-NEXT:   )
+ ;; CHECK-NEXT:  )
+ ;; CHECK-NEXT: )
+ (func $a
+  ;;@ a.c:1:2
+  (block $l (block $l (br $l)))
+ )
+
+ ;; A file that no function before this one mentioned gets the next index.
+ ;; CHECK:      (func $b
+ ;; CHECK-NEXT:  ;;@ b.c:3:4
+ ;; CHECK-NEXT:  (nop)
+ ;; CHECK-NEXT:  ;;@ a.c:5:6
+ ;; CHECK-NEXT:  (block $l
+ ;; CHECK-NEXT:   (block $l1
+ ;; CHECK-NEXT:    (block $l2
+ ;; CHECK-NEXT:     (br $l2)
+ ;; CHECK-NEXT:    )
+ ;; CHECK-NEXT:   )
+ ;; CHECK-NEXT:  )
+ ;; CHECK-NEXT: )
+ (func $b
+  ;;@ b.c:3:4
+  (nop)
+  ;;@ a.c:5:6
+  (block $l (block $l (block $l (br $l))))
+ )
+
+ ;; Bodies can refer to globals that are defined after them.
+ ;; CHECK:      (func $c (result i32)
+ ;; CHECK-NEXT:  (global.get $g)
+ ;; CHECK-NEXT: )
+ (func $c (result i32)
+  (global.get $g)
+ )
+
+ (global $g i32 (i32.const 0))
+)
@@ -0,0 +1,44 @@
+;; NOTE: Assertions have been generated by update_lit_checks.py --all-items and should not be edited.
+
+;; Remove some code, then move the rest to a fresh arena. The module, including
+;; its debug info, should not change.
+
+;; RUN: wasm-opt %s --vacuum --compact-arena -S -o - | filecheck %s
+
+(module
+  ;; CHECK:      (type $i32_=>_i32 (func (param i32) (result i32)))
+
+  ;; CHECK:      (global $g i32 (i32.const 1))
+  (global $g i32 (i32.const 1))
+  ;; CHECK:      (memory $0 1)
+  (memory 1)
+  ;; CHECK:      (data (global.get $g) "abc")
+  (data (global.get $g) "abc")
+  ;; CHECK:      (table $0 1 funcref)
+  (table 1 funcref)
+  ;; CHECK:      (elem (i32.const 0) $func)
+  (elem (i32.const 0) $func)
+  ;; CHECK:      (func $func (param $x i32) (result i32)
+  ;; CHECK-NEXT:  ;;@ src.c:20:2
+  ;; CHECK-NEXT:  (local.tee $x
+  ;; CHECK-NEXT:   (i32.add
+  ;; CHECK-NEXT:    (local.get $x)
+  ;; CHECK-NEXT:    (global.get $g)
+  ;; CHECK-NEXT:   )
+  ;; CHECK-NEXT:  )
+  ;; CHECK-NEXT: )
+  (func $func (param $x i32) (result i32)
+    ;;@ src.c:10:1
+    (drop
+      (i32.const 0)
+    )
+    (nop)
+    ;;@ src.c:20:2
+    (local.tee $x
+      (i32.add
+        (local.get $x)
+        (global.get $g)
+      )
+    )
+  )
+)
@@ -0,0 +1,71 @@
+;; Check that --pass-cache stores the results of function-parallel passes and
+;; reuses them, giving the same output as optimizing from scratch.
+
+;; RUN: rm -rf %t.cache && mkdir %t.cache
+;; RUN: wasm-opt %s -O2 --pass-cache=%t.cache -S -o %t.first.wat 2>&1 \
+;; RUN:   | filecheck %s --check-prefix=FIRST
+;; RUN: wasm-opt %s -O2 --pass-cache=%t.cache -S -o %t.second.wat 2>&1 \
+;; RUN:   | filecheck %s --check-prefix=SECOND
+;; RUN: diff %t.first.wat %t.second.wat
+
+;; Colors are not printed into the cache.
+;; RUN: env COLORS=1 wasm-opt %s -O2 --pass-cache=%t.cache -o %t.wasm 2>&1 \
+;; RUN:   | filecheck %s --check-prefix=SECOND
+
+;; Other options are a different key.
+;; RUN: wasm-opt %s -O2 --fast-math --pass-cache=%t.cache -o %t.wasm 2>&1 \
+;; RUN:   | filecheck %s --check-prefix=FIRST
+
+;; FIRST: [PassCache] 0 hits, 3 misses, 3 stored, 0 not stored as the passes changed the module, 0 not cacheable
+
+;; SECOND: [PassCache] 3 hits, 0 misses, 0 stored, 0 not stored as the passes changed the module, 0 not cacheable
+
+(module
+  (global $g (mut i32) (i32.const 0))
+
+  (func $add (export "add") (param $x i32) (result i32)
+    (block $out
+      (br_if $out
+        (local.get $x)
+      )
+      (global.set $g
+        (i32.add
+          (local.get $x)
+          (i32.const 1)
+        )
+      )
+    )
+    (call $helper
+      (i32.add
+        (i32.const 1)
+        (i32.const 2)
+      )
+    )
+  )
+
+  (func $helper (param i32) (result i32)
+    (local $unused i32)
+    (loop $l
+      (if
+        (global.get $g)
+        (block
+          (global.set $g
+            (i32.sub
+              (global.get $g)
+              (i32.const 1)
+            )
+          )
+          (br $l)
+        )
+      )
+    )
+    (local.get 0)
+  )
+
+  (func $loop (export "loop") (param $x f64) (result f64)
+    (f64.add
+      (local.get $x)
+      (f64.const 0)
+    )
+  )
+)
@@ -0,0 +1,32 @@
+;; Check the trace that --pass-profile writes. Function-parallel passes that run
+;; one after the other are a single event, and each function they ran on gets
+;; an event of its own.
+
+;; RUN: wasm-opt %s --vacuum --precompute --remove-unused-module-elements \
+;; RUN:   --pass-profile=%t.json -o %t.wasm
+;; RUN: cat %t.json | filecheck %s
+
+;; CHECK:      {"traceEvents":[
+;; CHECK-NEXT: {"name":"thread_name","ph":"M","pid":0,"tid":0,"args":{"name":"main"}}
+;; CHECK-DAG:  {"name":"foo","cat":"function","ph":"X","ts":
+;; CHECK-DAG:  {"name":"bar","cat":"function","ph":"X","ts":
+;; CHECK:      {"name":"vacuum, precompute","cat":"function-parallel","ph":"X","ts":{{.*}},"args":{"cpu_ms":{{.*}},"arena_bytes":{{[0-9]+}},"size_before":{{[0-9]+}},"size_after":{{[0-9]+}},"pass_ms":{"vacuum":{{.*}},"precompute":
+;; CHECK-NEXT: {"name":"remove-unused-module-elements","cat":"pass","ph":"X","ts":{{.*}},"args":{"cpu_ms":{{.*}},"arena_bytes":{{[0-9]+}},"size_before":{{[0-9]+}},"size_after":{{[0-9]+}}}}
+;; CHECK-NEXT: ],"displayTimeUnit":"ms"}
+
+(module
+  (func $foo (export "foo") (result i32)
+    (i32.add
+      (i32.const 1)
+      (i32.const 2)
+    )
+  )
+
+  (func $bar (export "bar")
+    (nop)
+  )
+
+  (func $unused
+    (nop)
+  )
+)
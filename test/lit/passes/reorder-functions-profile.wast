@@ -0,0 +1,88 @@
+;; Instrument the module with and without counters and generate profiles
+;; RUN: wasm-split --instrument --counters %s -o %t.counters.wasm -g
+;; RUN: node %S/../wasm-split/call_exports.mjs %t.counters.wasm %t.counters.prof first work
+;; RUN: wasm-split --instrument %s -o %t.timestamps.wasm -g
+;; RUN: node %S/../wasm-split/call_exports.mjs %t.timestamps.wasm %t.timestamps.prof first work
+
+;; RUN: wasm-opt %s --reorder-functions-profile=%t.counters.prof -S -o - \
+;; RUN:   | filecheck %s --check-prefix COUNTERS
+;; RUN: wasm-opt %s --reorder-functions-profile=%t.timestamps.prof -S -o - \
+;; RUN:   | filecheck %s --check-prefix TIMESTAMPS
+
+;; A profile must be for the module file that we run on, which wasm-opt passes
+;; on as its input file, and which can be given explicitly. Without a module
+;; file, as in other tools, only the numbers of functions and counters are
+;; checked.
+;; RUN: wasm-opt %s --reorder-functions-profile=%t.counters.prof -S -o - \
+;; RUN:   --pass-arg=reorder-functions-profile-module@%s \
+;; RUN:   | filecheck %s --check-prefix COUNTERS
+;; RUN: not wasm-opt %s --reorder-functions-profile=%t.counters.prof \
+;; RUN:   --pass-arg=reorder-functions-profile-module@%t.counters.wasm 2>&1 \
+;; RUN:   | filecheck %s --check-prefix MISMATCH
+;; RUN: wasm-opt %s --reorder-functions-profile=%t.counters.prof -S -o - \
+;; RUN:   --pass-arg=reorder-functions-profile-module@ \
+;; RUN:   | filecheck %s --check-prefix COUNTERS
+
+;; MISMATCH: Fatal: Profile {{.*}}.counters.prof is not for module {{.*}}.counters.wasm, as their hashes do not match
+
+;; With counters, $loopy and $leaf, which it calls many times, go first. Then
+;; $first and $setup, which it calls once, and then the functions that were not
+;; called, in their original order.
+
+;; COUNTERS:      (func $loopy{{$}}
+;; COUNTERS:      (func $leaf{{$}}
+;; COUNTERS:      (func $first{{$}}
+;; COUNTERS:      (func $setup{{$}}
+;; COUNTERS:      (func $cold{{$}}
+;; COUNTERS:      (func $never{{$}}
+
+;; Without counters, the functions that were called go in the order they were
+;; first called in.
+
+;; TIMESTAMPS:      (func $first{{$}}
+;; TIMESTAMPS:      (func $setup{{$}}
+;; TIMESTAMPS:      (func $loopy{{$}}
+;; TIMESTAMPS:      (func $leaf{{$}}
+;; TIMESTAMPS:      (func $cold{{$}}
+;; TIMESTAMPS:      (func $never{{$}}
+
+(module
+  (memory 0 0)
+  (export "memory" (memory 0))
+  (export "first" (func $first))
+  (export "work" (func $loopy))
+  (export "never" (func $never))
+  (func $cold
+    (nop)
+  )
+  (func $first
+    (call $setup)
+  )
+  (func $setup
+    (nop)
+  )
+  (func $loopy
+    (local $i i32)
+    (loop $l
+      (call $leaf)
+      (local.set $i
+        (i32.add
+          (local.get $i)
+          (i32.const 1)
+        )
+      )
+      (br_if $l
+        (i32.lt_u
+          (local.get $i)
+          (i32.const 10)
+        )
+      )
+    )
+  )
+  (func $leaf
+    (nop)
+  )
+  (func $never
+    (call $cold)
+  )
+)
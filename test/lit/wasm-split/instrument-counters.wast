@@ -0,0 +1,131 @@
+;; RUN: wasm-split %s --instrument --counters -all -S -o - | filecheck %s
+;; RUN: wasm-split %s --instrument --counters --in-memory -all -S -o - \
+;; RUN:   | filecheck %s --check-prefix MEMORY
+
+;; Check that the output round trips and validates as well
+;; RUN: wasm-split %s --instrument --counters --in-memory -all -g -o %t.wasm
+;; RUN: wasm-opt -all %t.wasm -S -o -
+
+(module
+  (import "env" "foo" (func $foo))
+  (export "bar" (func $bar))
+  (func $bar
+    (call $foo)
+  )
+  (func $baz (param i32) (result i32)
+    (loop $l
+      (br_if $l
+        (local.tee 0
+          (i32.sub
+            (local.get 0)
+            (i32.const 1)
+          )
+        )
+      )
+    )
+    (local.get 0)
+  )
+)
+
+;; Check that there is a counter global for each function and loop
+
+;; CHECK:      (global $bar_calls (mut i32) (i32.const 0))
+;; CHECK-NEXT: (global $baz_calls (mut i32) (i32.const 0))
+;; CHECK-NEXT: (global $baz_loop0_iterations (mut i32) (i32.const 0))
+
+;; Check that functions increment their counter first, and loops at the start
+;; of each iteration
+
+;; CHECK:      (func $bar{{$}}
+;; CHECK-NEXT:  (global.set $bar_calls
+;; CHECK-NEXT:   (i32.add
+;; CHECK-NEXT:    (global.get $bar_calls)
+;; CHECK-NEXT:    (i32.const 1)
+;; CHECK-NEXT:   )
+;; CHECK-NEXT:  )
+
+;; CHECK:      (func $baz (param $0 i32) (result i32)
+;; CHECK-NEXT:  (global.set $baz_calls
+
+;; CHECK:       (loop $l
+;; CHECK-NEXT:   (global.set $baz_loop0_iterations
+;; CHECK-NEXT:    (i32.add
+;; CHECK-NEXT:     (global.get $baz_loop0_iterations)
+;; CHECK-NEXT:     (i32.const 1)
+;; CHECK-NEXT:    )
+;; CHECK-NEXT:   )
+;; CHECK-NEXT:   (br_if $l
+
+;; Check that the profile ends with the magic number, the number of counters
+;; and the counters
+
+;; CHECK:      (func $__write_profile (param $addr i32) (param $size i32) (result i32)
+;; CHECK-NEXT:  (if
+;; CHECK-NEXT:   (i32.ge_u
+;; CHECK-NEXT:    (local.get $size)
+;; CHECK-NEXT:    (i32.const 36)
+;; CHECK-NEXT:   )
+
+;; CHECK:       (i32.store offset=16 align=1
+;; CHECK-NEXT:   (local.get $addr)
+;; CHECK-NEXT:   (i32.const 1937010275)
+;; CHECK-NEXT:  )
+;; CHECK-NEXT:  (i32.store offset=20 align=1
+;; CHECK-NEXT:   (local.get $addr)
+;; CHECK-NEXT:   (i32.const 3)
+;; CHECK-NEXT:  )
+;; CHECK-NEXT:  (i32.store offset=24 align=1
+;; CHECK-NEXT:   (local.get $addr)
+;; CHECK-NEXT:   (global.get $bar_calls)
+;; CHECK-NEXT:  )
+;; CHECK-NEXT:  (i32.store offset=28 align=1
+;; CHECK-NEXT:   (local.get $addr)
+;; CHECK-NEXT:   (global.get $baz_calls)
+;; CHECK-NEXT:  )
+;; CHECK-NEXT:  (i32.store offset=32 align=1
+;; CHECK-NEXT:   (local.get $addr)
+;; CHECK-NEXT:   (global.get $baz_loop0_iterations)
+;; CHECK-NEXT:  )
+
+;; In memory, the counters come after the byte for each function, aligned to
+;; four bytes
+
+;; MEMORY:      (func $bar{{$}}
+;; MEMORY-NEXT:  (drop
+;; MEMORY-NEXT:   (i32.atomic.rmw.add offset=4
+;; MEMORY-NEXT:    (i32.const 0)
+;; MEMORY-NEXT:    (i32.const 1)
+;; MEMORY-NEXT:   )
+;; MEMORY-NEXT:  )
+
+;; MEMORY:      (func $baz (param $0 i32) (result i32)
+;; MEMORY-NEXT:  (drop
+;; MEMORY-NEXT:   (i32.atomic.rmw.add offset=8
+
+;; MEMORY:       (loop $l
+;; MEMORY-NEXT:   (drop
+;; MEMORY-NEXT:    (i32.atomic.rmw.add offset=12
+
+;; MEMORY:      (block $counters_outer
+;; MEMORY-NEXT:  (loop $counters_l
+;; MEMORY-NEXT:   (br_if $counters_outer
+;; MEMORY-NEXT:    (i32.eq
+;; MEMORY-NEXT:     (local.get $counterIdx)
+;; MEMORY-NEXT:     (i32.const 3)
+;; MEMORY-NEXT:    )
+;; MEMORY-NEXT:   )
+;; MEMORY-NEXT:   (i32.store offset=24
+;; MEMORY-NEXT:    (i32.add
+;; MEMORY-NEXT:     (local.get $addr)
+;; MEMORY-NEXT:     (i32.mul
+;; MEMORY-NEXT:      (local.get $counterIdx)
+;; MEMORY-NEXT:      (i32.const 4)
+;; MEMORY-NEXT:     )
+;; MEMORY-NEXT:    )
+;; MEMORY-NEXT:    (i32.atomic.load offset=4
+;; MEMORY-NEXT:     (i32.mul
+;; MEMORY-NEXT:      (local.get $counterIdx)
+;; MEMORY-NEXT:      (i32.const 4)
+;; MEMORY-NEXT:     )
+;; MEMORY-NEXT:    )
+;; MEMORY-NEXT:   )
@@ -0,0 +1,49 @@
+;; Instrument the module with counters
+;; RUN: wasm-split --instrument --counters %s -o %t.instrumented.wasm -g
+
+;; Generate profiles
+;; RUN: node %S/call_exports.mjs %t.instrumented.wasm %t.foo.prof foo
+;; RUN: node %S/call_exports.mjs %t.instrumented.wasm %t.foo.bar.prof foo bar bar
+
+;; Merge profiles, which adds up the counters
+;; RUN: wasm-split --merge-profiles %t.foo.prof %t.foo.bar.prof -o %t.merged.prof
+
+;; Split the module
+;; RUN: wasm-split %s --profile %t.merged.prof -o1 %t.1.wasm -o2 %t.2.wasm -g -v \
+;; RUN:   | filecheck %s --check-prefix SPLIT
+
+;; SPLIT: Function foo: 2 calls{{$}}
+;; SPLIT-NEXT: Function bar: 2 calls, loop 0: 6 iterations{{$}}
+;; SPLIT-NEXT: Function qux: 0 calls{{$}}
+;; SPLIT-NEXT: Keeping functions: bar, foo{{$}}
+;; SPLIT-NEXT: Splitting out functions: qux{{$}}
+
+(module
+  (export "memory" (memory 0 0))
+  (export "foo" (func $foo))
+  (export "bar" (func $bar))
+  (export "qux" (func $qux))
+  (func $foo
+    (nop)
+  )
+  (func $bar
+    (local $i i32)
+    (loop $l
+      (local.set $i
+        (i32.add
+          (local.get $i)
+          (i32.const 1)
+        )
+      )
+      (br_if $l
+        (i32.lt_u
+          (local.get $i)
+          (i32.const 3)
+        )
+      )
+    )
+  )
+  (func $qux
+    (nop)
+  )
+)